@@ -0,0 +1,141 @@
+#pragma once
+
+/*
+ * ICU4C package addons - precompiled number and date formats
+ *
+ * NumberFormat::createInstance() and DateFormat::createDateTimeInstance()
+ * load locale data and build a formatter on every call, and their format()
+ * grows a UnicodeString that the caller then converts to UTF-8. A reporting
+ * service formatting millions of values spends most of its time there.
+ *
+ * FormatterCache compiles a format once per (locale, skeleton) and keeps it:
+ *
+ *   - number skeletons ("currency/EUR", "percent .0", "compact-short", ...)
+ *     become a UNumberFormatter, the C form of a LocalizedNumberFormatter,
+ *     formatting into one UFormattedNumber that is reused for every value;
+ *   - date skeletons ("yMMMd", "jms", ...) become a pattern through the
+ *     locale's DateTimePatternGenerator and a UDateFormat for it, which
+ *     formats into a fixed UTF-16 buffer.
+ *
+ * format() writes UTF-8 into the caller's buffer and formatBatch() packs the
+ * results of an array of values into one arena (FormattedStrings), so a warm
+ * format allocates nothing:
+ *
+ *   icuaddons::FormatterCache formats;
+ *   icuaddons::CompiledNumberFormat* euros = formats.number(icu::Locale::getFrance(), u"currency/EUR", status);
+ *   char text[64];
+ *   int32_t length = euros->format(1234.5, text, sizeof(text), status);   // "1 234,50 €"
+ *
+ * The cache and its formats are not thread-safe (the number formatters are,
+ * but their reused results are not); use one cache per thread.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <unicode/locid.h>
+#include <unicode/unistr.h>
+#include <unicode/utypes.h>
+
+#if !UCONFIG_NO_FORMATTING
+
+#include <unicode/udat.h>
+#include <unicode/udatpg.h>
+#include <unicode/unumberformatter.h>
+
+namespace icuaddons {
+
+// UTF-8 strings packed back to back.
+struct FormattedStrings {
+    std::vector<char>     bytes;
+    std::vector<uint32_t> offsets;  // String i is bytes[offsets[i] .. offsets[i + 1])
+
+    size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+    std::string_view string(size_t i) const { return {bytes.data() + offsets[i], offsets[i + 1] - offsets[i]}; }
+};
+
+// The format() functions return the UTF-8 length of the result. Like ICU's
+// extract functions, they fail with U_BUFFER_OVERFLOW_ERROR and return the
+// needed length when it exceeds `capacity`, and NUL-terminate if there is room.
+
+// A number skeleton for one locale.
+class CompiledNumberFormat {
+public:
+    int32_t format(double value, char* buffer, int32_t capacity, UErrorCode& status);
+    int32_t format(int64_t value, char* buffer, int32_t capacity, UErrorCode& status);
+
+    // Replaces the contents of `out` with the formatted values.
+    void formatBatch(const double* values, size_t count, FormattedStrings& out, UErrorCode& status);
+    void formatBatch(const int64_t* values, size_t count, FormattedStrings& out, UErrorCode& status);
+
+private:
+    friend class FormatterCache;
+    CompiledNumberFormat(const icu::Locale& locale, const icu::UnicodeString& skeleton, UErrorCode& status);
+
+    // The result of the last unumf_format*() call as UTF-8.
+    int32_t extract(char* buffer, int32_t capacity, UErrorCode& status);
+    void append(FormattedStrings& out, UErrorCode& status);
+
+    icu::LocalUNumberFormatterPointer formatter_;
+    icu::LocalUFormattedNumberPointer result_;
+};
+
+// A date skeleton for one locale and time zone.
+class CompiledDateFormat {
+public:
+    int32_t format(UDate date, char* buffer, int32_t capacity, UErrorCode& status);
+
+    // Replaces the contents of `out` with the formatted dates.
+    void formatBatch(const UDate* dates, size_t count, FormattedStrings& out, UErrorCode& status);
+
+    // The pattern the skeleton resolved to, e.g. "d MMM y" for "yMMMd" in French.
+    const icu::UnicodeString& pattern() const { return pattern_; }
+
+private:
+    friend class FormatterCache;
+    CompiledDateFormat(const icu::Locale& locale, UDateTimePatternGenerator* generator,
+                       const icu::UnicodeString& skeleton, const icu::UnicodeString& timeZone, UErrorCode& status);
+
+    // Format into utf16_, or into longer_ if it does not fit.
+    const char16_t* formatUTF16(UDate date, int32_t& length, UErrorCode& status);
+
+    icu::UnicodeString           pattern_;
+    icu::LocalUDateFormatPointer formatter_;
+    char16_t                     utf16_[128];
+    icu::UnicodeString           longer_;
+};
+
+class FormatterCache {
+public:
+    FormatterCache();
+    ~FormatterCache();
+
+    FormatterCache(const FormatterCache&) = delete;
+    FormatterCache& operator=(const FormatterCache&) = delete;
+
+    // The format for `skeleton` in `locale`, compiled on the first request.
+    // The pointers stay valid as long as the cache.
+    CompiledNumberFormat* number(const icu::Locale& locale, const icu::UnicodeString& skeleton, UErrorCode& status);
+
+    // An empty `timeZone` is the default time zone.
+    CompiledDateFormat* date(const icu::Locale& locale, const icu::UnicodeString& skeleton, UErrorCode& status,
+                             const icu::UnicodeString& timeZone = icu::UnicodeString());
+
+    // Compiled formats.
+    size_t size() const { return numbers_.size() + dates_.size(); }
+
+private:
+    std::unordered_map<std::string, std::unique_ptr<CompiledNumberFormat>> numbers_;
+    std::unordered_map<std::string, std::unique_ptr<CompiledDateFormat>>   dates_;
+    std::unordered_map<std::string, icu::LocalUDateTimePatternGeneratorPointer> generators_;  // By locale
+};
+
+} // namespace icuaddons
+
+#endif  // !UCONFIG_NO_FORMATTING
@@ -0,0 +1,114 @@
+#pragma once
+
+/*
+ * ICU4C package addons - lazy data loading
+ *
+ * The archive packages keep all ICU data in one icudt*.dat (about 30 MB).
+ * Native programs map it and only touch the pages they use, but WASM
+ * programs have no mmap: the whole file is fetched and copied into linear
+ * memory before the first ICU call.
+ *
+ * The split data packages (build.sh --variant=data-split) ship the same data
+ * as ICU's "files" layout, one file per item plus an index:
+ *
+ *   split/index.txt                   "<item> <bytes>" per line
+ *   split/icudt77l/coll/de.res        item "coll/de.res"
+ *   split/icudt77l/brkitr/word.brk
+ *   ...
+ *
+ * LazyData fetches items through a DataLoader callback (fetch(), a KV store,
+ * the local directoryLoader() stand-in) and writes them into a directory that
+ * ICU reads with u_setDataDirectory(); in WASM that is the in-memory file
+ * system. require() loads what one feature needs for one locale: its bundles
+ * along the locale fallback chain (likely subtags, aliases and explicit
+ * parents, root) and the feature's shared items such as the collation root
+ * (coll/ucadata.icu) or the break rules.
+ *
+ *   icuaddons::LazyData data(icuaddons::directoryLoader("/srv/icu/split"), "/tmp/icu");
+ *   data.install(status);                                   // before any other ICU call
+ *   data.require(icuaddons::DataFeature::Collation, "de", status);
+ *   icu::Collator::createInstance(icu::Locale::getGerman(), status);
+ *
+ * ICU remembers bundles it could not find, so require() a feature and locale
+ * before its first use. Converters are loaded with requireConverter(); any
+ * other item (e.g. a break dictionary for text in a script the locale does not
+ * use) with requireItem().
+ */
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <unicode/utypes.h>
+
+namespace icuaddons {
+
+// Reads `name` relative to the split data root ("index.txt", "icudt77l/coll/de.res")
+// into `bytes`. Returns false if it does not exist. Called with the LazyData lock
+// held, so one name at a time.
+using DataLoader = std::function<bool(const std::string& name, std::vector<uint8_t>& bytes)>;
+
+// Serves the names from files under `directory` (an extracted split/ folder).
+DataLoader directoryLoader(const std::string& directory);
+
+enum class DataFeature {
+    Locale,          // Main and curr/ locale bundles: dates, numbers, plurals, ...
+    Collation,       // coll/: Collator
+    BreakIteration,  // brkitr/: BreakIterator, with the dictionary for the locale's script
+    Languages,       // lang/: language display names
+    Regions,         // region/: region display names
+    Units,           // unit/: measure units
+    TimeZones,       // zone/: time zone names
+    Spellout,        // rbnf/: RuleBasedNumberFormat
+    Transliteration, // translit/: transliterator display names
+    Normalization,   // NFKC, NFKC_Casefold and UTS #46 (NFC and NFD are built into libicuuc)
+};
+
+class LazyData {
+public:
+    // Items are written below `directory`, which is created if missing.
+    LazyData(DataLoader loader, std::string directory);
+
+    LazyData(const LazyData&) = delete;
+    LazyData& operator=(const LazyData&) = delete;
+
+    // Read the index, load the items every locale lookup needs and point ICU
+    // at the directory. Call once, before any other ICU call.
+    void install(UErrorCode& status);
+
+    // Load what `feature` needs for `locale` (e.g. "de_CH", "zh-TW"; ignored
+    // for Normalization).
+    void require(DataFeature feature, const char* locale, UErrorCode& status);
+
+    // Load the alias table and the mapping table of a converter ("Shift-JIS").
+    // Algorithmic converters (UTF-*, ISO-8859-1, US-ASCII) need no table.
+    void requireConverter(const char* name, UErrorCode& status);
+
+    // Load one item of the index ("brkitr/thaidict.dict"). Returns false if
+    // the index has no such item.
+    bool requireItem(const std::string& item, UErrorCode& status);
+
+    size_t   itemsAvailable() const;  // Items in the index
+    uint64_t bytesAvailable() const;  // Their total size (about the size of the .dat)
+    size_t   itemsLoaded() const;
+    uint64_t bytesLoaded() const;
+
+private:
+    bool loadItem(const std::string& item, UErrorCode& status);
+    void loadBundles(const std::string& tree, const char* locale, UErrorCode& status);
+    void loadSharedItems(const std::string& tree, UErrorCode& status);
+
+    DataLoader                                loader_;
+    std::string                               directory_;
+    std::unordered_map<std::string, uint64_t> index_;   // Item -> size
+    uint64_t                                  indexBytes_ = 0;
+    std::unordered_set<std::string>           loaded_;
+    uint64_t                                  loadedBytes_ = 0;
+    mutable std::recursive_mutex              mutex_;
+};
+
+} // namespace icuaddons
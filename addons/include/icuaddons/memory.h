@@ -0,0 +1,74 @@
+#pragma once
+
+/*
+ * ICU4C package addons - allocation hooks
+ *
+ * ICU allocates everything (service objects created with `new`, strings,
+ * caches) through the functions installed with u_setMemoryFunctions().
+ * installAllocator() installs one of:
+ *
+ *   Allocator::System  malloc/realloc/free. Only worth installing together
+ *                      with countAllocations.
+ *   Allocator::Pool    Blocks up to 2 KiB come from per-thread free lists,
+ *                      refilled from 64 KiB chunks and a shared depot, so
+ *                      create/destroy cycles of collators, break iterators
+ *                      and transliterators do not contend on the process
+ *                      heap. Chunk memory is reused but never returned to
+ *                      the system; larger blocks go to malloc.
+ *
+ * With countAllocations, every thread counts its allocations and requested
+ * bytes; AllocationScope reads them around a single ICU call.
+ *
+ * Install before the first ICU call, including u_setDataDirectory(): ICU
+ * does not check whether it already holds memory from the previous
+ * functions. u_cleanup() restores the ICU defaults.
+ */
+
+#include <cstdint>
+
+#include <unicode/utypes.h>
+
+namespace icuaddons {
+
+enum class Allocator {
+    System,
+    Pool,
+};
+
+struct AllocatorOptions {
+    Allocator allocator        = Allocator::Pool;
+    bool      countAllocations = false;
+};
+
+struct AllocationCounters {
+    uint64_t allocations   = 0;  // Calls to the allocation function (and realloc of a null pointer)
+    uint64_t reallocations = 0;
+    uint64_t frees         = 0;
+    uint64_t bytes         = 0;  // Bytes requested by allocations and reallocations
+};
+
+AllocationCounters operator-(const AllocationCounters& after, const AllocationCounters& before);
+
+// Install the allocation functions through u_setMemoryFunctions().
+void installAllocator(const AllocatorOptions& options, UErrorCode& status);
+
+// What the calling thread allocated through ICU since its first allocation.
+// All zero unless the allocator was installed with countAllocations.
+AllocationCounters threadAllocationCounters();
+
+// Counts the ICU allocations of the calling thread while it is alive.
+class AllocationScope {
+public:
+    AllocationScope() : start_(threadAllocationCounters()) {}
+
+    AllocationCounters counters() const { return threadAllocationCounters() - start_; }
+
+private:
+    AllocationCounters start_;
+};
+
+// "system" or "pool", e.g. for command line options.
+bool parseAllocator(const char* name, Allocator& allocator);
+const char* allocatorName(Allocator allocator);
+
+} // namespace icuaddons
@@ -0,0 +1,78 @@
+#pragma once
+
+/*
+ * ICU4C package addons - batched normalization
+ *
+ * Normalizing text on ingest (NFC or NFKC) usually finds it already
+ * normalized, yet Normalizer2::normalize() still converts every record to
+ * UTF-16, copies it into a new UnicodeString and back to UTF-8.
+ *
+ * normalizeBatchUTF8() takes many UTF-8 records as one contiguous buffer
+ * plus offsets, like buildSortKeysUTF8() (icuaddons/sortkeys.h). Per record
+ * it
+ *
+ *   - skips the ASCII prefix eight bytes at a time (normalization cannot
+ *     change it up to the character before the first non-ASCII one),
+ *   - runs Normalizer2::isNormalizedUTF8() on the rest and, if that is
+ *     normalized, returns a view of the input without copying anything,
+ *   - otherwise copies the prefix and runs Normalizer2::normalizeUTF8() only
+ *     on the rest, appending to an arena.
+ *
+ * NFKC_Casefold changes ASCII (it lowercases), so there the whole record
+ * goes through the quick check.
+ *
+ * The arena belongs to the caller's NormalizedRecords and keeps its capacity
+ * between batches, so a steady stream of batches does not allocate:
+ *
+ *   icuaddons::NormalizedRecords normalized;
+ *   for (const Batch& batch : batches) {
+ *       icuaddons::normalizeBatchUTF8(*nfc, batch.text, batch.offsets, batch.count, normalized, status);
+ *       for (size_t i = 0; i < normalized.size(); ++i) {
+ *           store(normalized.record(i));
+ *       }
+ *   }
+ *
+ * The composing forms (NFC, NFKC, NFKC_Casefold) check UTF-8 directly; ICU
+ * implements isNormalizedUTF8() of NFD and NFKD by converting to UTF-16.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <unicode/normalizer2.h>
+#include <unicode/utypes.h>
+
+namespace icuaddons {
+
+struct NormalizedRecord {
+    uint32_t offset = 0;      // Into the input text, or into the arena if copied
+    uint32_t length = 0;
+    bool     copied = false;  // Whether normalization changed the record
+};
+
+// The normalized records of the last batch.
+struct NormalizedRecords {
+    const char*                   text = nullptr;  // The input the unchanged records point into
+    std::vector<char>             arena;           // The changed records, back to back
+    std::vector<NormalizedRecord> records;
+    size_t                        zeroCopy = 0;    // Records that were already normalized
+
+    size_t size() const { return records.size(); }
+
+    // Valid until the input or the next batch replaces it.
+    std::string_view record(size_t i) const {
+        const NormalizedRecord& entry = records[i];
+        return {(entry.copied ? arena.data() : text) + entry.offset, entry.length};
+    }
+};
+
+// Normalize `count` UTF-8 records. Record i is text[offsets[i] ..
+// offsets[i + 1]), so `offsets` has count + 1 entries. Replaces the records
+// of `normalized` and reuses its arena. Fails with U_INDEX_OUTOFBOUNDS_ERROR
+// when the changed records need more than 4 GiB.
+void normalizeBatchUTF8(const icu::Normalizer2& normalizer, const char* text, const uint32_t* offsets, size_t count,
+                        NormalizedRecords& normalized, UErrorCode& status);
+
+} // namespace icuaddons
@@ -0,0 +1,130 @@
+#pragma once
+
+/*
+ * ICU4C package addons - compiled search patterns
+ *
+ * RegexPattern::compile() and usearch_openFromCollator() parse the pattern
+ * and, for collation search, build its collation element tables. Code that
+ * does this per input line, or converts every line to a UnicodeString first,
+ * pays for it on every line.
+ *
+ * SearchPatterns compiles regular expressions and collation-aware literal
+ * patterns (StringSearch with a locale and strength) once and is shared
+ * between threads. A Searcher holds one reusable matcher per pattern for one
+ * thread:
+ *
+ *   - the input is converted to UTF-16 once per scan, into a buffer the
+ *     Searcher keeps, for all patterns: StringSearch only takes UTF-16, and
+ *     RegexMatcher runs its UTF-16 fast path on it (two to three times
+ *     faster than through a UTF-8 UText);
+ *   - the matchers are reset to each new input instead of being recreated,
+ *     and match offsets are mapped back to UTF-8 byte offsets of the input
+ *     (exact also after ill-formed bytes, which match as U+FFFD).
+ *
+ * With regexOverUTF8, regular expressions run over the UTF-8 input itself
+ * through utext_openUTF8() and RegexMatcher::reset(UText*), without the
+ * conversion: slower per byte, but nothing is copied, for very large inputs
+ * that only regular expressions search.
+ *
+ *   icuaddons::SearchPatterns patterns;
+ *   patterns.addRegex(u"\\b(?:error|fatal)\\b", UREGEX_CASE_INSENSITIVE, status);
+ *   patterns.addCollated(u"etre", icu::Locale::getFrance(), UCOL_PRIMARY, status);   // finds "être", "Être"
+ *   icuaddons::Searcher searcher(patterns, status);
+ *   searcher.scan(line.data(), line.size(), [&](size_t pattern, size_t begin, size_t end) { ... }, status);
+ *
+ * countMatches() scans the shards (records, log lines, documents) of one
+ * buffer with every pattern on several threads, each with its own Searcher
+ * and taking the next unscanned shard when it is done with one. Matches do
+ * not cross shard boundaries.
+ *
+ * Packages built with UCONFIG_NO_REGULAR_EXPRESSIONS fail addRegex() with
+ * U_UNSUPPORTED_ERROR.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <unicode/coll.h>
+#include <unicode/locid.h>
+#include <unicode/unistr.h>
+#include <unicode/utypes.h>
+
+namespace icuaddons {
+
+enum class PatternKind {
+    Regex,
+    Collated,
+};
+
+class SearchPatterns {
+public:
+    SearchPatterns();
+    ~SearchPatterns();
+
+    SearchPatterns(const SearchPatterns&) = delete;
+    SearchPatterns& operator=(const SearchPatterns&) = delete;
+
+    // Compile a regular expression (URegexpFlag bits in `flags`). Returns its index.
+    size_t addRegex(const icu::UnicodeString& regex, uint32_t flags, UErrorCode& status);
+
+    // A literal matched with the collation of `locale` at `strength`
+    // (UCOL_PRIMARY ignores accents and case, UCOL_SECONDARY case). Returns its index.
+    size_t addCollated(const icu::UnicodeString& text, const icu::Locale& locale, UColAttributeValue strength,
+                       UErrorCode& status);
+
+    size_t size() const { return patterns_.size(); }
+    PatternKind kind(size_t pattern) const;
+
+private:
+    friend class Searcher;
+
+    struct Pattern;
+    std::vector<std::unique_ptr<Pattern>> patterns_;
+};
+
+// Called for each match with the pattern index and the UTF-8 byte range.
+using MatchCallback = std::function<void(size_t pattern, size_t begin, size_t end)>;
+
+// The matchers of one thread; `patterns` must outlive it and not change.
+class Searcher {
+public:
+    Searcher(const SearchPatterns& patterns, UErrorCode& status, bool regexOverUTF8 = false);
+    ~Searcher();
+
+    Searcher(const Searcher&) = delete;
+    Searcher& operator=(const Searcher&) = delete;
+
+    // Every match of every pattern in `text`, pattern by pattern.
+    void scan(const char* text, size_t length, const MatchCallback& onMatch, UErrorCode& status);
+
+    // Matches of one pattern in `text`.
+    uint64_t count(size_t pattern, const char* text, size_t length, UErrorCode& status);
+
+    // Add the matches of every pattern in `text` to counts[pattern].
+    void countAll(const char* text, size_t length, uint64_t* counts, UErrorCode& status);
+
+private:
+    struct Matcher;
+
+    // UTF-8 `text` into utf16_.
+    void convert(const char* text, size_t length, UErrorCode& status);
+
+    // Run `pattern` over `text`, converting it first unless `converted`.
+    void run(size_t pattern, const char* text, size_t length, bool& converted, const MatchCallback* onMatch,
+             uint64_t& matches, UErrorCode& status);
+
+    const SearchPatterns&                 patterns_;
+    std::vector<std::unique_ptr<Matcher>> matchers_;
+    icu::UnicodeString                    utf16_;
+    bool                                  regexOverUTF8_;
+};
+
+// Matches of each pattern in the shards text[offsets[i] .. offsets[i + 1]),
+// i < shards, counted on `threads` threads.
+std::vector<uint64_t> countMatches(const SearchPatterns& patterns, const char* text, const uint32_t* offsets,
+                                   size_t shards, UErrorCode& status, size_t threads = 1);
+
+} // namespace icuaddons
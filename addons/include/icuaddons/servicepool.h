@@ -0,0 +1,170 @@
+#pragma once
+
+/*
+ * ICU4C package addons - service object pool
+ *
+ * Creating a collator, break iterator, transliterator or converter looks up
+ * and parses data every time; a transliterator or a legacy converter takes
+ * milliseconds. A request handler that creates, uses and destroys one per
+ * request spends most of its time there.
+ *
+ * ServicePool keeps one prototype per key (locale, ID or charset name, plus
+ * options) that is never handed out, and lends clones of it. A returned
+ * clone goes to a free list of the returning thread (up to maxIdlePerThread
+ * per key) and then to a shared depot (up to maxIdleShared per key), so a
+ * warm pool serves most requests without a lock or an ICU call:
+ *
+ *   icuaddons::ServicePool pool;
+ *   UErrorCode status = U_ZERO_ERROR;
+ *   auto words = pool.breakIterator(icuaddons::BreakType::Word, icu::Locale::getUS(), status);
+ *   if (U_SUCCESS(status)) {
+ *       words->setText(text);
+ *       ...
+ *   }   // back to the pool
+ *
+ * A lease must be returned in the state it was handed out: settings changed
+ * on it (setAttribute(), adoptFilter(), ucnv_setSubstChars()) stay with the
+ * object. Break iterators get an empty text and converters are reset when
+ * they come back. Leases must not outlive their pool; objects that other
+ * threads still cache for a destroyed pool are deleted when those threads
+ * exit. Destroy pools before u_cleanup().
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <unicode/brkiter.h>
+#include <unicode/coll.h>
+#include <unicode/locid.h>
+#include <unicode/ucnv.h>
+#include <unicode/unistr.h>
+#include <unicode/utypes.h>
+#if !UCONFIG_NO_TRANSLITERATION
+#include <unicode/translit.h>
+#endif
+
+namespace icuaddons {
+
+enum class BreakType {
+    Character,
+    Word,
+    Line,
+    Sentence,
+};
+
+struct ServicePoolOptions {
+    size_t maxIdlePerThread = 4;   // Idle objects per key on each thread's free list
+    size_t maxIdleShared    = 64;  // Idle objects per key in the shared depot
+};
+
+struct ServicePoolCounters {
+    uint64_t hits          = 0;  // Leases served from a free list or the depot
+    uint64_t misses        = 0;  // Leases that had to clone the prototype
+    uint64_t creations     = 0;  // Prototypes created through ICU
+    uint64_t creationNs    = 0;  // Time spent creating prototypes
+    uint64_t maxCreationNs = 0;  // Slowest prototype creation
+    uint64_t cloneNs       = 0;  // Time spent cloning on misses
+};
+
+class ServicePool;
+
+namespace detail {
+struct PoolShared;
+struct PoolSlot;
+} // namespace detail
+
+// An object lent by a ServicePool; returns it when destroyed.
+template <typename T>
+class Lease {
+public:
+    Lease() = default;
+    ~Lease() { reset(); }
+
+    Lease(Lease&& other) noexcept
+        : pool_(std::exchange(other.pool_, nullptr)),
+          slot_(std::exchange(other.slot_, nullptr)),
+          object_(std::exchange(other.object_, nullptr)) {}
+    Lease& operator=(Lease&& other) noexcept {
+        if (this != &other) {
+            reset();
+            pool_   = std::exchange(other.pool_, nullptr);
+            slot_   = std::exchange(other.slot_, nullptr);
+            object_ = std::exchange(other.object_, nullptr);
+        }
+        return *this;
+    }
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+
+    T* get() const { return object_; }
+    T* operator->() const { return object_; }
+    T& operator*() const { return *object_; }
+    explicit operator bool() const { return object_ != nullptr; }
+
+    // Return the object to the pool now.
+    void reset();
+
+private:
+    friend class ServicePool;
+    Lease(ServicePool* pool, detail::PoolSlot* slot, T* object) : pool_(pool), slot_(slot), object_(object) {}
+
+    ServicePool*      pool_   = nullptr;
+    detail::PoolSlot* slot_   = nullptr;
+    T*                object_ = nullptr;
+};
+
+class ServicePool {
+public:
+    explicit ServicePool(const ServicePoolOptions& options = ServicePoolOptions());
+    ~ServicePool();
+
+    ServicePool(const ServicePool&) = delete;
+    ServicePool& operator=(const ServicePool&) = delete;
+
+    // A collator for `locale`; `strength` other than UCOL_DEFAULT is set on the prototype.
+    Lease<icu::Collator> collator(const icu::Locale& locale, UErrorCode& status,
+                                  UColAttributeValue strength = UCOL_DEFAULT);
+
+    Lease<icu::BreakIterator> breakIterator(BreakType type, const icu::Locale& locale, UErrorCode& status);
+
+#if !UCONFIG_NO_TRANSLITERATION
+    Lease<icu::Transliterator> transliterator(const icu::UnicodeString& id, UTransDirection direction,
+                                              UErrorCode& status);
+#endif
+
+    // A converter for the charset `name` (any alias ucnv_open() accepts).
+    Lease<UConverter> converter(const char* name, UErrorCode& status);
+
+    ServicePoolCounters counters() const;
+
+    // Delete the idle objects of the calling thread and of the depot.
+    void trim();
+
+private:
+    template <typename T>
+    friend class Lease;
+
+    // A clone of the prototype stored under `key`, creating the prototype
+    // with create(argument, status) first if there is none.
+    void* acquire(const std::string& key, int kind, void* (*create)(const void*, UErrorCode&), const void* argument,
+                  detail::PoolSlot*& slot, UErrorCode& status);
+    void release(detail::PoolSlot* slot, void* object);
+
+    std::shared_ptr<detail::PoolShared> shared_;
+    uint64_t                            id_;
+};
+
+template <typename T>
+void Lease<T>::reset() {
+    if (object_ != nullptr) {
+        pool_->release(slot_, object_);
+    }
+    pool_   = nullptr;
+    slot_   = nullptr;
+    object_ = nullptr;
+}
+
+} // namespace icuaddons
@@ -0,0 +1,67 @@
+#pragma once
+
+/*
+ * ICU4C package addons - bulk sort keys
+ *
+ * Sorting many strings with Collator::compare() runs the collation algorithm
+ * twice per comparison, O(n log n) times. Computing every sort key once with
+ * Collator::getSortKey() and sorting the keys bytewise is much cheaper for
+ * large inputs, but one CollationKey (or std::vector) per string spends most
+ * of that gain on the allocator.
+ *
+ * buildSortKeys() takes the strings as one contiguous buffer plus offsets and
+ * packs all sort keys into a single arena (PackedSortKeys). sortedOrder()
+ * sorts indices into that arena with an MSD radix sort over the key bytes.
+ * Both split the work over `threads` threads; Collator::getSortKey() is
+ * const and safe to call on a shared collator.
+ *
+ *   std::string text;             // "apple" "Äpfel" "zebra" back to back
+ *   std::vector<uint32_t> offsets = {0, 5, 11, 16};
+ *   icuaddons::PackedSortKeys keys;
+ *   icuaddons::buildSortKeysUTF8(*collator, text.data(), offsets.data(), 3, keys, status);
+ *   std::vector<uint32_t> order;
+ *   icuaddons::sortedOrder(keys, order);   // {0, 1, 2}
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <unicode/coll.h>
+#include <unicode/utypes.h>
+
+namespace icuaddons {
+
+// The sort keys of a batch of strings, packed back to back.
+struct PackedSortKeys {
+    std::vector<uint8_t>  bytes;    // Every key including its terminating zero byte
+    std::vector<uint32_t> offsets;  // Key i is bytes[offsets[i] .. offsets[i + 1])
+
+    size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+    const uint8_t* key(size_t i) const { return bytes.data() + offsets[i]; }
+    uint32_t keyLength(size_t i) const { return offsets[i + 1] - offsets[i]; }
+
+    // Same sign as Collator::compare() of the two strings.
+    int compare(size_t a, size_t b) const {
+        // Keys end with their only zero byte, so the shorter length is enough
+        uint32_t length = keyLength(a) < keyLength(b) ? keyLength(a) : keyLength(b);
+        return std::memcmp(key(a), key(b), length);
+    }
+};
+
+// Compute the sort keys of `count` strings. String i is text[offsets[i] ..
+// offsets[i + 1]), so `offsets` has count + 1 entries. Replaces the contents
+// of `keys`. Fails with U_INDEX_OUTOFBOUNDS_ERROR when the keys need more
+// than 4 GiB.
+void buildSortKeysUTF8(const icu::Collator& collator, const char* text, const uint32_t* offsets, size_t count,
+                       PackedSortKeys& keys, UErrorCode& status, size_t threads = 1);
+void buildSortKeys(const icu::Collator& collator, const char16_t* text, const uint32_t* offsets, size_t count,
+                   PackedSortKeys& keys, UErrorCode& status, size_t threads = 1);
+
+// Indices of the keys in ascending collation order. Equal keys keep their
+// input order.
+void sortedOrder(const PackedSortKeys& keys, std::vector<uint32_t>& order, size_t threads = 1);
+
+} // namespace icuaddons
@@ -0,0 +1,66 @@
+#pragma once
+
+/*
+ * ICU4C package addons - trace hooks
+ *
+ * ICU configured with --enable-tracing (the profiling package variant) calls
+ * the functions installed with utrace_setFunctions() when it enters and
+ * leaves its traced functions: u_init, ucnv_open/openPackage/clone/close and
+ * converter table loads, ucol_open/strcoll/getSortKey, break iterator and
+ * dictionary engine creation, and, at UTRACE_VERBOSE, every data file, .res
+ * file and resource bundle it opens. Other packages compile the trace points
+ * out; there installTracing() succeeds and tracingAvailable() is false.
+ *
+ * installTracing() times every entry/exit pair on its thread and
+ *
+ *   - adds it to per-function statistics (traceStatistics()),
+ *   - passes it to an optional hook, e.g. to feed a metrics library,
+ *   - fires the USDT probes icu:entry, icu:exit(function, ns) and
+ *     icu:data(function, text) where <sys/sdt.h> is available, for perf
+ *     probe, bpftrace or SystemTap.
+ *
+ * ICU has no trace points in transliterators or the conversion loops
+ * themselves; their time shows up in the caller's frames (the profiling
+ * package keeps frame pointers for that).
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include <unicode/utrace.h>
+#include <unicode/utypes.h>
+
+namespace icuaddons {
+
+// Called on the tracing thread when a traced ICU function returns.
+using TraceHook = void (*)(void* context, int32_t function, uint64_t ns);
+
+struct TraceOptions {
+    int32_t   level       = UTRACE_OPEN_CLOSE;  // UTRACE_VERBOSE adds the data file and resource events
+    TraceHook hook        = nullptr;
+    void*     hookContext = nullptr;
+};
+
+struct TraceStatistics {
+    int32_t     function = 0;        // UTraceFunctionNumber
+    const char* name     = nullptr;  // utrace_functionName()
+    uint64_t    calls    = 0;
+    uint64_t    totalNs  = 0;
+    uint64_t    maxNs    = 0;
+};
+
+// Install the trace functions and set the trace level (at least UTRACE_OPEN_CLOSE).
+// Calls u_init() to find out whether ICU was built with tracing.
+void installTracing(const TraceOptions& options, UErrorCode& status);
+
+// Stop tracing (utrace_setLevel(UTRACE_OFF)); the statistics remain.
+void uninstallTracing();
+
+// Whether the trace points of this ICU build fire (known after installTracing()).
+bool tracingAvailable();
+
+// The functions traced at least once since installTracing() or the last reset, by function number.
+std::vector<TraceStatistics> traceStatistics();
+void resetTraceStatistics();
+
+} // namespace icuaddons
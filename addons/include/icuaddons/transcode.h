@@ -0,0 +1,120 @@
+#pragma once
+
+/*
+ * ICU4C package addons - bulk charset transcoding
+ *
+ * Transcoding feeds of Shift-JIS, GB18030, EUC-KR or windows-125x records to
+ * UTF-8 the obvious way (ucnv_open() both charsets, convert, ucnv_close() per
+ * record, or a UnicodeString per record) spends more time opening converters
+ * and copying than converting, and runs every byte through the converter even
+ * though most feeds are largely ASCII: field names, numbers, markup.
+ *
+ * Transcoder converts directly between two charsets with ucnv_convertEx() and
+ * a UTF-16 pivot buffer it reuses. Its converters are leased from a
+ * ServicePool (icuaddons/servicepool.h) when one is given, from the free
+ * list of the calling thread once the pool is warm, so a Transcoder per
+ * request creates no converter.
+ *
+ * When both charsets keep no shift state and the pair converts ASCII bytes to
+ * themselves (Shift-JIS, GB18030, EUC-KR, windows-125x, ISO-8859-x and UTF-8
+ * do; EBCDIC, ISO-2022 and UTF-16 do not), runs of at least kMinAsciiRun such
+ * bytes are copied to the output without the converters, found eight bytes at
+ * a time. A few bytes that do change are left to the converters: ICU's
+ * Shift-JIS (IBM-943) swaps the controls 0x1A, 0x1C and 0x7F. Each thread
+ * checks the 128 ASCII bytes once per pair of charsets. Runs are only
+ * copied between characters: a lead byte the converter holds from the
+ * previous piece takes its trail bytes first, even if they are ASCII
+ * (Shift-JIS and GBK trail bytes may be).
+ *
+ *   icuaddons::ServicePool pool;
+ *   icuaddons::Transcoder sjis("Shift-JIS", "UTF-8", status, &pool);
+ *   std::string utf8;
+ *   for (const Record& record : feed) {
+ *       utf8.clear();
+ *       sjis.transcode(record.data(), record.size(), utf8, status);
+ *   }
+ *
+ * transcodeChunk() converts a stream in pieces of any size; a character split
+ * between pieces is carried over. Unmappable and ill-formed input is replaced
+ * with the target's substitution character, as ucnv_convert() does. A
+ * Transcoder is not thread-safe; use one per thread.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <unicode/ucnv.h>
+#include <unicode/utypes.h>
+
+#include "icuaddons/servicepool.h"
+
+namespace icuaddons {
+
+struct TranscodeCounters {
+    uint64_t asciiBytes     = 0;  // Input copied as ASCII runs
+    uint64_t convertedBytes = 0;  // Input that went through the converters
+};
+
+class Transcoder {
+public:
+    // Converters are leased from `pool` if given (it must outlive the
+    // Transcoder), otherwise opened with ucnv_open().
+    Transcoder(const char* fromCharset, const char* toCharset, UErrorCode& status, ServicePool* pool = nullptr);
+    ~Transcoder();
+
+    Transcoder(const Transcoder&) = delete;
+    Transcoder& operator=(const Transcoder&) = delete;
+
+    // Append the conversion of one complete record to `out`.
+    void transcode(const char* input, size_t length, std::string& out, UErrorCode& status) {
+        transcodeChunk(input, length, true, out, status);
+    }
+
+    // Append the conversion of the next piece of a stream to `out`; `flush`
+    // on the last piece.
+    void transcodeChunk(const char* input, size_t length, bool flush, std::string& out, UErrorCode& status);
+
+    // Start a new stream (drops carried-over input).
+    void reset();
+
+    // Whether ASCII runs bypass the converters for this pair of charsets.
+    bool asciiTransparent() const { return ascii_.transparent; }
+
+    const TranscodeCounters& counters() const { return counters_; }
+
+    static constexpr size_t kMinAsciiRun    = 32;
+    static constexpr size_t kMaxAsciiExcept = 4;
+    static constexpr size_t kPivotUnits     = 4096;
+
+    // What the pair does to ASCII bytes, worked out once per pair and thread.
+    struct AsciiBytes {
+        bool          transparent = false;
+        bool          copies[0x80] = {};              // The bytes the pair keeps
+        unsigned char except[kMaxAsciiExcept] = {};  // and the ones it changes
+        size_t        exceptCount = 0;
+    };
+
+private:
+    void        findAsciiBytes(AsciiBytes& ascii);
+    bool        copies(unsigned char byte) const { return byte < 0x80 && ascii_.copies[byte]; }
+    bool        stops(uint64_t word) const;
+    size_t      asciiPrefix(const char* bytes, size_t length) const;
+    const char* nextAsciiRun(const char* begin, const char* limit) const;
+    bool        atBoundary() const;
+    void        convert(const char* begin, const char* end, bool flush, std::string& out, UErrorCode& status);
+
+    Lease<UConverter> fromLease_;
+    Lease<UConverter> toLease_;
+    UConverter*       from_        = nullptr;
+    UConverter*       to_          = nullptr;
+    bool              owned_       = false;  // Opened here rather than leased
+    AsciiBytes        ascii_;
+    size_t            maxCharSize_ = 1;      // Of the target charset
+    UChar             pivot_[kPivotUnits];
+    UChar*            pivotSource_ = pivot_;
+    UChar*            pivotTarget_ = pivot_;
+    TranscodeCounters counters_;
+};
+
+} // namespace icuaddons
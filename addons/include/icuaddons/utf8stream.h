@@ -0,0 +1,134 @@
+#pragma once
+
+/*
+ * ICU4C package addons - zero-copy UTF-8 streaming
+ *
+ * Going through icu::UnicodeString converts every UTF-8 document to UTF-16
+ * and copies it before ICU looks at it. For large UTF-8 files this layer
+ * keeps the bytes where they are:
+ *
+ *   MappedFile      maps the file read-only; release() drops the pages of a
+ *                   range that has been processed, so a scan over a file much
+ *                   larger than memory keeps a small resident set.
+ *   UTF8Segments    runs a BreakIterator over UTF-8 through utext_openUTF8()
+ *                   and reports segments as byte offsets. BreakIterator
+ *                   positions are int32_t, so a window is at most 2 GiB;
+ *                   nextWindow() cuts a file into windows that end after a
+ *                   newline.
+ *   StreamTranscoder converts between two charsets with ucnv_convertEx() over
+ *                   a fixed UTF-16 pivot buffer and a fixed output buffer that
+ *                   is handed to a sink whenever it fills up.
+ *
+ *   icuaddons::MappedFile file("corpus.txt", status);
+ *   for (size_t begin = 0, end; begin < file.size(); begin = end) {
+ *       end = icuaddons::nextWindow(file.data(), begin, file.size());
+ *       icuaddons::UTF8Segments words(*wordIterator, file.data() + begin, end - begin, status);
+ *       size_t start, limit;
+ *       while (words.next(start, limit)) { ... }
+ *       file.release(begin, end);
+ *   }
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include <unicode/brkiter.h>
+#include <unicode/ucnv.h>
+#include <unicode/utext.h>
+#include <unicode/utypes.h>
+
+namespace icuaddons {
+
+// A whole file mapped read-only (read into memory where mapping is not available).
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const std::string& path, UErrorCode& status);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    size_t      size() const { return size_; }
+
+    // Drop the resident pages of [begin, end); reading them again faults them back in.
+    void release(size_t begin, size_t end);
+
+private:
+    void close();
+
+    const char* data_    = nullptr;
+    size_t      size_    = 0;
+    bool        mapped_  = false;  // Otherwise data_ was allocated with new[]
+    void*       mapping_ = nullptr;  // Windows file mapping handle
+};
+
+// Windows of at most this many bytes keep BreakIterator positions in int32_t range.
+constexpr size_t kMaxWindowBytes = size_t(1) << 30;
+
+// End of the window that starts at `begin`: after the last newline within
+// `maxBytes`, or at a UTF-8 character boundary if the window has none.
+size_t nextWindow(const char* text, size_t begin, size_t length, size_t maxBytes = 64u << 20);
+
+// The segments that `iterator` finds in a UTF-8 buffer of at most
+// kMaxWindowBytes, without converting it to UTF-16. The iterator is reset to
+// the buffer; keep the buffer alive while iterating.
+class UTF8Segments {
+public:
+    UTF8Segments(icu::BreakIterator& iterator, const char* text, size_t length, UErrorCode& status);
+    ~UTF8Segments();
+
+    UTF8Segments(const UTF8Segments&) = delete;
+    UTF8Segments& operator=(const UTF8Segments&) = delete;
+
+    // The next segment as byte offsets [begin, end). False at the end.
+    bool next(size_t& begin, size_t& end);
+
+    // Rule status of the segment returned last (UBRK_WORD_NONE, UBRK_WORD_LETTER, ...).
+    int32_t ruleStatus() const { return iterator_.getRuleStatus(); }
+
+private:
+    icu::BreakIterator& iterator_;
+    UText               text_  = UTEXT_INITIALIZER;
+    int32_t             start_ = 0;
+    bool                valid_ = false;
+};
+
+// Converts a stream between two charsets in pieces of any size. Input split
+// in the middle of a character is carried over to the next piece.
+class StreamTranscoder {
+public:
+    using Sink = std::function<void(const char* bytes, size_t length)>;
+
+    StreamTranscoder(const char* fromCharset, const char* toCharset, UErrorCode& status);
+    ~StreamTranscoder();
+
+    StreamTranscoder(const StreamTranscoder&) = delete;
+    StreamTranscoder& operator=(const StreamTranscoder&) = delete;
+
+    // Convert the next piece; `flush` on the last one. `sink` receives the
+    // output in pieces of at most kOutputBytes.
+    void convert(const char* input, size_t length, bool flush, const Sink& sink, UErrorCode& status);
+
+    // Start a new stream (drops carried-over input).
+    void reset();
+
+    static constexpr size_t kPivotUnits  = 4096;
+    static constexpr size_t kOutputBytes = 64 * 1024;
+
+private:
+    UConverter* from_ = nullptr;
+    UConverter* to_   = nullptr;
+    UChar       pivot_[kPivotUnits];
+    UChar*      pivotSource_ = pivot_;
+    UChar*      pivotTarget_ = pivot_;
+    bool        started_     = false;
+    char        output_[kOutputBytes];
+};
+
+} // namespace icuaddons
@@ -0,0 +1,161 @@
+#pragma once
+
+/*
+ * ICU4C package addons - startup warm-up
+ *
+ * ICU loads its data lazily: the first Collator::createInstance(),
+ * BreakIterator::createWordInstance() or ucnv_open() of a process maps
+ * icudt*.dat (or reaches into libicudata), page-faults the items it reads and
+ * fills ICU's caches (the unified cache for collators and number symbols, the
+ * resource bundle cache, the converter cache). The first requests a server
+ * handles pay for all of that, which shows up as a p99 spike after every
+ * deployment.
+ *
+ * warmUp() does that work before the server takes traffic. It opens every
+ * service of a manifest once, so that ICU's caches hold their data, and can
+ * bring the pages of the ICU data in:
+ *
+ *   DataPages::WillNeed   madvise(MADV_WILLNEED): read-ahead, returns at once
+ *   DataPages::Prefault   fault every page in before returning
+ *   DataPages::Lock       prefault and mlock(), so the pages stay resident
+ *
+ * With a ServicePool in the options, collators, break iterators,
+ * transliterators and converters are created through it: their prototypes
+ * are then ready and the first lease of each is a clone.
+ *
+ *   icuaddons::WarmupManifest manifest;
+ *   icuaddons::parseWarmupManifest("collator de_DE\nword-break th\nconverter Shift-JIS\n", manifest, status);
+ *   icuaddons::WarmupOptions options;
+ *   options.dataPages = icuaddons::DataPages::Prefault;
+ *   options.pool      = &pool;
+ *   icuaddons::WarmupReport report;
+ *   icuaddons::warmUp(manifest, options, report, status);
+ *
+ * With options.measure, each service is opened twice and the report carries
+ * the first (cold) and second (warm) opening time of each.
+ *
+ * The data pages are those of the mapping that holds ICU's root bundle: the
+ * whole .dat, libicudata's data segment or, with the data linked in, the
+ * executable's. Linux and Windows are supported (Windows prefaults for
+ * WillNeed too); elsewhere, and where the data is not mapped (WASM), the page
+ * operations do nothing and report.dataBytes stays 0. Locking is limited by
+ * RLIMIT_MEMLOCK or the working set size; report.dataLocked tells whether it
+ * succeeded.
+ *
+ * PreloadedData instead reads the whole .dat into memory before the first
+ * ICU call and hands it to ICU with udata_setCommonData(), on Linux in
+ * transparent huge pages: a 30 MB data file then takes 15 TLB entries
+ * instead of 7500.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <unicode/utypes.h>
+
+namespace icuaddons {
+
+class ServicePool;
+
+enum class WarmupService {
+    Collator,        // Locale
+    CharacterBreak,  // Locale
+    WordBreak,       // Locale
+    LineBreak,       // Locale
+    SentenceBreak,   // Locale
+    Converter,       // Charset name
+    Normalizer,      // nfc, nfd, nfkc, nfkd or nfkc_cf
+    NumberFormat,    // Locale
+    DateFormat,      // Locale (medium date and time)
+    Transliterator,  // Transliterator ID
+};
+
+struct WarmupEntry {
+    WarmupService service;
+    std::string   argument;
+};
+
+struct WarmupManifest {
+    std::vector<WarmupEntry> entries;
+};
+
+// Append the entries of a manifest, one "<service> <argument>" per line:
+//
+//   # services of the order API
+//   collator        de_DE
+//   word-break      th
+//   converter       Shift-JIS
+//   normalizer      nfkc_cf
+//   number-format   ja_JP
+//   date-format     ja_JP
+//   transliterator  Any-Latin
+//
+// The break services are character-break, word-break, line-break and
+// sentence-break. Fails with U_PARSE_ERROR and sets `errorLine` (1-based) on
+// a line it cannot read.
+void parseWarmupManifest(const std::string& text, WarmupManifest& manifest, UErrorCode& status,
+                         size_t* errorLine = nullptr);
+
+// The manifest service name ("word-break").
+const char* warmupServiceName(WarmupService service);
+
+enum class DataPages {
+    Keep,      // Leave the pages to ICU's first uses
+    WillNeed,
+    Prefault,
+    Lock,
+};
+
+struct WarmupOptions {
+    DataPages    dataPages = DataPages::Keep;
+    bool         measure   = false;    // Open each service a second time and time both
+    ServicePool* pool      = nullptr;  // Create the poolable services through it
+};
+
+struct WarmupTiming {
+    WarmupEntry entry;
+    uint64_t    coldNs = 0;  // First opening
+    uint64_t    warmNs = 0;  // Second opening, with options.measure
+};
+
+struct WarmupReport {
+    std::vector<WarmupTiming> services;   // In manifest order
+    uint64_t                  dataBytes  = 0;      // Bytes of ICU data the page operation covered
+    uint64_t                  dataNs     = 0;      // Time it took
+    bool                      dataLocked = false;  // DataPages::Lock succeeded
+    uint64_t                  totalNs    = 0;
+};
+
+// Bring in the data pages, then open every service of `manifest`. Stops at
+// the first service that fails to open (U_UNSUPPORTED_ERROR for formats and
+// transliterators compiled out of the package).
+void warmUp(const WarmupManifest& manifest, const WarmupOptions& options, WarmupReport& report, UErrorCode& status);
+
+// The ICU data file in memory, handed to ICU with udata_setCommonData().
+class PreloadedData {
+public:
+    PreloadedData() = default;
+    ~PreloadedData();
+
+    PreloadedData(const PreloadedData&) = delete;
+    PreloadedData& operator=(const PreloadedData&) = delete;
+
+    // Read `path` (empty: icudt*.dat in u_getDataDirectory()) and install it,
+    // in transparent huge pages if `hugePages` and the system has them. Call
+    // before any other ICU call, and keep the object until after u_cleanup().
+    void load(const std::string& path, bool hugePages, UErrorCode& status);
+
+    size_t size() const { return size_; }
+    bool   hugePages() const { return hugePages_; }  // The kernel accepted MADV_HUGEPAGE
+
+private:
+    char*  data_        = nullptr;
+    size_t size_        = 0;
+    void*  mapping_     = nullptr;  // Anonymous mapping holding data_, null if data_ came from new[]
+    size_t mappingSize_ = 0;
+    bool   hugePages_   = false;
+};
+
+} // namespace icuaddons
@@ -0,0 +1,201 @@
+#include "icuaddons/formatting.h"
+
+#if !UCONFIG_NO_FORMATTING
+
+#include <iterator>
+#include <limits>
+
+#include <unicode/uformattedvalue.h>
+#include <unicode/ustring.h>
+
+namespace icuaddons {
+
+namespace {
+
+// UTF-16 to UTF-8 into the caller's buffer, with the ICU extract conventions.
+int32_t toUTF8(const char16_t* text, int32_t length, char* buffer, int32_t capacity, UErrorCode& status) {
+    int32_t written = 0;
+    u_strToUTF8(buffer, capacity, &written, text, length, &status);
+    return written;
+}
+
+// Append the UTF-8 form of `text` to `out` as its next string.
+void appendUTF8(const char16_t* text, int32_t length, FormattedStrings& out, UErrorCode& status) {
+    if (U_FAILURE(status)) {
+        return;
+    }
+    // Formatted values are short; three bytes per UTF-16 unit always fit
+    const size_t start = out.bytes.size();
+    out.bytes.resize(start + static_cast<size_t>(length) * 3);
+    int32_t written = toUTF8(text, length, out.bytes.data() + start, length * 3, status);
+    out.bytes.resize(start + (U_SUCCESS(status) ? written : 0));
+    if (status == U_STRING_NOT_TERMINATED_WARNING) {
+        status = U_ZERO_ERROR;
+    }
+    if (out.bytes.size() > std::numeric_limits<uint32_t>::max()) {
+        status = U_INDEX_OUTOFBOUNDS_ERROR;
+        return;
+    }
+    out.offsets.push_back(static_cast<uint32_t>(out.bytes.size()));
+}
+
+void startBatch(size_t count, FormattedStrings& out) {
+    out.bytes.clear();
+    out.offsets.assign(1, 0);
+    out.offsets.reserve(count + 1);
+}
+
+std::string cacheKey(const icu::Locale& locale, const icu::UnicodeString& skeleton, const icu::UnicodeString& timeZone) {
+    std::string key = locale.getName();
+    key += '\n';
+    skeleton.toUTF8String(key);
+    key += '\n';
+    timeZone.toUTF8String(key);
+    return key;
+}
+
+} // namespace
+
+CompiledNumberFormat::CompiledNumberFormat(const icu::Locale& locale, const icu::UnicodeString& skeleton,
+                                           UErrorCode& status)
+    : formatter_(unumf_openForSkeletonAndLocale(skeleton.getBuffer(), skeleton.length(), locale.getName(), &status)),
+      result_(unumf_openResult(&status)) {}
+
+int32_t CompiledNumberFormat::extract(char* buffer, int32_t capacity, UErrorCode& status) {
+    int32_t length = 0;
+    const char16_t* text = ufmtval_getString(unumf_resultAsValue(result_.getAlias(), &status), &length, &status);
+    return U_SUCCESS(status) ? toUTF8(text, length, buffer, capacity, status) : 0;
+}
+
+void CompiledNumberFormat::append(FormattedStrings& out, UErrorCode& status) {
+    int32_t length = 0;
+    const char16_t* text = ufmtval_getString(unumf_resultAsValue(result_.getAlias(), &status), &length, &status);
+    appendUTF8(text, length, out, status);
+}
+
+int32_t CompiledNumberFormat::format(double value, char* buffer, int32_t capacity, UErrorCode& status) {
+    unumf_formatDouble(formatter_.getAlias(), value, result_.getAlias(), &status);
+    return U_SUCCESS(status) ? extract(buffer, capacity, status) : 0;
+}
+
+int32_t CompiledNumberFormat::format(int64_t value, char* buffer, int32_t capacity, UErrorCode& status) {
+    unumf_formatInt(formatter_.getAlias(), value, result_.getAlias(), &status);
+    return U_SUCCESS(status) ? extract(buffer, capacity, status) : 0;
+}
+
+void CompiledNumberFormat::formatBatch(const double* values, size_t count, FormattedStrings& out, UErrorCode& status) {
+    startBatch(count, out);
+    for (size_t i = 0; i < count && U_SUCCESS(status); ++i) {
+        unumf_formatDouble(formatter_.getAlias(), values[i], result_.getAlias(), &status);
+        append(out, status);
+    }
+}
+
+void CompiledNumberFormat::formatBatch(const int64_t* values, size_t count, FormattedStrings& out, UErrorCode& status) {
+    startBatch(count, out);
+    for (size_t i = 0; i < count && U_SUCCESS(status); ++i) {
+        unumf_formatInt(formatter_.getAlias(), values[i], result_.getAlias(), &status);
+        append(out, status);
+    }
+}
+
+CompiledDateFormat::CompiledDateFormat(const icu::Locale& locale, UDateTimePatternGenerator* generator,
+                                       const icu::UnicodeString& skeleton, const icu::UnicodeString& timeZone,
+                                       UErrorCode& status) {
+    if (U_FAILURE(status)) {
+        return;
+    }
+    char16_t pattern[128];
+    int32_t length = udatpg_getBestPattern(generator, skeleton.getBuffer(), skeleton.length(), pattern,
+                                           static_cast<int32_t>(std::size(pattern)), &status);
+    if (U_FAILURE(status)) {
+        return;
+    }
+    pattern_.setTo(pattern, length);
+    formatter_.adoptInstead(udat_open(UDAT_PATTERN, UDAT_PATTERN, locale.getName(),
+                                      timeZone.isEmpty() ? nullptr : timeZone.getBuffer(), timeZone.length(),
+                                      pattern_.getBuffer(), pattern_.length(), &status));
+}
+
+const char16_t* CompiledDateFormat::formatUTF16(UDate date, int32_t& length, UErrorCode& status) {
+    length = udat_format(formatter_.getAlias(), date, utf16_, static_cast<int32_t>(std::size(utf16_)), nullptr, &status);
+    if (status != U_BUFFER_OVERFLOW_ERROR) {
+        return utf16_;
+    }
+    status = U_ZERO_ERROR;
+    length = udat_format(formatter_.getAlias(), date, longer_.getBuffer(length), length, nullptr, &status);
+    longer_.releaseBuffer(U_SUCCESS(status) ? length : 0);
+    if (status == U_STRING_NOT_TERMINATED_WARNING) {
+        status = U_ZERO_ERROR;
+    }
+    return longer_.getBuffer();
+}
+
+int32_t CompiledDateFormat::format(UDate date, char* buffer, int32_t capacity, UErrorCode& status) {
+    if (U_FAILURE(status)) {
+        return 0;
+    }
+    int32_t length = 0;
+    const char16_t* text = formatUTF16(date, length, status);
+    return U_SUCCESS(status) ? toUTF8(text, length, buffer, capacity, status) : 0;
+}
+
+void CompiledDateFormat::formatBatch(const UDate* dates, size_t count, FormattedStrings& out, UErrorCode& status) {
+    startBatch(count, out);
+    for (size_t i = 0; i < count && U_SUCCESS(status); ++i) {
+        int32_t length = 0;
+        const char16_t* text = formatUTF16(dates[i], length, status);
+        appendUTF8(text, length, out, status);
+    }
+}
+
+FormatterCache::FormatterCache() = default;
+FormatterCache::~FormatterCache() = default;
+
+CompiledNumberFormat* FormatterCache::number(const icu::Locale& locale, const icu::UnicodeString& skeleton,
+                                             UErrorCode& status) {
+    if (U_FAILURE(status)) {
+        return nullptr;
+    }
+    const std::string key = cacheKey(locale, skeleton, icu::UnicodeString());
+    auto found = numbers_.find(key);
+    if (found != numbers_.end()) {
+        return found->second.get();
+    }
+    std::unique_ptr<CompiledNumberFormat> compiled(new CompiledNumberFormat(locale, skeleton, status));
+    if (U_FAILURE(status)) {
+        return nullptr;
+    }
+    return numbers_.emplace(key, std::move(compiled)).first->second.get();
+}
+
+CompiledDateFormat* FormatterCache::date(const icu::Locale& locale, const icu::UnicodeString& skeleton,
+                                         UErrorCode& status, const icu::UnicodeString& timeZone) {
+    if (U_FAILURE(status)) {
+        return nullptr;
+    }
+    const std::string key = cacheKey(locale, skeleton, timeZone);
+    auto found = dates_.find(key);
+    if (found != dates_.end()) {
+        return found->second.get();
+    }
+
+    icu::LocalUDateTimePatternGeneratorPointer& generator = generators_[locale.getName()];
+    if (generator.isNull()) {
+        generator.adoptInstead(udatpg_open(locale.getName(), &status));
+        if (U_FAILURE(status)) {
+            generators_.erase(locale.getName());
+            return nullptr;
+        }
+    }
+    std::unique_ptr<CompiledDateFormat> compiled(
+        new CompiledDateFormat(locale, generator.getAlias(), skeleton, timeZone, status));
+    if (U_FAILURE(status)) {
+        return nullptr;
+    }
+    return dates_.emplace(key, std::move(compiled)).first->second.get();
+}
+
+} // namespace icuaddons
+
+#endif  // !UCONFIG_NO_FORMATTING
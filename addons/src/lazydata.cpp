@@ -0,0 +1,336 @@
+#include "icuaddons/lazydata.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include <unicode/locid.h>
+#include <unicode/putil.h>
+#include <unicode/ucnv.h>
+#include <unicode/ures.h>
+#include <unicode/ustring.h>
+
+namespace icuaddons {
+
+namespace {
+
+// Top-level items every locale lookup reads (likely subtags, locale aliases)
+const char* const kBaseItems[] = {"likelySubtags.res", "metadata.res", "icuver.res"};
+
+// Scripts that the break iterators segment with a dictionary, by language
+const struct {
+    const char* language;
+    const char* dictionary;
+} kBreakDictionaries[] = {
+    {"th", "brkitr/thaidict.dict"},   {"lo", "brkitr/laodict.dict"}, {"km", "brkitr/khmerdict.dict"},
+    {"my", "brkitr/burmesedict.dict"}, {"ja", "brkitr/cjdict.dict"},  {"zh", "brkitr/cjdict.dict"},
+    {"ko", "brkitr/cjdict.dict"},
+};
+
+const char* treeName(DataFeature feature) {
+    switch (feature) {
+    case DataFeature::Locale:          return "";
+    case DataFeature::Collation:       return "coll";
+    case DataFeature::BreakIteration:  return "brkitr";
+    case DataFeature::Languages:       return "lang";
+    case DataFeature::Regions:         return "region";
+    case DataFeature::Units:           return "unit";
+    case DataFeature::TimeZones:       return "zone";
+    case DataFeature::Spellout:        return "rbnf";
+    case DataFeature::Transliteration: return "translit";
+    case DataFeature::Normalization:   return "";
+    }
+    return "";
+}
+
+// "de_CH.res", "root.res", "zh_Hant.res": a bundle that belongs to one locale.
+bool isLocaleBundle(const std::string& stem) {
+    if (stem == "root") {
+        return true;
+    }
+    if (stem == "res_index" || stem == "pool") {
+        return false;
+    }
+    size_t language = stem.find('_');
+    if (language == std::string::npos) {
+        language = stem.size();
+    }
+    if (language < 2 || language > 3) {
+        return false;
+    }
+    for (size_t i = 0; i < language; ++i) {
+        if (stem[i] < 'a' || stem[i] > 'z') {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The locale and its truncations: de_Latn_CH, de_Latn, de.
+void appendTruncations(std::string name, std::vector<std::string>& names) {
+    while (!name.empty()) {
+        names.push_back(name);
+        size_t separator = name.rfind('_');
+        if (separator == std::string::npos) {
+            break;
+        }
+        name.resize(separator);
+        while (!name.empty() && name.back() == '_') {
+            name.pop_back();
+        }
+    }
+}
+
+// A link a bundle stores to another bundle of its tree (%%ALIAS, %%Parent), read from
+// a copy in `directory`. Opening the bundle in the data ICU uses would also open its
+// parents, and ICU would remember the ones that are not loaded yet as missing.
+std::string bundleLink(const std::string& directory, const std::string& name, const char* key) {
+    UErrorCode status = U_ZERO_ERROR;
+    UResourceBundle* bundle = ures_openDirect(directory.c_str(), name.c_str(), &status);
+    int32_t length = 0;
+    const UChar* link = ures_getStringByKey(bundle, key, &length, &status);
+    std::string result;
+    if (U_SUCCESS(status)) {
+        result.resize(length);
+        u_UCharsToChars(link, result.data(), length);
+    }
+    ures_close(bundle);
+    return result;
+}
+
+} // namespace
+
+DataLoader directoryLoader(const std::string& directory) {
+    return [directory](const std::string& name, std::vector<uint8_t>& bytes) {
+        std::ifstream file(directory + "/" + name, std::ios::binary | std::ios::ate);
+        if (!file) {
+            return false;
+        }
+        bytes.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(bytes.data()), bytes.size()));
+    };
+}
+
+LazyData::LazyData(DataLoader loader, std::string directory)
+    : loader_(std::move(loader)), directory_(std::move(directory)) {}
+
+void LazyData::install(UErrorCode& status) {
+    if (U_FAILURE(status)) {
+        return;
+    }
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::vector<uint8_t> bytes;
+    if (!loader_("index.txt", bytes)) {
+        status = U_FILE_ACCESS_ERROR;
+        return;
+    }
+    std::istringstream lines(std::string(bytes.begin(), bytes.end()));
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string item;
+        uint64_t size = 0;
+        if (!(fields >> item >> size)) {
+            status = U_INVALID_FORMAT_ERROR;
+            return;
+        }
+        index_[item] = size;
+        indexBytes_ += size;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(directory_) / U_ICUDATA_NAME, error);
+    if (error) {
+        status = U_FILE_ACCESS_ERROR;
+        return;
+    }
+    for (const char* item : kBaseItems) {
+        loadItem(item, status);
+    }
+    u_setDataDirectory(directory_.c_str());
+}
+
+void LazyData::require(DataFeature feature, const char* locale, UErrorCode& status) {
+    if (U_FAILURE(status)) {
+        return;
+    }
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (feature == DataFeature::Normalization) {
+        for (const auto& entry : index_) {
+            const std::string& item = entry.first;
+            if (item.find('/') == std::string::npos && item.size() > 4 && item.compare(item.size() - 4, 4, ".nrm") == 0) {
+                loadItem(item, status);
+            }
+        }
+        return;
+    }
+    const std::string tree = treeName(feature);
+    loadSharedItems(tree, status);
+    loadBundles(tree, locale, status);
+    if (feature == DataFeature::Locale) {
+        // Number formats read the currency symbols
+        loadSharedItems("curr", status);
+        loadBundles("curr", locale, status);
+    }
+
+    if (feature == DataFeature::BreakIteration) {
+        const std::string language = icu::Locale(locale).getLanguage();
+        for (const auto& entry : kBreakDictionaries) {
+            if (language == entry.language) {
+                requireItem(entry.dictionary, status);
+                // The Chinese/Japanese engine normalizes the text with NFKC
+                if (std::string(entry.dictionary) == "brkitr/cjdict.dict") {
+                    requireItem("nfkc.nrm", status);
+                }
+            }
+        }
+    }
+}
+
+void LazyData::requireConverter(const char* name, UErrorCode& status) {
+    if (U_FAILURE(status)) {
+        return;
+    }
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (!loadItem("cnvalias.icu", status)) {
+        return;
+    }
+    // Alias 0 is the converter's own name, which is also the name of its table.
+    // Ambiguous aliases ("Shift-JIS") warn; the caller gets only the failures.
+    UErrorCode aliasStatus = U_ZERO_ERROR;
+    const char* converter = ucnv_getAlias(name, 0, &aliasStatus);
+    if (U_FAILURE(aliasStatus)) {
+        status = aliasStatus;
+    } else if (converter != nullptr) {
+        loadItem(std::string(converter) + ".cnv", status);
+    }
+}
+
+bool LazyData::requireItem(const std::string& item, UErrorCode& status) {
+    if (U_FAILURE(status)) {
+        return false;
+    }
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return loadItem(item, status);
+}
+
+size_t LazyData::itemsAvailable() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return index_.size();
+}
+
+uint64_t LazyData::bytesAvailable() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return indexBytes_;
+}
+
+size_t LazyData::itemsLoaded() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return loaded_.size();
+}
+
+uint64_t LazyData::bytesLoaded() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return loadedBytes_;
+}
+
+// Fetch an item of the index into the directory once. False if it is not in the index.
+bool LazyData::loadItem(const std::string& item, UErrorCode& status) {
+    if (U_FAILURE(status) || index_.count(item) == 0) {
+        return false;
+    }
+    if (loaded_.count(item) != 0) {
+        return true;
+    }
+    std::vector<uint8_t> bytes;
+    if (!loader_(std::string(U_ICUDATA_NAME) + "/" + item, bytes)) {
+        status = U_FILE_ACCESS_ERROR;
+        return false;
+    }
+    std::filesystem::path path = std::filesystem::path(directory_) / U_ICUDATA_NAME / item;
+    std::error_code error;
+    std::filesystem::create_directories(path.parent_path(), error);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (error || !file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size())) {
+        status = U_FILE_ACCESS_ERROR;
+        return false;
+    }
+    loaded_.insert(item);
+    loadedBytes_ += bytes.size();
+    return true;
+}
+
+// The bundles of `locale` in `tree` along ICU's fallback chain: the locale with and
+// without likely subtags, the aliases and explicit parents the bundles name, and root.
+void LazyData::loadBundles(const std::string& tree, const char* locale, UErrorCode& status) {
+    const std::string prefix = tree.empty() ? "" : tree + "/";
+    const icu::Locale requested(locale);
+    std::vector<std::string> pending;
+    appendTruncations(requested.getBaseName(), pending);
+    UErrorCode likelyStatus = U_ZERO_ERROR;
+    icu::Locale maximized(requested);
+    maximized.addLikelySubtags(likelyStatus);
+    if (U_SUCCESS(likelyStatus)) {
+        appendTruncations(maximized.getBaseName(), pending);
+    }
+
+    // The copies bundleLink() reads, with the pool bundle their keys and strings may be in
+    const std::filesystem::path data = std::filesystem::path(directory_) / U_ICUDATA_NAME / tree;
+    const std::filesystem::path links = std::filesystem::path(directory_) / "links" / (tree.empty() ? "main" : tree);
+    std::error_code error;
+    std::filesystem::create_directories(links, error);
+    if (loaded_.count(prefix + "pool.res") != 0) {
+        std::filesystem::copy_file(data / "pool.res", links / "pool.res",
+                                   std::filesystem::copy_options::skip_existing, error);
+    }
+    if (error) {
+        status = U_FILE_ACCESS_ERROR;
+        return;
+    }
+
+    std::unordered_set<std::string> seen;
+    while (!pending.empty() && U_SUCCESS(status)) {
+        std::string name = std::move(pending.back());
+        pending.pop_back();
+        if (!seen.insert(name).second || !loadItem(prefix + name + ".res", status)) {
+            continue;
+        }
+        std::filesystem::copy_file(data / (name + ".res"), links / (name + ".res"),
+                                   std::filesystem::copy_options::skip_existing, error);
+        for (const char* key : {"%%ALIAS", "%%Parent"}) {
+            std::string link = error ? "" : bundleLink(links.string() + "/", name, key);
+            if (!link.empty()) {
+                appendTruncations(link, pending);
+            }
+        }
+    }
+    loadItem(prefix + "root.res", status);
+}
+
+// The items of a tree that are not locale bundles: pool.res, res_index.res, the
+// collation root, break rules. Break dictionaries are loaded by language.
+void LazyData::loadSharedItems(const std::string& tree, UErrorCode& status) {
+    for (const auto& entry : index_) {
+        const std::string& item = entry.first;
+        size_t separator = item.find('/');
+        const std::string itemTree = separator == std::string::npos ? "" : item.substr(0, separator);
+        const std::string file = separator == std::string::npos ? item : item.substr(separator + 1);
+        if (itemTree != tree || file.size() < 4) {
+            continue;
+        }
+        const std::string extension = file.substr(file.rfind('.') + 1);
+        const std::string stem = file.substr(0, file.rfind('.'));
+        // Top level: the .res data of the locale services, not converters or other optional data
+        bool shared = tree.empty() ? extension == "res" && !isLocaleBundle(stem)
+                                   : extension != "dict" && !isLocaleBundle(stem);
+        if (shared) {
+            loadItem(item, status);
+        }
+    }
+}
+
+} // namespace icuaddons
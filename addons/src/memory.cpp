@@ -0,0 +1,328 @@
+#include "icuaddons/memory.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+#include <unicode/uclean.h>
+
+namespace icuaddons {
+
+namespace {
+
+// Pool size classes; every class keeps the max_align_t alignment of a block.
+constexpr size_t   kClassSizes[]  = {16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048};
+constexpr uint32_t kClassCount    = sizeof(kClassSizes) / sizeof(kClassSizes[0]);
+constexpr uint32_t kLargeClass    = kClassCount;          // Allocated with malloc
+constexpr size_t   kChunkBytes    = 64 * 1024;            // Carved into blocks of one class at a time
+constexpr size_t   kCachedBytes   = 64 * 1024;            // Per thread and class before blocks go back to the depot
+constexpr uint32_t kTransferCount = 32;                   // Blocks moved between a thread and the depot at once
+
+struct alignas(alignof(std::max_align_t)) Header {
+    size_t   size;       // Requested size for large blocks, class size otherwise
+    uint32_t sizeClass;
+};
+
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+struct FreeList {
+    FreeBlock* head  = nullptr;
+    uint32_t   count = 0;
+};
+
+uint32_t cacheLimit(uint32_t sizeClass) {
+    size_t limit = kCachedBytes / kClassSizes[sizeClass];
+    return static_cast<uint32_t>(limit < 2 * kTransferCount ? 2 * kTransferCount : limit);
+}
+
+// Trivially destructible, so it stays usable for frees that happen while the
+// thread exits (after ThreadCacheRetirer ran).
+struct ThreadCache {
+    FreeList           lists[kClassCount];
+    char*              chunkCursor = nullptr;
+    char*              chunkEnd    = nullptr;
+    bool               registered  = false;
+    bool               retired     = false;
+    AllocationCounters counters;
+};
+
+thread_local ThreadCache tCache;
+
+// Blocks released by exited threads and by threads over their cache limit.
+struct Depot {
+    std::mutex mutex;
+    FreeList   lists[kClassCount];
+};
+
+Depot& depot() {
+    static Depot* instance = new Depot();  // Never destroyed: ICU may free memory during exit
+    return *instance;
+}
+
+bool gCountAllocations = false;
+
+// Size class of every multiple of 16 bytes up to the largest class.
+struct SizeClassTable {
+    uint8_t classes[2048 / 16 + 1] = {};
+
+    constexpr SizeClassTable() {
+        uint32_t sizeClass = 0;
+        for (size_t slot = 0; slot < sizeof(classes); ++slot) {
+            while (slot * 16 > kClassSizes[sizeClass]) {
+                ++sizeClass;
+            }
+            classes[slot] = static_cast<uint8_t>(sizeClass);
+        }
+    }
+};
+constexpr SizeClassTable kSizeClassTable;
+
+uint32_t sizeClassFor(size_t size) {
+    return size <= kClassSizes[kClassCount - 1] ? kSizeClassTable.classes[(size + 15) / 16] : kLargeClass;
+}
+
+void push(FreeList& list, Header* header) {
+    auto* block = reinterpret_cast<FreeBlock*>(header);
+    block->next = list.head;
+    list.head   = block;
+    ++list.count;
+}
+
+Header* pop(FreeList& list) {
+    FreeBlock* block = list.head;
+    if (block == nullptr) {
+        return nullptr;
+    }
+    list.head = block->next;
+    --list.count;
+    return reinterpret_cast<Header*>(block);
+}
+
+// Move up to `count` blocks from one list to another.
+void transfer(FreeList& from, FreeList& to, uint32_t count) {
+    while (count-- > 0) {
+        Header* header = pop(from);
+        if (header == nullptr) {
+            return;
+        }
+        push(to, header);
+    }
+}
+
+void retire(ThreadCache& cache) {
+    Depot& shared = depot();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    for (uint32_t sizeClass = 0; sizeClass < kClassCount; ++sizeClass) {
+        transfer(cache.lists[sizeClass], shared.lists[sizeClass], cache.lists[sizeClass].count);
+    }
+    cache.retired = true;
+}
+
+struct ThreadCacheRetirer {
+    bool active = false;
+    ~ThreadCacheRetirer() {
+        if (active) {
+            retire(tCache);
+        }
+    }
+};
+
+thread_local ThreadCacheRetirer tRetirer;
+
+Header* carve(ThreadCache& cache, uint32_t sizeClass) {
+    size_t stride = sizeof(Header) + kClassSizes[sizeClass];
+    if (cache.chunkCursor == nullptr || static_cast<size_t>(cache.chunkEnd - cache.chunkCursor) < stride) {
+        auto* chunk = static_cast<char*>(std::malloc(kChunkBytes));
+        if (chunk == nullptr) {
+            return nullptr;
+        }
+        cache.chunkCursor = chunk;
+        cache.chunkEnd    = chunk + kChunkBytes;
+    }
+    auto* header = reinterpret_cast<Header*>(cache.chunkCursor);
+    cache.chunkCursor += stride;
+    return header;
+}
+
+Header* allocateBlock(uint32_t sizeClass) {
+    ThreadCache& cache = tCache;
+    if (!cache.registered) {
+        cache.registered = true;
+        tRetirer.active  = true;  // Flushes this cache to the depot at thread exit
+    }
+
+    Header* header = nullptr;
+    if (cache.retired) {
+        Depot& shared = depot();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        header = pop(shared.lists[sizeClass]);
+    } else {
+        FreeList& list = cache.lists[sizeClass];
+        if (list.head == nullptr) {
+            Depot& shared = depot();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            transfer(shared.lists[sizeClass], list, kTransferCount);
+        }
+        header = pop(list);
+    }
+    if (header == nullptr) {
+        header = carve(cache, sizeClass);
+    }
+    if (header != nullptr) {
+        header->size      = kClassSizes[sizeClass];
+        header->sizeClass = sizeClass;
+    }
+    return header;
+}
+
+void freeBlock(Header* header) {
+    ThreadCache& cache = tCache;
+    uint32_t sizeClass = header->sizeClass;
+    if (cache.retired) {
+        Depot& shared = depot();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        push(shared.lists[sizeClass], header);
+        return;
+    }
+    FreeList& list = cache.lists[sizeClass];
+    push(list, header);
+    if (list.count > cacheLimit(sizeClass)) {
+        Depot& shared = depot();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        transfer(list, shared.lists[sizeClass], kTransferCount);
+    }
+}
+
+void* poolAllocate(size_t size) {
+    uint32_t sizeClass = sizeClassFor(size);
+    Header*  header    = nullptr;
+    if (sizeClass == kLargeClass) {
+        header = static_cast<Header*>(std::malloc(sizeof(Header) + size));
+        if (header != nullptr) {
+            header->size      = size;
+            header->sizeClass = kLargeClass;
+        }
+    } else {
+        header = allocateBlock(sizeClass);
+    }
+    return header != nullptr ? header + 1 : nullptr;
+}
+
+void poolFree(void* memory) {
+    Header* header = static_cast<Header*>(memory) - 1;
+    if (header->sizeClass == kLargeClass) {
+        std::free(header);
+    } else {
+        freeBlock(header);
+    }
+}
+
+void* poolReallocate(void* memory, size_t size) {
+    if (memory == nullptr) {
+        return poolAllocate(size);
+    }
+    Header* header = static_cast<Header*>(memory) - 1;
+    if (header->sizeClass == kLargeClass && sizeClassFor(size) == kLargeClass) {
+        auto* resized = static_cast<Header*>(std::realloc(header, sizeof(Header) + size));
+        if (resized == nullptr) {
+            return nullptr;
+        }
+        resized->size = size;
+        return resized + 1;
+    }
+    if (header->sizeClass != kLargeClass && size <= header->size) {
+        return memory;
+    }
+    void* resized = poolAllocate(size);
+    if (resized != nullptr) {
+        std::memcpy(resized, memory, header->size < size ? header->size : size);
+        poolFree(memory);
+    }
+    return resized;
+}
+
+void count(uint64_t AllocationCounters::*counter, size_t bytes) {
+    if (gCountAllocations) {
+        tCache.counters.*counter += 1;
+        tCache.counters.bytes    += bytes;
+    }
+}
+
+void* U_CALLCONV systemAlloc(const void*, size_t size) {
+    count(&AllocationCounters::allocations, size);
+    return std::malloc(size);
+}
+
+void* U_CALLCONV systemRealloc(const void*, void* memory, size_t size) {
+    count(memory == nullptr ? &AllocationCounters::allocations : &AllocationCounters::reallocations, size);
+    return std::realloc(memory, size);
+}
+
+void U_CALLCONV systemFree(const void*, void* memory) {
+    count(&AllocationCounters::frees, 0);
+    std::free(memory);
+}
+
+void* U_CALLCONV poolAlloc(const void*, size_t size) {
+    count(&AllocationCounters::allocations, size);
+    return poolAllocate(size);
+}
+
+void* U_CALLCONV poolRealloc(const void*, void* memory, size_t size) {
+    count(memory == nullptr ? &AllocationCounters::allocations : &AllocationCounters::reallocations, size);
+    return poolReallocate(memory, size);
+}
+
+void U_CALLCONV poolFreeHook(const void*, void* memory) {
+    count(&AllocationCounters::frees, 0);
+    if (memory != nullptr) {
+        poolFree(memory);
+    }
+}
+
+} // namespace
+
+AllocationCounters operator-(const AllocationCounters& after, const AllocationCounters& before) {
+    AllocationCounters difference;
+    difference.allocations   = after.allocations   - before.allocations;
+    difference.reallocations = after.reallocations - before.reallocations;
+    difference.frees         = after.frees         - before.frees;
+    difference.bytes         = after.bytes         - before.bytes;
+    return difference;
+}
+
+void installAllocator(const AllocatorOptions& options, UErrorCode& status) {
+    if (U_FAILURE(status)) {
+        return;
+    }
+    gCountAllocations = options.countAllocations;
+    if (options.allocator == Allocator::Pool) {
+        u_setMemoryFunctions(nullptr, &poolAlloc, &poolRealloc, &poolFreeHook, &status);
+    } else if (options.countAllocations) {
+        u_setMemoryFunctions(nullptr, &systemAlloc, &systemRealloc, &systemFree, &status);
+    }
+}
+
+AllocationCounters threadAllocationCounters() {
+    return tCache.counters;
+}
+
+bool parseAllocator(const char* name, Allocator& allocator) {
+    if (std::strcmp(name, "system") == 0) {
+        allocator = Allocator::System;
+    } else if (std::strcmp(name, "pool") == 0) {
+        allocator = Allocator::Pool;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* allocatorName(Allocator allocator) {
+    return allocator == Allocator::Pool ? "pool" : "system";
+}
+
+} // namespace icuaddons
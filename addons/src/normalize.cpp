@@ -0,0 +1,98 @@
+#include "icuaddons/normalize.h"
+
+#include <cstring>
+#include <limits>
+
+#include <unicode/bytestream.h>
+#include <unicode/stringpiece.h>
+#include <unicode/unistr.h>
+
+namespace icuaddons {
+
+namespace {
+
+// Appends normalizeUTF8() output to the arena without an intermediate string.
+class ArenaSink : public icu::ByteSink {
+public:
+    explicit ArenaSink(std::vector<char>& arena) : arena_(arena) {}
+
+    void Append(const char* bytes, int32_t n) override { arena_.insert(arena_.end(), bytes, bytes + n); }
+
+private:
+    std::vector<char>& arena_;
+};
+
+// Whether an ASCII prefix can be copied as is: every ASCII character is left
+// alone by `normalizer` and starts a normalization segment. Not true for
+// NFKC_Casefold, which lowercases.
+bool asciiPrefixIsStable(const icu::Normalizer2& normalizer, UErrorCode& status) {
+    icu::UnicodeString ascii;
+    for (UChar32 c = 0; c < 0x80; ++c) {
+        if (!normalizer.hasBoundaryBefore(c)) {
+            return false;
+        }
+        ascii.append(c);
+    }
+    return normalizer.isNormalized(ascii, status);
+}
+
+// Length of the ASCII prefix of `bytes`, eight bytes at a time.
+int32_t asciiPrefix(const char* bytes, int32_t length) {
+    int32_t n = 0;
+    for (uint64_t word; n + 8 <= length; n += 8) {
+        std::memcpy(&word, bytes + n, 8);
+        if ((word & 0x8080808080808080u) != 0) {
+            break;
+        }
+    }
+    while (n < length && static_cast<unsigned char>(bytes[n]) < 0x80) {
+        ++n;
+    }
+    return n;
+}
+
+} // namespace
+
+void normalizeBatchUTF8(const icu::Normalizer2& normalizer, const char* text, const uint32_t* offsets, size_t count,
+                        NormalizedRecords& normalized, UErrorCode& status) {
+    normalized.text = text;
+    normalized.arena.clear();
+    normalized.records.clear();
+    normalized.zeroCopy = 0;
+    if (U_FAILURE(status) || count == 0) {
+        return;
+    }
+
+    const bool stablePrefix = asciiPrefixIsStable(normalizer, status);
+    normalized.records.reserve(count);
+    ArenaSink sink(normalized.arena);
+    for (size_t i = 0; i < count && U_SUCCESS(status); ++i) {
+        const char*   record = text + offsets[i];
+        const int32_t length = static_cast<int32_t>(offsets[i + 1] - offsets[i]);
+
+        // The ASCII prefix is normalized, and so is the record if the rest is,
+        // starting at the last ASCII character (it may combine with what follows)
+        int32_t prefix = 0;
+        if (stablePrefix) {
+            prefix = asciiPrefix(record, length);
+            prefix = prefix == length ? length : (prefix > 0 ? prefix - 1 : 0);
+        }
+        if (prefix == length || normalizer.isNormalizedUTF8(icu::StringPiece(record + prefix, length - prefix), status)) {
+            normalized.records.push_back({offsets[i], static_cast<uint32_t>(length), false});
+            ++normalized.zeroCopy;
+            continue;
+        }
+
+        const size_t start = normalized.arena.size();
+        normalized.arena.insert(normalized.arena.end(), record, record + prefix);
+        normalizer.normalizeUTF8(0, icu::StringPiece(record + prefix, length - prefix), sink, nullptr, status);
+        if (normalized.arena.size() > std::numeric_limits<uint32_t>::max()) {
+            status = U_INDEX_OUTOFBOUNDS_ERROR;
+            break;
+        }
+        normalized.records.push_back(
+            {static_cast<uint32_t>(start), static_cast<uint32_t>(normalized.arena.size() - start), true});
+    }
+}
+
+} // namespace icuaddons
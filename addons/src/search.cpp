@@ -0,0 +1,305 @@
+#include "icuaddons/search.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include <unicode/usearch.h>
+#include <unicode/ustring.h>
+#include <unicode/utext.h>
+#include <unicode/utf16.h>
+#include <unicode/utf8.h>
+#if !UCONFIG_NO_REGULAR_EXPRESSIONS
+#include <unicode/regex.h>
+#endif
+
+namespace icuaddons {
+
+namespace {
+
+constexpr size_t kShardsPerTake = 16;  // Shards a countMatches() thread takes at a time
+
+// Without pthreads (plain WebAssembly builds) std::thread cannot start threads
+size_t usableThreads(size_t threads, size_t shards) {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    (void)threads;
+    (void)shards;
+    return 1;
+#else
+    return std::max<size_t>(1, std::min(threads, (shards + kShardsPerTake - 1) / kShardsPerTake));
+#endif
+}
+
+// Maps ascending offsets into the UTF-16 conversion of a UTF-8 text back to
+// byte offsets, by walking the UTF-8 source itself: U8_NEXT() takes an
+// ill-formed sequence as one unit, like the conversion that made it one
+// U+FFFD, so offsets after invalid bytes stay exact.
+class OffsetMap {
+public:
+    OffsetMap(const char* text, size_t length) : text_(text), length_(static_cast<int32_t>(length)) {}
+
+    size_t toUTF8(int32_t utf16Offset) {
+        if (utf16Offset < utf16_) {
+            utf16_ = 0;
+            utf8_  = 0;
+        }
+        while (utf16_ < utf16Offset && utf8_ < length_) {
+            UChar32 c;
+            U8_NEXT(text_, utf8_, length_, c);
+            utf16_ += c < 0 ? 1 : U16_LENGTH(c);
+        }
+        return static_cast<size_t>(utf8_);
+    }
+
+private:
+    const char* text_;
+    int32_t     length_;  // convert() rejects texts over INT32_MAX bytes
+    int32_t     utf16_ = 0;
+    int32_t     utf8_  = 0;
+};
+
+} // namespace
+
+struct SearchPatterns::Pattern {
+    PatternKind kind = PatternKind::Regex;
+#if !UCONFIG_NO_REGULAR_EXPRESSIONS
+    std::unique_ptr<icu::RegexPattern> regex;  // Thread-safe, shared by the Searchers
+#endif
+    icu::UnicodeString             text;
+    std::unique_ptr<icu::Collator> collator;   // Prototype, cloned by each Searcher
+};
+
+struct Searcher::Matcher {
+    ~Matcher() {
+        if (search != nullptr) {
+            usearch_close(search);
+        }
+    }
+
+#if !UCONFIG_NO_REGULAR_EXPRESSIONS
+    std::unique_ptr<icu::RegexMatcher> regex;
+#endif
+    std::unique_ptr<icu::Collator> collator;  // Used by `search`
+    UStringSearch*                 search = nullptr;
+};
+
+SearchPatterns::SearchPatterns() = default;
+SearchPatterns::~SearchPatterns() = default;
+
+size_t SearchPatterns::addRegex(const icu::UnicodeString& regex, uint32_t flags, UErrorCode& status) {
+    if (U_FAILURE(status)) {
+        return 0;
+    }
+#if UCONFIG_NO_REGULAR_EXPRESSIONS
+    (void)regex;
+    (void)flags;
+    status = U_UNSUPPORTED_ERROR;
+    return 0;
+#else
+    std::unique_ptr<Pattern> pattern(new Pattern());
+    pattern->kind = PatternKind::Regex;
+    UParseError parseError;
+    pattern->regex.reset(icu::RegexPattern::compile(regex, flags, parseError, status));
+    if (U_FAILURE(status)) {
+        return 0;
+    }
+    patterns_.push_back(std::move(pattern));
+    return patterns_.size() - 1;
+#endif
+}
+
+size_t SearchPatterns::addCollated(const icu::UnicodeString& text, const icu::Locale& locale,
+                                   UColAttributeValue strength, UErrorCode& status) {
+    if (U_FAILURE(status)) {
+        return 0;
+    }
+    if (text.isEmpty()) {
+        status = U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+    std::unique_ptr<Pattern> pattern(new Pattern());
+    pattern->kind = PatternKind::Collated;
+    pattern->text = text;
+    pattern->collator.reset(icu::Collator::createInstance(locale, status));
+    if (U_FAILURE(status)) {
+        return 0;
+    }
+    pattern->collator->setAttribute(UCOL_STRENGTH, strength, status);
+    if (U_FAILURE(status)) {
+        return 0;
+    }
+    patterns_.push_back(std::move(pattern));
+    return patterns_.size() - 1;
+}
+
+PatternKind SearchPatterns::kind(size_t pattern) const {
+    return patterns_[pattern]->kind;
+}
+
+Searcher::Searcher(const SearchPatterns& patterns, UErrorCode& status, bool regexOverUTF8)
+    : patterns_(patterns), regexOverUTF8_(regexOverUTF8) {
+    static const char16_t kPlaceholder[] = u" ";  // usearch_openFromCollator() needs some text
+    for (const auto& pattern : patterns.patterns_) {
+        if (U_FAILURE(status)) {
+            return;
+        }
+        std::unique_ptr<Matcher> matcher(new Matcher());
+        if (pattern->kind == PatternKind::Collated) {
+            matcher->collator.reset(pattern->collator->clone());
+            if (matcher->collator == nullptr) {
+                status = U_MEMORY_ALLOCATION_ERROR;
+                return;
+            }
+            matcher->search = usearch_openFromCollator(pattern->text.getBuffer(), pattern->text.length(), kPlaceholder, 1,
+                                                       matcher->collator->toUCollator(), nullptr, &status);
+        }
+#if !UCONFIG_NO_REGULAR_EXPRESSIONS
+        else {
+            matcher->regex.reset(pattern->regex->matcher(status));
+        }
+#endif
+        matchers_.push_back(std::move(matcher));
+    }
+}
+
+Searcher::~Searcher() = default;
+
+void Searcher::convert(const char* text, size_t length, UErrorCode& status) {
+    if (length > static_cast<size_t>(INT32_MAX)) {
+        status = U_INDEX_OUTOFBOUNDS_ERROR;
+        return;
+    }
+    // UTF-16 never needs more units than UTF-8 has bytes
+    int32_t capacity = static_cast<int32_t>(length);
+    int32_t written  = 0;
+    u_strFromUTF8WithSub(utf16_.getBuffer(capacity), capacity, &written, text, capacity, 0xFFFD, nullptr, &status);
+    utf16_.releaseBuffer(U_SUCCESS(status) ? written : 0);
+    if (status == U_STRING_NOT_TERMINATED_WARNING) {
+        status = U_ZERO_ERROR;
+    }
+}
+
+void Searcher::run(size_t pattern, const char* text, size_t length, bool& converted, const MatchCallback* onMatch,
+                   uint64_t& matches, UErrorCode& status) {
+    Matcher& matcher = *matchers_[pattern];
+    if (U_FAILURE(status) || length == 0) {
+        return;
+    }
+
+#if !UCONFIG_NO_REGULAR_EXPRESSIONS
+    if (matcher.regex != nullptr && regexOverUTF8_) {
+        // Native indexes of a UTF-8 UText are byte offsets
+        UText utf8 = UTEXT_INITIALIZER;
+        utext_openUTF8(&utf8, text, static_cast<int64_t>(length), &status);
+        matcher.regex->reset(&utf8);
+        while (U_SUCCESS(status) && matcher.regex->find(status)) {
+            ++matches;
+            if (onMatch != nullptr) {
+                (*onMatch)(pattern, static_cast<size_t>(matcher.regex->start64(status)),
+                           static_cast<size_t>(matcher.regex->end64(status)));
+            }
+        }
+        utext_close(&utf8);
+        return;
+    }
+#endif
+
+    if (!converted) {
+        convert(text, length, status);
+        converted = true;
+    }
+    if (U_FAILURE(status) || utf16_.isEmpty()) {
+        return;
+    }
+    OffsetMap offsets(text, length);
+    if (matcher.search != nullptr) {
+        usearch_setText(matcher.search, utf16_.getBuffer(), utf16_.length(), &status);
+        for (int32_t start = usearch_first(matcher.search, &status); U_SUCCESS(status) && start != USEARCH_DONE;
+             start = usearch_next(matcher.search, &status)) {
+            ++matches;
+            if (onMatch != nullptr) {
+                size_t begin = offsets.toUTF8(start);
+                (*onMatch)(pattern, begin, offsets.toUTF8(start + usearch_getMatchedLength(matcher.search)));
+            }
+        }
+        return;
+    }
+#if !UCONFIG_NO_REGULAR_EXPRESSIONS
+    matcher.regex->reset(utf16_);
+    while (U_SUCCESS(status) && matcher.regex->find(status)) {
+        ++matches;
+        if (onMatch != nullptr) {
+            size_t begin = offsets.toUTF8(matcher.regex->start(status));
+            (*onMatch)(pattern, begin, offsets.toUTF8(matcher.regex->end(status)));
+        }
+    }
+#endif
+}
+
+void Searcher::scan(const char* text, size_t length, const MatchCallback& onMatch, UErrorCode& status) {
+    bool converted = false;
+    for (size_t pattern = 0; pattern < matchers_.size(); ++pattern) {
+        uint64_t matches = 0;
+        run(pattern, text, length, converted, &onMatch, matches, status);
+    }
+}
+
+uint64_t Searcher::count(size_t pattern, const char* text, size_t length, UErrorCode& status) {
+    bool converted = false;
+    uint64_t matches = 0;
+    run(pattern, text, length, converted, nullptr, matches, status);
+    return matches;
+}
+
+void Searcher::countAll(const char* text, size_t length, uint64_t* counts, UErrorCode& status) {
+    bool converted = false;
+    for (size_t pattern = 0; pattern < matchers_.size(); ++pattern) {
+        run(pattern, text, length, converted, nullptr, counts[pattern], status);
+    }
+}
+
+std::vector<uint64_t> countMatches(const SearchPatterns& patterns, const char* text, const uint32_t* offsets,
+                                   size_t shards, UErrorCode& status, size_t threads) {
+    std::vector<uint64_t> total(patterns.size(), 0);
+    if (U_FAILURE(status) || shards == 0) {
+        return total;
+    }
+
+    threads = usableThreads(threads, shards);
+    std::atomic<size_t> next{0};
+    std::vector<std::vector<uint64_t>> counts(threads, std::vector<uint64_t>(patterns.size(), 0));
+    std::vector<UErrorCode> statuses(threads, U_ZERO_ERROR);
+    auto work = [&](size_t t) {
+        Searcher searcher(patterns, statuses[t]);
+        for (size_t begin = next.fetch_add(kShardsPerTake); begin < shards && U_SUCCESS(statuses[t]);
+             begin = next.fetch_add(kShardsPerTake)) {
+            for (size_t shard = begin; shard < std::min(shards, begin + kShardsPerTake); ++shard) {
+                searcher.countAll(text + offsets[shard], offsets[shard + 1] - offsets[shard], counts[t].data(),
+                                  statuses[t]);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads; ++t) {
+        workers.emplace_back(work, t);
+    }
+    work(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    for (size_t t = 0; t < threads; ++t) {
+        if (U_FAILURE(statuses[t])) {
+            status = statuses[t];
+            return total;
+        }
+        for (size_t pattern = 0; pattern < patterns.size(); ++pattern) {
+            total[pattern] += counts[t][pattern];
+        }
+    }
+    return total;
+}
+
+} // namespace icuaddons
@@ -0,0 +1,279 @@
+#include "icuaddons/segmenter.h"
+
+#include "icuaddons/utf8stream.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+#include <unicode/ustring.h>
+#include <unicode/utext.h>
+#include <unicode/utf16.h>
+#include <unicode/utf8.h>
+
+namespace icuaddons {
+
+namespace {
+
+// Without pthreads (plain WebAssembly builds) std::thread cannot start threads
+size_t usableThreads(size_t threads, size_t shards) {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    (void)threads;
+    (void)shards;
+    return 1;
+#else
+    return std::max<size_t>(1, std::min(threads, shards));
+#endif
+}
+
+// The shards [begin, end) a thread has left, packed into one word so that
+// the owner taking the first and a thief taking the second half both go
+// through a single compare-and-swap.
+struct alignas(64) ShardRun {
+    std::atomic<uint64_t> bounds{0};
+
+    static uint64_t pack(uint32_t begin, uint32_t end) { return uint64_t(begin) << 32 | end; }
+
+    void assign(uint32_t begin, uint32_t end) { bounds.store(pack(begin, end)); }
+
+    uint32_t left() const {
+        uint64_t value = bounds.load(std::memory_order_relaxed);
+        return static_cast<uint32_t>(value) - static_cast<uint32_t>(value >> 32);
+    }
+
+    // Take the first shard of the run.
+    bool take(uint32_t& shard) {
+        uint64_t value = bounds.load();
+        for (;;) {
+            uint32_t begin = static_cast<uint32_t>(value >> 32), end = static_cast<uint32_t>(value);
+            if (begin >= end) {
+                return false;
+            }
+            if (bounds.compare_exchange_weak(value, pack(begin + 1, end))) {
+                shard = begin;
+                return true;
+            }
+        }
+    }
+
+    // Take the second half of the run (the last shard if only one is left).
+    bool split(uint32_t& begin, uint32_t& end) {
+        uint64_t value = bounds.load();
+        for (;;) {
+            uint32_t first = static_cast<uint32_t>(value >> 32), last = static_cast<uint32_t>(value);
+            if (first >= last) {
+                return false;
+            }
+            uint32_t middle = first + (last - first) / 2;
+            if (bounds.compare_exchange_weak(value, pack(first, middle))) {
+                begin = middle;
+                end   = last;
+                return true;
+            }
+        }
+    }
+};
+
+// The segments one thread found, shard by shard, and its UTF-16 buffer.
+struct ThreadColumns {
+    std::vector<uint32_t> ends;
+    std::vector<uint8_t>  statuses;
+    std::vector<char16_t> utf16;
+};
+
+// Where the segments of one shard went.
+struct ShardOutput {
+    uint32_t thread = 0;
+    size_t   first  = 0;  // Into the thread's columns
+    size_t   count  = 0;
+};
+
+} // namespace
+
+uint64_t Segmentation::end(size_t i) const {
+    size_t shard = static_cast<size_t>(std::upper_bound(shardFirst.begin(), shardFirst.end() - 1, i) - shardFirst.begin()) - 1;
+    return shardOffsets[shard] + ends[i];
+}
+
+Segmenter::Segmenter(BreakType type, const icu::Locale& locale, UErrorCode& status) {
+    if (U_FAILURE(status)) {
+        return;
+    }
+    switch (type) {
+    case BreakType::Character: prototype_.reset(icu::BreakIterator::createCharacterInstance(locale, status)); break;
+    case BreakType::Word:      prototype_.reset(icu::BreakIterator::createWordInstance(locale, status)); break;
+    case BreakType::Line:      prototype_.reset(icu::BreakIterator::createLineInstance(locale, status)); break;
+    case BreakType::Sentence:  prototype_.reset(icu::BreakIterator::createSentenceInstance(locale, status)); break;
+    }
+}
+
+Segmenter::~Segmenter() = default;
+
+void Segmenter::segment(const char* text, size_t length, const SegmenterOptions& options, Segmentation& out,
+                        UErrorCode& status) {
+    out = Segmentation();
+    out.shardFirst.push_back(0);
+    if (U_FAILURE(status)) {
+        return;
+    }
+    if (prototype_ == nullptr) {
+        status = U_INVALID_STATE_ERROR;
+        return;
+    }
+
+    const size_t shardBytes = std::max<size_t>(1, std::min(options.shardBytes, kMaxWindowBytes));
+    for (size_t begin = 0; begin < length; begin = nextWindow(text, begin, length, shardBytes)) {
+        out.shardOffsets.push_back(begin);
+    }
+    const size_t shards = out.shardOffsets.size();
+    if (shards == 0) {
+        return;
+    }
+    if (shards > UINT32_MAX) {
+        status = U_INDEX_OUTOFBOUNDS_ERROR;
+        return;
+    }
+    out.shardOffsets.push_back(length);  // Shard ends, removed below
+
+    const size_t threads = usableThreads(options.threads, shards);
+    while (clones_.size() < threads) {
+        clones_.emplace_back(prototype_->clone());
+        if (clones_.back() == nullptr) {
+            clones_.pop_back();
+            status = U_MEMORY_ALLOCATION_ERROR;
+            return;
+        }
+    }
+
+    std::vector<ShardRun>      runs(threads);
+    std::vector<ThreadColumns> columns(threads);
+    std::vector<ShardOutput>   outputs(shards);
+    std::vector<UErrorCode>    statuses(threads, U_ZERO_ERROR);
+    std::atomic<size_t>        steals{0};
+    for (size_t t = 0; t < threads; ++t) {
+        runs[t].assign(static_cast<uint32_t>(shards * t / threads), static_cast<uint32_t>(shards * (t + 1) / threads));
+    }
+
+    auto work = [&](size_t t) {
+        icu::BreakIterator& iterator  = *clones_[t];
+        ThreadColumns&      mine      = columns[t];
+        UErrorCode&         error     = statuses[t];
+        UText               shardText = UTEXT_INITIALIZER;  // Over the shard, or over its UTF-16 copy
+        for (;;) {
+            uint32_t shard = 0;
+            if (!runs[t].take(shard)) {
+                // Steal from the thread with the most shards left, until none has any
+                size_t victim = t;
+                for (size_t other = 0; other < threads; ++other) {
+                    if (runs[other].left() > (victim == t ? 0 : runs[victim].left())) {
+                        victim = other;
+                    }
+                }
+                uint32_t begin = 0, end = 0;
+                if (victim == t) {
+                    break;
+                }
+                if (runs[victim].split(begin, end)) {
+                    runs[t].assign(begin, end);
+                    steals.fetch_add(1, std::memory_order_relaxed);
+                }
+                continue;
+            }
+
+            const char*  start = text + out.shardOffsets[shard];
+            const size_t bytes = out.shardOffsets[shard + 1] - out.shardOffsets[shard];
+            ShardOutput& output = outputs[shard];
+            output.thread = static_cast<uint32_t>(t);
+            output.first  = mine.ends.size();
+            if (options.overUTF8) {
+                utext_openUTF8(&shardText, start, static_cast<int64_t>(bytes), &error);
+            } else {
+                // UTF-16 never needs more units than UTF-8 has bytes
+                mine.utf16.resize(std::max(mine.utf16.size(), bytes));
+                int32_t units = 0;
+                u_strFromUTF8WithSub(mine.utf16.data(), static_cast<int32_t>(bytes), &units, start,
+                                     static_cast<int32_t>(bytes), 0xFFFD, nullptr, &error);
+                if (error == U_STRING_NOT_TERMINATED_WARNING) {
+                    error = U_ZERO_ERROR;
+                }
+                utext_openUChars(&shardText, mine.utf16.data(), units, &error);
+            }
+            iterator.setText(&shardText, error);
+            if (U_FAILURE(error)) {
+                break;
+            }
+            if (options.overUTF8) {
+                // UTF-8 UText native indexes are byte offsets
+                for (int32_t limit = iterator.next(); limit != icu::BreakIterator::DONE; limit = iterator.next()) {
+                    mine.ends.push_back(static_cast<uint32_t>(limit));
+                    if (options.ruleStatus) {
+                        mine.statuses.push_back(static_cast<uint8_t>(iterator.getRuleStatus() / 100));
+                    }
+                }
+            } else {
+                // Walk the shard along the boundaries; U8_NEXT() takes an ill-formed
+                // sequence as one unit, like the conversion that made it one U+FFFD
+                const int32_t shardLength = static_cast<int32_t>(bytes);
+                int32_t       byte        = 0;
+                int32_t       unit        = 0;
+                for (int32_t limit = iterator.next(); limit != icu::BreakIterator::DONE; limit = iterator.next()) {
+                    while (unit < limit && byte < shardLength) {
+                        UChar32 c;
+                        U8_NEXT(start, byte, shardLength, c);
+                        unit += c < 0 ? 1 : U16_LENGTH(c);
+                    }
+                    mine.ends.push_back(static_cast<uint32_t>(byte));
+                    if (options.ruleStatus) {
+                        mine.statuses.push_back(static_cast<uint8_t>(iterator.getRuleStatus() / 100));
+                    }
+                }
+            }
+            output.count = mine.ends.size() - output.first;
+        }
+        utext_close(&shardText);
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads; ++t) {
+        workers.emplace_back(work, t);
+    }
+    work(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    out.shardOffsets.pop_back();
+    for (UErrorCode error : statuses) {
+        if (U_FAILURE(error)) {
+            status = error;
+            return;
+        }
+    }
+
+    // Gather the columns in shard order
+    size_t total = 0;
+    for (const auto& output : outputs) {
+        total += output.count;
+    }
+    out.ends.resize(total);
+    if (options.ruleStatus) {
+        out.statuses.resize(total);
+    }
+    out.shardFirst.resize(shards + 1);
+    size_t next = 0;
+    for (size_t shard = 0; shard < shards; ++shard) {
+        const ShardOutput& output = outputs[shard];
+        out.shardFirst[shard] = next;
+        if (output.count > 0) {
+            std::memcpy(&out.ends[next], &columns[output.thread].ends[output.first], output.count * sizeof(uint32_t));
+            if (options.ruleStatus) {
+                std::memcpy(&out.statuses[next], &columns[output.thread].statuses[output.first], output.count);
+            }
+        }
+        next += output.count;
+    }
+    out.shardFirst[shards] = next;
+    out.steals             = steals.load();
+}
+
+} // namespace icuaddons
@@ -0,0 +1,359 @@
+#include "icuaddons/servicepool.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace icuaddons {
+
+namespace {
+
+enum Kind {
+    kCollator,
+    kBreakIterator,
+    kTransliterator,
+    kConverter,
+};
+
+// How the pool clones, resets and deletes the objects of one kind.
+struct KindOps {
+    void* (*clone)(const void* prototype);
+    void (*reset)(void* object);
+    void (*destroy)(void* object);
+};
+
+// Break iterators keep a pointer to their text; returned ones point here.
+const icu::UnicodeString& emptyText() {
+    static const icu::UnicodeString* text = new icu::UnicodeString();  // Never destroyed: used during thread exit
+    return *text;
+}
+
+const KindOps kOps[] = {
+    {
+        [](const void* prototype) -> void* { return static_cast<const icu::Collator*>(prototype)->clone(); },
+        [](void*) {},
+        [](void* object) { delete static_cast<icu::Collator*>(object); },
+    },
+    {
+        [](const void* prototype) -> void* { return static_cast<const icu::BreakIterator*>(prototype)->clone(); },
+        [](void* object) { static_cast<icu::BreakIterator*>(object)->setText(emptyText()); },
+        [](void* object) { delete static_cast<icu::BreakIterator*>(object); },
+    },
+#if !UCONFIG_NO_TRANSLITERATION
+    {
+        [](const void* prototype) -> void* { return static_cast<const icu::Transliterator*>(prototype)->clone(); },
+        [](void*) {},
+        [](void* object) { delete static_cast<icu::Transliterator*>(object); },
+    },
+#else
+    {nullptr, nullptr, nullptr},
+#endif
+    {
+        [](const void* prototype) -> void* {
+            UErrorCode status = U_ZERO_ERROR;
+            UConverter* clone = ucnv_clone(static_cast<const UConverter*>(prototype), &status);
+            return U_SUCCESS(status) ? clone : nullptr;
+        },
+        [](void* object) { ucnv_reset(static_cast<UConverter*>(object)); },
+        [](void* object) { ucnv_close(static_cast<UConverter*>(object)); },
+    },
+};
+
+uint64_t nanosSince(std::chrono::steady_clock::time_point start) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+std::atomic<uint64_t> gNextPoolId{1};
+
+} // namespace
+
+namespace detail {
+
+struct PoolSlot {
+    explicit PoolSlot(const KindOps& kindOps) : ops(kindOps) {}
+
+    const KindOps&     ops;
+    std::mutex         prototypeMutex;  // Creating and cloning the prototype
+    void*              prototype = nullptr;
+    std::mutex         depotMutex;
+    std::vector<void*> depot;
+};
+
+struct PoolShared {
+    explicit PoolShared(const ServicePoolOptions& poolOptions) : options(poolOptions) {}
+
+    ~PoolShared() {
+        for (auto& entry : slots) {
+            PoolSlot& slot = *entry.second;
+            for (void* object : slot.depot) {
+                slot.ops.destroy(object);
+            }
+            if (slot.prototype != nullptr) {
+                slot.ops.destroy(slot.prototype);
+            }
+        }
+    }
+
+    const ServicePoolOptions options;
+    std::mutex               slotsMutex;
+    std::unordered_map<std::string, std::unique_ptr<PoolSlot>> slots;
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> creations{0};
+    std::atomic<uint64_t> creationNs{0};
+    std::atomic<uint64_t> maxCreationNs{0};
+    std::atomic<uint64_t> cloneNs{0};
+};
+
+} // namespace detail
+
+namespace {
+
+// The idle objects a thread keeps for one key of one pool.
+struct ThreadList {
+    void (*destroy)(void*) = nullptr;  // Still usable after the pool is gone
+    std::vector<void*> idle;
+};
+
+struct ThreadPool {
+    std::weak_ptr<detail::PoolShared>                     shared;
+    std::unordered_map<std::string, detail::PoolSlot*>    slots;
+    std::unordered_map<detail::PoolSlot*, ThreadList>     lists;
+};
+
+// Hands the idle objects to the depots of live pools when the thread exits.
+struct ThreadPools {
+    std::unordered_map<uint64_t, ThreadPool> pools;
+
+    ~ThreadPools() {
+        for (auto& entry : pools) {
+            retire(entry.second);
+        }
+    }
+
+    static void retire(ThreadPool& pool) {
+        std::shared_ptr<detail::PoolShared> shared = pool.shared.lock();
+        for (auto& entry : pool.lists) {
+            ThreadList& list = entry.second;
+            if (shared) {
+                detail::PoolSlot& slot = *entry.first;
+                std::lock_guard<std::mutex> lock(slot.depotMutex);
+                while (!list.idle.empty() && slot.depot.size() < shared->options.maxIdleShared) {
+                    slot.depot.push_back(list.idle.back());
+                    list.idle.pop_back();
+                }
+            }
+            for (void* object : list.idle) {
+                list.destroy(object);
+            }
+            list.idle.clear();
+        }
+    }
+};
+
+thread_local ThreadPools tPools;
+
+} // namespace
+
+ServicePool::ServicePool(const ServicePoolOptions& options)
+    : shared_(std::make_shared<detail::PoolShared>(options)), id_(gNextPoolId++) {}
+
+ServicePool::~ServicePool() {
+    trim();
+    tPools.pools.erase(id_);
+}
+
+void* ServicePool::acquire(const std::string& key, int kind, void* (*create)(const void*, UErrorCode&),
+                           const void* argument, detail::PoolSlot*& slot, UErrorCode& status) {
+    if (U_FAILURE(status)) {
+        return nullptr;
+    }
+    ThreadPool& local = tPools.pools[id_];
+    auto known = local.slots.find(key);
+    if (known != local.slots.end()) {
+        slot = known->second;
+    } else {
+        local.shared = shared_;
+        std::lock_guard<std::mutex> lock(shared_->slotsMutex);
+        std::unique_ptr<detail::PoolSlot>& entry = shared_->slots[key];
+        if (!entry) {
+            entry = std::make_unique<detail::PoolSlot>(kOps[kind]);
+        }
+        slot = entry.get();
+        local.slots.emplace(key, slot);
+    }
+
+    // This thread's free list, then the depot
+    ThreadList& list = local.lists[slot];
+    if (!list.idle.empty()) {
+        void* object = list.idle.back();
+        list.idle.pop_back();
+        shared_->hits.fetch_add(1, std::memory_order_relaxed);
+        return object;
+    }
+    {
+        std::lock_guard<std::mutex> lock(slot->depotMutex);
+        if (!slot->depot.empty()) {
+            void* object = slot->depot.back();
+            slot->depot.pop_back();
+            shared_->hits.fetch_add(1, std::memory_order_relaxed);
+            return object;
+        }
+    }
+
+    // Clone the prototype; not every ICU clone() may run concurrently on one object
+    std::lock_guard<std::mutex> lock(slot->prototypeMutex);
+    if (slot->prototype == nullptr) {
+        auto start = std::chrono::steady_clock::now();
+        void* prototype = create(argument, status);
+        uint64_t ns = nanosSince(start);
+        shared_->creations.fetch_add(1, std::memory_order_relaxed);
+        shared_->creationNs.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t slowest = shared_->maxCreationNs.load(std::memory_order_relaxed);
+        while (ns > slowest && !shared_->maxCreationNs.compare_exchange_weak(slowest, ns, std::memory_order_relaxed)) {
+        }
+        if (U_FAILURE(status)) {
+            if (prototype != nullptr) {
+                slot->ops.destroy(prototype);
+            }
+            return nullptr;
+        }
+        slot->prototype = prototype;
+    }
+    auto start = std::chrono::steady_clock::now();
+    void* object = slot->ops.clone(slot->prototype);
+    shared_->cloneNs.fetch_add(nanosSince(start), std::memory_order_relaxed);
+    shared_->misses.fetch_add(1, std::memory_order_relaxed);
+    if (object == nullptr) {
+        status = U_MEMORY_ALLOCATION_ERROR;
+    }
+    return object;
+}
+
+void ServicePool::release(detail::PoolSlot* slot, void* object) {
+    slot->ops.reset(object);
+    ThreadPool& local = tPools.pools[id_];
+    local.shared = shared_;
+    ThreadList& list = local.lists[slot];
+    list.destroy = slot->ops.destroy;
+    if (list.idle.size() < shared_->options.maxIdlePerThread) {
+        list.idle.push_back(object);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(slot->depotMutex);
+        if (slot->depot.size() < shared_->options.maxIdleShared) {
+            slot->depot.push_back(object);
+            return;
+        }
+    }
+    slot->ops.destroy(object);
+}
+
+Lease<icu::Collator> ServicePool::collator(const icu::Locale& locale, UErrorCode& status, UColAttributeValue strength) {
+    struct Argument {
+        const icu::Locale& locale;
+        UColAttributeValue strength;
+    } argument{locale, strength};
+    auto create = [](const void* argument, UErrorCode& status) -> void* {
+        const auto& options = *static_cast<const Argument*>(argument);
+        icu::Collator* collator = icu::Collator::createInstance(options.locale, status);
+        if (U_SUCCESS(status) && options.strength != UCOL_DEFAULT) {
+            collator->setAttribute(UCOL_STRENGTH, options.strength, status);
+        }
+        return collator;
+    };
+    detail::PoolSlot* slot = nullptr;
+    void* object = acquire(std::string("collator/") + locale.getName() + "/" + std::to_string(strength), kCollator,
+                           create, &argument, slot, status);
+    return Lease<icu::Collator>(this, slot, static_cast<icu::Collator*>(object));
+}
+
+Lease<icu::BreakIterator> ServicePool::breakIterator(BreakType type, const icu::Locale& locale, UErrorCode& status) {
+    struct Argument {
+        BreakType          type;
+        const icu::Locale& locale;
+    } argument{type, locale};
+    auto create = [](const void* argument, UErrorCode& status) -> void* {
+        const auto& options = *static_cast<const Argument*>(argument);
+        switch (options.type) {
+        case BreakType::Character: return icu::BreakIterator::createCharacterInstance(options.locale, status);
+        case BreakType::Word:      return icu::BreakIterator::createWordInstance(options.locale, status);
+        case BreakType::Line:      return icu::BreakIterator::createLineInstance(options.locale, status);
+        case BreakType::Sentence:  return icu::BreakIterator::createSentenceInstance(options.locale, status);
+        }
+        status = U_ILLEGAL_ARGUMENT_ERROR;
+        return nullptr;
+    };
+    detail::PoolSlot* slot = nullptr;
+    void* object = acquire("break/" + std::to_string(static_cast<int>(type)) + "/" + locale.getName(), kBreakIterator,
+                           create, &argument, slot, status);
+    return Lease<icu::BreakIterator>(this, slot, static_cast<icu::BreakIterator*>(object));
+}
+
+#if !UCONFIG_NO_TRANSLITERATION
+Lease<icu::Transliterator> ServicePool::transliterator(const icu::UnicodeString& id, UTransDirection direction,
+                                                       UErrorCode& status) {
+    struct Argument {
+        const icu::UnicodeString& id;
+        UTransDirection           direction;
+    } argument{id, direction};
+    auto create = [](const void* argument, UErrorCode& status) -> void* {
+        const auto& options = *static_cast<const Argument*>(argument);
+        return icu::Transliterator::createInstance(options.id, options.direction, status);
+    };
+    std::string key;
+    id.toUTF8String(key);
+    detail::PoolSlot* slot = nullptr;
+    void* object = acquire("translit/" + key + "/" + std::to_string(direction), kTransliterator, create, &argument,
+                           slot, status);
+    return Lease<icu::Transliterator>(this, slot, static_cast<icu::Transliterator*>(object));
+}
+#endif
+
+Lease<UConverter> ServicePool::converter(const char* name, UErrorCode& status) {
+    auto create = [](const void* argument, UErrorCode& status) -> void* {
+        return ucnv_open(static_cast<const char*>(argument), &status);
+    };
+    detail::PoolSlot* slot = nullptr;
+    void* object = acquire(std::string("converter/") + name, kConverter, create, name, slot, status);
+    return Lease<UConverter>(this, slot, static_cast<UConverter*>(object));
+}
+
+ServicePoolCounters ServicePool::counters() const {
+    ServicePoolCounters counters;
+    counters.hits          = shared_->hits.load(std::memory_order_relaxed);
+    counters.misses        = shared_->misses.load(std::memory_order_relaxed);
+    counters.creations     = shared_->creations.load(std::memory_order_relaxed);
+    counters.creationNs    = shared_->creationNs.load(std::memory_order_relaxed);
+    counters.maxCreationNs = shared_->maxCreationNs.load(std::memory_order_relaxed);
+    counters.cloneNs       = shared_->cloneNs.load(std::memory_order_relaxed);
+    return counters;
+}
+
+void ServicePool::trim() {
+    auto local = tPools.pools.find(id_);
+    if (local != tPools.pools.end()) {
+        for (auto& entry : local->second.lists) {
+            for (void* object : entry.second.idle) {
+                entry.second.destroy(object);
+            }
+            entry.second.idle.clear();
+        }
+    }
+    std::lock_guard<std::mutex> lock(shared_->slotsMutex);
+    for (auto& entry : shared_->slots) {
+        detail::PoolSlot& slot = *entry.second;
+        std::lock_guard<std::mutex> depotLock(slot.depotMutex);
+        for (void* object : slot.depot) {
+            slot.ops.destroy(object);
+        }
+        slot.depot.clear();
+    }
+}
+
+} // namespace icuaddons
@@ -0,0 +1,263 @@
+#include "icuaddons/sortkeys.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <numeric>
+#include <thread>
+
+#include <unicode/ustring.h>
+
+namespace icuaddons {
+
+namespace {
+
+constexpr size_t kMinKeysPerThread  = 4096;  // Smaller batches are not worth a thread
+constexpr size_t kInsertionSortSize = 24;    // Radix sort buckets up to this size are insertion sorted
+
+// Without pthreads (plain WebAssembly builds) std::thread cannot start threads
+size_t usableThreads(size_t threads, size_t items) {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    (void)threads;
+    (void)items;
+    return 1;
+#else
+    return std::max<size_t>(1, std::min(threads, items / kMinKeysPerThread));
+#endif
+}
+
+// Run `work(t)` for t = 0 .. threads-1, on the calling thread for t = 0.
+template <typename Work>
+void runOnThreads(size_t threads, Work&& work) {
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads; ++t) {
+        workers.emplace_back(work, t);
+    }
+    work(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+// The keys of one range of strings, built by one thread.
+struct KeyChunk {
+    std::vector<uint8_t> bytes;
+    size_t               used = 0;
+    std::vector<size_t>  ends;  // End of each key in bytes
+    UErrorCode           status = U_ZERO_ERROR;
+};
+
+// `source(i, buffer, string, length, status)` points `string` at string i in
+// UTF-16, converting it into `buffer` if necessary.
+template <typename Source>
+void appendKeys(const icu::Collator& collator, const uint32_t* offsets, size_t begin, size_t end, Source&& source,
+                KeyChunk& chunk) {
+    chunk.ends.reserve(end - begin);
+    chunk.bytes.resize(std::max<size_t>(64, (offsets[end] - offsets[begin]) * 4));
+    std::vector<char16_t> buffer;
+    for (size_t i = begin; i < end && U_SUCCESS(chunk.status); ++i) {
+        const char16_t* string = nullptr;
+        int32_t length = 0;
+        source(i, buffer, string, length, chunk.status);
+        if (U_FAILURE(chunk.status)) {
+            break;
+        }
+
+        size_t available = std::min<size_t>(chunk.bytes.size() - chunk.used, std::numeric_limits<int32_t>::max());
+        int32_t needed = collator.getSortKey(string, length, chunk.bytes.data() + chunk.used, static_cast<int32_t>(available));
+        if (needed <= 0) {
+            chunk.status = U_INTERNAL_PROGRAM_ERROR;
+            break;
+        }
+        if (static_cast<size_t>(needed) > available) {
+            chunk.bytes.resize(std::max(chunk.bytes.size() * 2, chunk.used + needed));
+            collator.getSortKey(string, length, chunk.bytes.data() + chunk.used, needed);
+        }
+        chunk.used += needed;
+        chunk.ends.push_back(chunk.used);
+    }
+}
+
+template <typename Source>
+void buildKeys(const icu::Collator& collator, const uint32_t* offsets, size_t count, Source&& source,
+               PackedSortKeys& keys, UErrorCode& status, size_t threads) {
+    keys.bytes.clear();
+    keys.offsets.assign(1, 0);
+    if (U_FAILURE(status) || count == 0) {
+        return;
+    }
+
+    threads = usableThreads(threads, count);
+    std::vector<KeyChunk> chunks(threads);
+    runOnThreads(threads, [&](size_t t) {
+        appendKeys(collator, offsets, count * t / threads, count * (t + 1) / threads, source, chunks[t]);
+    });
+
+    size_t total = 0;
+    for (const auto& chunk : chunks) {
+        if (U_FAILURE(chunk.status)) {
+            status = chunk.status;
+            return;
+        }
+        total += chunk.used;
+    }
+    if (total > std::numeric_limits<uint32_t>::max()) {
+        status = U_INDEX_OUTOFBOUNDS_ERROR;
+        return;
+    }
+
+    keys.offsets.reserve(count + 1);
+    if (threads == 1) {
+        chunks[0].bytes.resize(total);
+        keys.bytes.swap(chunks[0].bytes);
+    } else {
+        keys.bytes.resize(total);
+    }
+    size_t base = 0;
+    for (auto& chunk : chunks) {
+        if (threads > 1) {
+            std::copy(chunk.bytes.begin(), chunk.bytes.begin() + chunk.used, keys.bytes.begin() + base);
+        }
+        for (size_t end : chunk.ends) {
+            keys.offsets.push_back(static_cast<uint32_t>(base + end));
+        }
+        base += chunk.used;
+    }
+}
+
+// A range of `order` whose keys agree in their first `depth` bytes.
+struct SortTask {
+    size_t   begin;
+    size_t   size;
+    uint32_t depth;
+};
+
+void insertionSort(const PackedSortKeys& keys, uint32_t* order, size_t size, uint32_t depth) {
+    auto greater = [&](uint32_t a, uint32_t b) {
+        uint32_t length = std::min(keys.keyLength(a), keys.keyLength(b)) - depth;
+        return std::memcmp(keys.key(a) + depth, keys.key(b) + depth, length) > 0;
+    };
+    for (size_t i = 1; i < size; ++i) {
+        uint32_t current = order[i];
+        size_t   j       = i;
+        for (; j > 0 && greater(order[j - 1], current); --j) {
+            order[j] = order[j - 1];
+        }
+        order[j] = current;
+    }
+}
+
+// One stable counting-sort pass on the byte at task.depth. Buckets that still
+// hold several keys become new tasks; bucket 0 holds keys that ended (equal).
+void distribute(const PackedSortKeys& keys, uint32_t* order, uint32_t* scratch, const SortTask& task,
+                std::vector<SortTask>& tasks) {
+    uint32_t* range = order + task.begin;
+    size_t counts[256] = {};
+    for (size_t i = 0; i < task.size; ++i) {
+        ++counts[keys.key(range[i])[task.depth]];
+    }
+    // Long common prefixes: skip the byte without moving anything
+    if (counts[keys.key(range[0])[task.depth]] == task.size) {
+        if (keys.key(range[0])[task.depth] != 0) {
+            tasks.push_back({task.begin, task.size, task.depth + 1});
+        }
+        return;
+    }
+
+    size_t starts[256];
+    size_t start = 0;
+    for (size_t byte = 0; byte < 256; ++byte) {
+        starts[byte] = start;
+        start += counts[byte];
+    }
+    uint32_t* buffer = scratch + task.begin;
+    for (size_t i = 0; i < task.size; ++i) {
+        buffer[starts[keys.key(range[i])[task.depth]]++] = range[i];
+    }
+    std::copy(buffer, buffer + task.size, range);
+
+    for (size_t byte = 1; byte < 256; ++byte) {
+        if (counts[byte] > 1) {
+            tasks.push_back({task.begin + starts[byte] - counts[byte], counts[byte], task.depth + 1});
+        }
+    }
+}
+
+void sortTask(const PackedSortKeys& keys, uint32_t* order, uint32_t* scratch, const SortTask& first) {
+    std::vector<SortTask> tasks = {first};
+    while (!tasks.empty()) {
+        SortTask task = tasks.back();
+        tasks.pop_back();
+        if (task.size <= kInsertionSortSize) {
+            insertionSort(keys, order + task.begin, task.size, task.depth);
+        } else {
+            distribute(keys, order, scratch, task, tasks);
+        }
+    }
+}
+
+} // namespace
+
+void buildSortKeysUTF8(const icu::Collator& collator, const char* text, const uint32_t* offsets, size_t count,
+                       PackedSortKeys& keys, UErrorCode& status, size_t threads) {
+    buildKeys(collator, offsets, count, [&](size_t i, std::vector<char16_t>& buffer, const char16_t*& string,
+                                            int32_t& length, UErrorCode& error) {
+        // A UTF-8 string never has more UTF-16 units than bytes
+        int32_t bytes = static_cast<int32_t>(offsets[i + 1] - offsets[i]);
+        if (buffer.size() < static_cast<size_t>(bytes) + 1) {
+            buffer.resize(bytes + 1);
+        }
+        u_strFromUTF8WithSub(buffer.data(), static_cast<int32_t>(buffer.size()), &length, text + offsets[i], bytes,
+                             0xFFFD, nullptr, &error);
+        string = buffer.data();
+    }, keys, status, threads);
+}
+
+void buildSortKeys(const icu::Collator& collator, const char16_t* text, const uint32_t* offsets, size_t count,
+                   PackedSortKeys& keys, UErrorCode& status, size_t threads) {
+    buildKeys(collator, offsets, count, [&](size_t i, std::vector<char16_t>&, const char16_t*& string,
+                                            int32_t& length, UErrorCode&) {
+        string = text + offsets[i];
+        length = static_cast<int32_t>(offsets[i + 1] - offsets[i]);
+    }, keys, status, threads);
+}
+
+void sortedOrder(const PackedSortKeys& keys, std::vector<uint32_t>& order, size_t threads) {
+    const size_t count = keys.size();
+    order.resize(count);
+    std::iota(order.begin(), order.end(), 0);
+    if (count < 2) {
+        return;
+    }
+    std::vector<uint32_t> scratch(count);
+
+    threads = usableThreads(threads, count);
+    if (threads == 1) {
+        sortTask(keys, order.data(), scratch.data(), {0, count, 0});
+        return;
+    }
+
+    // Split the largest buckets on this thread until there is enough work to share
+    std::vector<SortTask> tasks = {{0, count, 0}};
+    const size_t shareSize = count / (threads * 8);
+    while (true) {
+        auto largest = std::max_element(tasks.begin(), tasks.end(),
+                                        [](const SortTask& a, const SortTask& b) { return a.size < b.size; });
+        if (largest == tasks.end() || largest->size <= std::max(shareSize, kInsertionSortSize)) {
+            break;
+        }
+        SortTask task = *largest;
+        tasks.erase(largest);
+        distribute(keys, order.data(), scratch.data(), task, tasks);
+    }
+    std::sort(tasks.begin(), tasks.end(), [](const SortTask& a, const SortTask& b) { return a.size > b.size; });
+
+    std::atomic<size_t> next{0};
+    runOnThreads(threads, [&](size_t) {
+        for (size_t i = next.fetch_add(1); i < tasks.size(); i = next.fetch_add(1)) {
+            sortTask(keys, order.data(), scratch.data(), tasks[i]);
+        }
+    });
+}
+
+} // namespace icuaddons
@@ -0,0 +1,160 @@
+#include "icuaddons/trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+
+#include <unicode/uclean.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define ICUADDONS_HAS_USDT 1
+#endif
+#endif
+
+namespace icuaddons {
+
+namespace {
+
+// Trace function numbers come in groups of 0x1000 (UTRACE_CONVERSION_START, ...),
+// each with a few functions; one statistics slot per group and function.
+constexpr int32_t kGroups         = 5;
+constexpr int32_t kGroupFunctions = 16;
+constexpr int32_t kSlots          = kGroups * kGroupFunctions;
+
+struct Slot {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> totalNs{0};
+    std::atomic<uint64_t> maxNs{0};
+};
+
+Slot              gSlots[kSlots];
+std::atomic<bool> gAvailable{false};
+TraceHook         gHook        = nullptr;
+void*             gHookContext = nullptr;
+
+int32_t slotOf(int32_t function) {
+    int32_t group = function >> 12, index = function & 0xFFF;
+    return group >= 0 && group < kGroups && index < kGroupFunctions ? group * kGroupFunctions + index : -1;
+}
+
+// Open trace calls of this thread; ICU functions nest (ucol_open loads data)
+constexpr int kMaxDepth = 32;
+struct Frame {
+    int32_t  function;
+    uint64_t startNs;
+};
+thread_local Frame tFrames[kMaxDepth];
+thread_local int   tDepth = 0;
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void U_CALLCONV traceEntry(const void*, int32_t function) {
+    gAvailable.store(true, std::memory_order_relaxed);
+#if defined(ICUADDONS_HAS_USDT)
+    DTRACE_PROBE1(icu, entry, function);
+#endif
+    if (tDepth < kMaxDepth) {
+        tFrames[tDepth] = {function, nowNs()};
+    }
+    ++tDepth;
+}
+
+void U_CALLCONV traceExit(const void*, int32_t function, const char*, va_list) {
+    if (tDepth == 0) {
+        return;  // Tracing was installed inside this call
+    }
+    --tDepth;
+    if (tDepth >= kMaxDepth || tFrames[tDepth].function != function) {
+        return;
+    }
+    const uint64_t ns = nowNs() - tFrames[tDepth].startNs;
+#if defined(ICUADDONS_HAS_USDT)
+    DTRACE_PROBE2(icu, exit, function, ns);
+#endif
+    int32_t slot = slotOf(function);
+    if (slot >= 0) {
+        Slot& stats = gSlots[slot];
+        stats.calls.fetch_add(1, std::memory_order_relaxed);
+        stats.totalNs.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t slowest = stats.maxNs.load(std::memory_order_relaxed);
+        while (ns > slowest && !stats.maxNs.compare_exchange_weak(slowest, ns, std::memory_order_relaxed)) {
+        }
+    }
+    if (gHook != nullptr) {
+        gHook(gHookContext, function, ns);
+    }
+}
+
+void U_CALLCONV traceData(const void*, int32_t function, int32_t, const char* format, va_list args) {
+#if defined(ICUADDONS_HAS_USDT)
+    // File and resource names; only formatted for the probe
+    char text[256];
+    utrace_vformat(text, sizeof(text), 0, format, args);
+    DTRACE_PROBE2(icu, data, function, text);
+#else
+    (void)function;
+    (void)format;
+    (void)args;
+#endif
+}
+
+} // namespace
+
+void installTracing(const TraceOptions& options, UErrorCode& status) {
+    if (U_FAILURE(status)) {
+        return;
+    }
+    if (options.level < UTRACE_OPEN_CLOSE) {
+        status = U_ILLEGAL_ARGUMENT_ERROR;
+        return;
+    }
+    gHook        = options.hook;
+    gHookContext = options.hookContext;
+    utrace_setFunctions(nullptr, traceEntry, traceExit, traceData);
+    utrace_setLevel(options.level);
+    // u_init() is traced in every ICU built with tracing
+    UErrorCode initStatus = U_ZERO_ERROR;
+    u_init(&initStatus);
+}
+
+void uninstallTracing() {
+    utrace_setLevel(UTRACE_OFF);
+}
+
+bool tracingAvailable() {
+    return gAvailable.load(std::memory_order_relaxed);
+}
+
+std::vector<TraceStatistics> traceStatistics() {
+    std::vector<TraceStatistics> all;
+    for (int32_t slot = 0; slot < kSlots; ++slot) {
+        const Slot& stats = gSlots[slot];
+        uint64_t calls = stats.calls.load(std::memory_order_relaxed);
+        if (calls == 0) {
+            continue;
+        }
+        TraceStatistics entry;
+        entry.function = (slot / kGroupFunctions) << 12 | (slot % kGroupFunctions);
+        entry.name     = utrace_functionName(entry.function);
+        entry.calls    = calls;
+        entry.totalNs  = stats.totalNs.load(std::memory_order_relaxed);
+        entry.maxNs    = stats.maxNs.load(std::memory_order_relaxed);
+        all.push_back(entry);
+    }
+    return all;
+}
+
+void resetTraceStatistics() {
+    for (Slot& stats : gSlots) {
+        stats.calls.store(0, std::memory_order_relaxed);
+        stats.totalNs.store(0, std::memory_order_relaxed);
+        stats.maxNs.store(0, std::memory_order_relaxed);
+    }
+}
+
+} // namespace icuaddons
@@ -0,0 +1,250 @@
+#include "icuaddons/transcode.h"
+
+#include <cstring>
+#include <vector>
+
+namespace icuaddons {
+
+namespace {
+
+// Converters without shift state, where a byte below 0x80 between characters
+// is a character of its own (if the charset has it at all).
+bool stateless(UConverter* converter) {
+    switch (ucnv_getType(converter)) {
+    case UCNV_SBCS:
+    case UCNV_MBCS:
+    case UCNV_LATIN_1:
+    case UCNV_UTF8:
+    case UCNV_US_ASCII:
+        return true;
+    default:
+        return false;
+    }
+}
+
+struct CachedAsciiBytes {
+    std::string            from;  // Canonical names, ucnv_getName()
+    std::string            to;
+    Transcoder::AsciiBytes ascii;
+};
+
+// The pairs this thread has worked out; a Transcoder per record then costs
+// no conversion to find them again.
+thread_local std::vector<CachedAsciiBytes> cachedAsciiBytes;
+
+} // namespace
+
+Transcoder::Transcoder(const char* fromCharset, const char* toCharset, UErrorCode& status, ServicePool* pool) {
+    if (U_FAILURE(status)) {
+        return;
+    }
+    if (pool != nullptr) {
+        fromLease_ = pool->converter(fromCharset, status);
+        toLease_   = pool->converter(toCharset, status);
+        from_      = fromLease_.get();
+        to_        = toLease_.get();
+    } else {
+        owned_ = true;
+        from_  = ucnv_open(fromCharset, &status);
+        to_    = ucnv_open(toCharset, &status);
+    }
+    if (U_FAILURE(status)) {
+        return;
+    }
+    maxCharSize_ = static_cast<size_t>(ucnv_getMaxCharSize(to_));
+    if (!stateless(from_) || !stateless(to_)) {
+        return;
+    }
+    const char* fromName = ucnv_getName(from_, &status);
+    const char* toName   = ucnv_getName(to_, &status);
+    if (U_FAILURE(status)) {
+        return;
+    }
+    for (const auto& cached : cachedAsciiBytes) {
+        if (cached.from == fromName && cached.to == toName) {
+            ascii_ = cached.ascii;
+            return;
+        }
+    }
+    findAsciiBytes(ascii_);
+    cachedAsciiBytes.push_back({fromName, toName, ascii_});
+}
+
+Transcoder::~Transcoder() {
+    if (owned_) {
+        ucnv_close(from_);
+        ucnv_close(to_);
+    }
+}
+
+// Convert the 128 ASCII bytes through the pair: the ones that do not come
+// out as themselves are exceptions. Not transparent if too many are, or if a
+// byte does not make exactly one byte.
+void Transcoder::findAsciiBytes(AsciiBytes& ascii) {
+    char bytes[0x80];
+    for (int c = 0; c < 0x80; ++c) {
+        bytes[c] = static_cast<char>(c);
+    }
+    char        converted[0x80 * 4];
+    char*       target = converted;
+    const char* source = bytes;
+    UErrorCode  status = U_ZERO_ERROR;
+    ucnv_convertEx(to_, from_, &target, converted + sizeof(converted), &source, bytes + 0x80, pivot_, &pivotSource_,
+                   &pivotTarget_, pivot_ + kPivotUnits, true, true, &status);
+    reset();
+    ascii = AsciiBytes();
+    if (U_FAILURE(status) || target - converted != 0x80) {
+        return;
+    }
+    for (int c = 0; c < 0x80; ++c) {
+        ascii.copies[c] = converted[c] == bytes[c];
+        if (!ascii.copies[c]) {
+            if (ascii.exceptCount == kMaxAsciiExcept) {
+                return;
+            }
+            ascii.except[ascii.exceptCount++] = static_cast<unsigned char>(c);
+        }
+    }
+    ascii.transparent = true;
+}
+
+// Whether any of eight bytes cannot be copied: it has the high bit set or
+// equals an exception (a zero byte of word ^ exception, which the
+// (y - 0x01..) & ~y & 0x80.. test finds).
+bool Transcoder::stops(uint64_t word) const {
+    constexpr uint64_t kOnes = 0x0101010101010101u;
+    constexpr uint64_t kHigh = 0x8080808080808080u;
+    uint64_t stop = word & kHigh;
+    for (size_t i = 0; i < ascii_.exceptCount; ++i) {
+        const uint64_t y = word ^ (kOnes * ascii_.except[i]);
+        stop |= (y - kOnes) & ~y & kHigh;
+    }
+    return stop != 0;
+}
+
+// Length of the prefix of `bytes` that can be copied, eight bytes at a time.
+size_t Transcoder::asciiPrefix(const char* bytes, size_t length) const {
+    size_t n = 0;
+    for (uint64_t word; n + 8 <= length; n += 8) {
+        std::memcpy(&word, bytes + n, 8);
+        if (stops(word)) {
+            break;
+        }
+    }
+    while (n < length && copies(static_cast<unsigned char>(bytes[n]))) {
+        ++n;
+    }
+    return n;
+}
+
+// Start of the first run of kMinAsciiRun bytes that can be copied in
+// [begin, limit), or of the ones that end it, or limit. Bytes are only looked
+// at one by one at the end of a word that stops before one that does not.
+const char* Transcoder::nextAsciiRun(const char* begin, const char* limit) const {
+    const char* run = begin;  // Start of the bytes before p that can be copied; null if p - 1 cannot
+    const char* p   = begin;
+    for (uint64_t word; p + 8 <= limit; p += 8) {
+        std::memcpy(&word, p, 8);
+        if (stops(word)) {
+            run = nullptr;
+            continue;
+        }
+        if (run == nullptr) {
+            for (run = p; copies(static_cast<unsigned char>(run[-1])); --run) {
+            }
+        }
+        if (static_cast<size_t>(p + 8 - run) >= kMinAsciiRun) {
+            return run;
+        }
+    }
+    if (run == nullptr) {
+        for (run = p; copies(static_cast<unsigned char>(run[-1])); --run) {
+        }
+    }
+    for (; p < limit; ++p) {
+        if (!copies(static_cast<unsigned char>(*p))) {
+            run = p + 1;
+        } else if (static_cast<size_t>(p + 1 - run) >= kMinAsciiRun) {
+            return run;
+        }
+    }
+    return run;
+}
+
+bool Transcoder::atBoundary() const {
+    UErrorCode status = U_ZERO_ERROR;
+    return pivotSource_ == pivotTarget_ && ucnv_toUCountPending(from_, &status) == 0 &&
+           ucnv_fromUCountPending(to_, &status) == 0 && U_SUCCESS(status);
+}
+
+void Transcoder::transcodeChunk(const char* input, size_t length, bool flush, std::string& out, UErrorCode& status) {
+    if (U_FAILURE(status)) {
+        return;
+    }
+    if (from_ == nullptr || to_ == nullptr) {
+        status = U_INVALID_STATE_ERROR;
+        return;
+    }
+    const char* source = input;
+    const char* limit  = input + length;
+    while (U_SUCCESS(status)) {
+        if (ascii_.transparent && atBoundary()) {
+            const size_t run = asciiPrefix(source, static_cast<size_t>(limit - source));
+            if (run >= kMinAsciiRun || source + run == limit) {
+                out.append(source, run);
+                source += run;
+                counters_.asciiBytes += run;
+            }
+        }
+        if (source == limit && (!flush || atBoundary())) {
+            break;
+        }
+        // Up to the next ASCII run; at least one byte, so that a carried-over
+        // lead byte gets its trail bytes
+        const char* end = ascii_.transparent ? nextAsciiRun(source + (source < limit ? 1 : 0), limit) : limit;
+        convert(source, end, flush && end == limit, out, status);
+        counters_.convertedBytes += static_cast<size_t>(end - source);
+        source = end;
+        if (flush && end == limit) {
+            break;
+        }
+    }
+    if (flush) {
+        reset();
+    }
+}
+
+void Transcoder::convert(const char* begin, const char* end, bool flush, std::string& out, UErrorCode& status) {
+    // Each input byte makes at most one UTF-16 unit, except four-byte GB18030
+    // and UTF-8 sequences that make two; the loop grows the output if needed
+    size_t used     = out.size();
+    size_t capacity = static_cast<size_t>(end - begin) * maxCharSize_ + 16;
+    const char* source = begin;
+    for (;;) {
+        out.resize(used + capacity);
+        char* target = &out[used];
+        ucnv_convertEx(to_, from_, &target, &out[0] + out.size(), &source, end, pivot_, &pivotSource_,
+                       &pivotTarget_, pivot_ + kPivotUnits, false, flush, &status);
+        used = static_cast<size_t>(target - out.data());
+        if (status != U_BUFFER_OVERFLOW_ERROR) {
+            break;
+        }
+        status = U_ZERO_ERROR;  // Output full: grow it and continue
+        capacity *= 2;
+    }
+    out.resize(used);
+    if (status == U_STRING_NOT_TERMINATED_WARNING) {
+        status = U_ZERO_ERROR;
+    }
+}
+
+void Transcoder::reset() {
+    if (from_ != nullptr && to_ != nullptr) {
+        ucnv_reset(from_);
+        ucnv_reset(to_);
+    }
+    pivotSource_ = pivot_;
+    pivotTarget_ = pivot_;
+}
+
+} // namespace icuaddons
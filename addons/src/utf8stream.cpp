@@ -0,0 +1,256 @@
+#include "icuaddons/utf8stream.h"
+
+#include <fstream>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ICUADDONS_HAS_MMAP 1
+#endif
+
+namespace icuaddons {
+
+MappedFile::MappedFile(const std::string& path, UErrorCode& status) {
+    if (U_FAILURE(status)) {
+        return;
+    }
+#if defined(ICUADDONS_HAS_MMAP)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        status = U_FILE_ACCESS_ERROR;
+        return;
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    if (size_ > 0) {
+        void* address = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED) {
+            status = U_FILE_ACCESS_ERROR;
+            size_  = 0;
+        } else {
+            madvise(address, size_, MADV_SEQUENTIAL);
+            data_   = static_cast<const char*>(address);
+            mapped_ = true;
+        }
+    }
+    ::close(fd);
+#elif defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    LARGE_INTEGER fileSize;
+    if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize)) {
+        if (file != INVALID_HANDLE_VALUE) {
+            CloseHandle(file);
+        }
+        status = U_FILE_ACCESS_ERROR;
+        return;
+    }
+    size_ = static_cast<size_t>(fileSize.QuadPart);
+    if (size_ > 0) {
+        mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void* address = mapping_ != nullptr ? MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (address == nullptr) {
+            close();
+            status = U_FILE_ACCESS_ERROR;
+        } else {
+            data_   = static_cast<const char*>(address);
+            mapped_ = true;
+        }
+    }
+    CloseHandle(file);
+#else
+    // No file mapping (Emscripten's file systems live in memory already)
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        status = U_FILE_ACCESS_ERROR;
+        return;
+    }
+    size_ = static_cast<size_t>(file.tellg());
+    char* bytes = new char[size_ > 0 ? size_ : 1];
+    file.seekg(0);
+    if (!file.read(bytes, size_)) {
+        delete[] bytes;
+        size_  = 0;
+        status = U_FILE_ACCESS_ERROR;
+        return;
+    }
+    data_ = bytes;
+#endif
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      mapped_(std::exchange(other.mapped_, false)),
+      mapping_(std::exchange(other.mapping_, nullptr)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        data_    = std::exchange(other.data_, nullptr);
+        size_    = std::exchange(other.size_, 0);
+        mapped_  = std::exchange(other.mapped_, false);
+        mapping_ = std::exchange(other.mapping_, nullptr);
+    }
+    return *this;
+}
+
+void MappedFile::close() {
+    if (mapped_) {
+#if defined(ICUADDONS_HAS_MMAP)
+        munmap(const_cast<char*>(data_), size_);
+#elif defined(_WIN32)
+        UnmapViewOfFile(data_);
+#endif
+    } else {
+        delete[] data_;
+    }
+#if defined(_WIN32)
+    if (mapping_ != nullptr) {
+        CloseHandle(mapping_);
+    }
+#endif
+    data_    = nullptr;
+    size_    = 0;
+    mapped_  = false;
+    mapping_ = nullptr;
+}
+
+void MappedFile::release(size_t begin, size_t end) {
+#if defined(ICUADDONS_HAS_MMAP)
+    if (!mapped_ || end > size_ || begin >= end) {
+        return;
+    }
+    // Only whole pages inside the range; the mapping starts on a page boundary
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t first = (begin + page - 1) / page * page;
+    const size_t last  = end == size_ ? end : end / page * page;
+    if (first < last) {
+        madvise(const_cast<char*>(data_) + first, last - first, MADV_DONTNEED);
+    }
+#else
+    (void)begin;
+    (void)end;
+#endif
+}
+
+size_t nextWindow(const char* text, size_t begin, size_t length, size_t maxBytes) {
+    if (maxBytes > kMaxWindowBytes) {
+        maxBytes = kMaxWindowBytes;
+    }
+    if (length - begin <= maxBytes) {
+        return length;
+    }
+    const size_t limit = begin + maxBytes;
+    for (size_t end = limit; end > begin; --end) {
+        if (text[end - 1] == '\n') {
+            return end;
+        }
+    }
+    // No line in the window: do not cut a character (continuation bytes are 10xxxxxx)
+    size_t end = limit;
+    while (end > begin + 1 && (static_cast<uint8_t>(text[end]) & 0xC0) == 0x80) {
+        --end;
+    }
+    return end;
+}
+
+UTF8Segments::UTF8Segments(icu::BreakIterator& iterator, const char* text, size_t length, UErrorCode& status)
+    : iterator_(iterator) {
+    if (U_FAILURE(status)) {
+        return;
+    }
+    if (length > kMaxWindowBytes) {
+        status = U_INDEX_OUTOFBOUNDS_ERROR;
+        return;
+    }
+    utext_openUTF8(&text_, text, static_cast<int64_t>(length), &status);
+    iterator_.setText(&text_, status);
+    if (U_SUCCESS(status)) {
+        start_ = iterator_.first();
+        valid_ = true;
+    }
+}
+
+UTF8Segments::~UTF8Segments() {
+    utext_close(&text_);
+}
+
+bool UTF8Segments::next(size_t& begin, size_t& end) {
+    if (!valid_) {
+        return false;
+    }
+    // UTF-8 UText native indexes are byte offsets
+    int32_t limit = iterator_.next();
+    if (limit == icu::BreakIterator::DONE) {
+        valid_ = false;
+        return false;
+    }
+    begin  = static_cast<size_t>(start_);
+    end    = static_cast<size_t>(limit);
+    start_ = limit;
+    return true;
+}
+
+StreamTranscoder::StreamTranscoder(const char* fromCharset, const char* toCharset, UErrorCode& status) {
+    if (U_FAILURE(status)) {
+        return;
+    }
+    from_ = ucnv_open(fromCharset, &status);
+    to_   = ucnv_open(toCharset, &status);
+}
+
+StreamTranscoder::~StreamTranscoder() {
+    ucnv_close(from_);
+    ucnv_close(to_);
+}
+
+void StreamTranscoder::convert(const char* input, size_t length, bool flush, const Sink& sink, UErrorCode& status) {
+    if (U_FAILURE(status)) {
+        return;
+    }
+    const char* source      = input;
+    const char* sourceLimit = input + length;
+    while (true) {
+        char* target = output_;
+        ucnv_convertEx(to_, from_, &target, output_ + kOutputBytes, &source, sourceLimit,
+                       pivot_, &pivotSource_, &pivotTarget_, pivot_ + kPivotUnits,
+                       !started_, flush, &status);
+        started_ = true;
+        if (target > output_) {
+            sink(output_, static_cast<size_t>(target - output_));
+        }
+        if (status == U_BUFFER_OVERFLOW_ERROR) {
+            status = U_ZERO_ERROR;  // Output buffer full: handed to the sink, continue
+            continue;
+        }
+        if (status == U_STRING_NOT_TERMINATED_WARNING) {
+            status = U_ZERO_ERROR;
+        }
+        break;
+    }
+    if (flush) {
+        started_ = false;
+    }
+}
+
+void StreamTranscoder::reset() {
+    started_ = false;
+}
+
+} // namespace icuaddons
@@ -0,0 +1,379 @@
+#include "icuaddons/warmup.h"
+
+#include "icuaddons/servicepool.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+#include <unicode/brkiter.h>
+#include <unicode/coll.h>
+#include <unicode/locid.h>
+#include <unicode/normalizer2.h>
+#include <unicode/putil.h>
+#include <unicode/ucnv.h>
+#include <unicode/udata.h>
+#if !UCONFIG_NO_FORMATTING
+#include <unicode/datefmt.h>
+#include <unicode/numfmt.h>
+#endif
+#if !UCONFIG_NO_TRANSLITERATION
+#include <unicode/translit.h>
+#endif
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define ICUADDONS_HAS_PROC_MAPS 1
+#endif
+
+namespace icuaddons {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t elapsedNs(Clock::time_point start) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+const struct {
+    const char*   name;
+    WarmupService service;
+} kServiceNames[] = {
+    {"collator",        WarmupService::Collator},
+    {"character-break", WarmupService::CharacterBreak},
+    {"word-break",      WarmupService::WordBreak},
+    {"line-break",      WarmupService::LineBreak},
+    {"sentence-break",  WarmupService::SentenceBreak},
+    {"converter",       WarmupService::Converter},
+    {"normalizer",      WarmupService::Normalizer},
+    {"number-format",   WarmupService::NumberFormat},
+    {"date-format",     WarmupService::DateFormat},
+    {"transliterator",  WarmupService::Transliterator},
+};
+
+const icu::Normalizer2* normalizer(const std::string& name, UErrorCode& status) {
+    if (name == "nfc" || name == "nfd") {
+        return icu::Normalizer2::getInstance(nullptr, "nfc", name == "nfc" ? UNORM2_COMPOSE : UNORM2_DECOMPOSE, status);
+    }
+    if (name == "nfkc" || name == "nfkd") {
+        return icu::Normalizer2::getInstance(nullptr, "nfkc", name == "nfkc" ? UNORM2_COMPOSE : UNORM2_DECOMPOSE, status);
+    }
+    if (name == "nfkc_cf") {
+        return icu::Normalizer2::getInstance(nullptr, "nfkc_cf", UNORM2_COMPOSE, status);
+    }
+    status = U_ILLEGAL_ARGUMENT_ERROR;
+    return nullptr;
+}
+
+BreakType breakType(WarmupService service) {
+    switch (service) {
+    case WarmupService::CharacterBreak: return BreakType::Character;
+    case WarmupService::LineBreak:      return BreakType::Line;
+    case WarmupService::SentenceBreak:  return BreakType::Sentence;
+    default:                            return BreakType::Word;
+    }
+}
+
+icu::BreakIterator* createBreakIterator(BreakType type, const icu::Locale& locale, UErrorCode& status) {
+    switch (type) {
+    case BreakType::Character: return icu::BreakIterator::createCharacterInstance(locale, status);
+    case BreakType::Line:      return icu::BreakIterator::createLineInstance(locale, status);
+    case BreakType::Sentence:  return icu::BreakIterator::createSentenceInstance(locale, status);
+    case BreakType::Word:      break;
+    }
+    return icu::BreakIterator::createWordInstance(locale, status);
+}
+
+// Open the service of `entry` once and drop it; ICU's caches, or the pool, keep its data.
+void open(const WarmupEntry& entry, ServicePool* pool, UErrorCode& status) {
+    const icu::Locale locale(entry.argument.c_str());
+    switch (entry.service) {
+    case WarmupService::Collator:
+        if (pool != nullptr) {
+            pool->collator(locale, status);
+        } else {
+            delete icu::Collator::createInstance(locale, status);
+        }
+        break;
+    case WarmupService::CharacterBreak:
+    case WarmupService::WordBreak:
+    case WarmupService::LineBreak:
+    case WarmupService::SentenceBreak:
+        if (pool != nullptr) {
+            pool->breakIterator(breakType(entry.service), locale, status);
+        } else {
+            delete createBreakIterator(breakType(entry.service), locale, status);
+        }
+        break;
+    case WarmupService::Converter:
+        if (pool != nullptr) {
+            pool->converter(entry.argument.c_str(), status);
+        } else {
+            ucnv_close(ucnv_open(entry.argument.c_str(), &status));
+        }
+        break;
+    case WarmupService::Normalizer:
+        normalizer(entry.argument, status);
+        break;
+    case WarmupService::NumberFormat:
+#if UCONFIG_NO_FORMATTING
+        status = U_UNSUPPORTED_ERROR;
+#else
+        delete icu::NumberFormat::createInstance(locale, status);
+#endif
+        break;
+    case WarmupService::DateFormat:
+#if UCONFIG_NO_FORMATTING
+        status = U_UNSUPPORTED_ERROR;
+#else
+        {
+            std::unique_ptr<icu::DateFormat> format(
+                icu::DateFormat::createDateTimeInstance(icu::DateFormat::kMedium, icu::DateFormat::kMedium, locale));
+            if (format == nullptr && U_SUCCESS(status)) {
+                status = U_MISSING_RESOURCE_ERROR;
+            }
+        }
+#endif
+        break;
+    case WarmupService::Transliterator:
+#if UCONFIG_NO_TRANSLITERATION
+        status = U_UNSUPPORTED_ERROR;
+#else
+        if (pool != nullptr) {
+            pool->transliterator(icu::UnicodeString::fromUTF8(entry.argument), UTRANS_FORWARD, status);
+        } else {
+            delete icu::Transliterator::createInstance(icu::UnicodeString::fromUTF8(entry.argument), UTRANS_FORWARD,
+                                                       status);
+        }
+#endif
+        break;
+    }
+}
+
+// The memory region (mapping or image section) that contains `address`.
+bool regionOf(const void* address, char*& begin, size_t& size) {
+#if defined(ICUADDONS_HAS_PROC_MAPS)
+    std::ifstream maps("/proc/self/maps");
+    const auto target = reinterpret_cast<uintptr_t>(address);
+    std::string line;
+    while (std::getline(maps, line)) {
+        unsigned long long from = 0, to = 0;
+        if (std::sscanf(line.c_str(), "%llx-%llx", &from, &to) == 2 && target >= from && target < to) {
+            begin = reinterpret_cast<char*>(static_cast<uintptr_t>(from));
+            size  = static_cast<size_t>(to - from);
+            return true;
+        }
+    }
+    return false;
+#elif defined(_WIN32)
+    MEMORY_BASIC_INFORMATION info;
+    if (VirtualQuery(address, &info, sizeof(info)) == 0 || info.State != MEM_COMMIT) {
+        return false;
+    }
+    begin = static_cast<char*>(info.BaseAddress);
+    size  = info.RegionSize;
+    return true;
+#else
+    (void)address;
+    (void)begin;
+    (void)size;
+    return false;
+#endif
+}
+
+void touchPages(const char* begin, size_t size, size_t page) {
+    volatile char sink = 0;
+    for (size_t offset = 0; offset < size; offset += page) {
+        sink = sink + begin[offset];
+    }
+}
+
+void bringInData(DataPages pages, WarmupReport& report) {
+    UErrorCode status = U_ZERO_ERROR;
+    // Every data profile has the root bundle; keep it open so that a data
+    // directory of separate files keeps it mapped meanwhile
+    UDataMemory* root = udata_open(nullptr, "res", "root", &status);
+    char*  begin = nullptr;
+    size_t size  = 0;
+    if (U_FAILURE(status) || !regionOf(udata_getMemory(root), begin, size)) {
+        udata_close(root);
+        return;
+    }
+    report.dataBytes = size;
+
+#if defined(ICUADDONS_HAS_PROC_MAPS)
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    switch (pages) {
+    case DataPages::WillNeed:
+        madvise(begin, size, MADV_WILLNEED);
+        break;
+    case DataPages::Prefault:
+#if defined(MADV_POPULATE_READ)
+        if (madvise(begin, size, MADV_POPULATE_READ) == 0) {
+            break;
+        }
+#endif
+        touchPages(begin, size, page);
+        break;
+    case DataPages::Lock:
+        report.dataLocked = mlock(begin, size) == 0;
+        if (!report.dataLocked) {
+            touchPages(begin, size, page);
+        }
+        break;
+    case DataPages::Keep:
+        break;
+    }
+#elif defined(_WIN32)
+    SYSTEM_INFO system;
+    GetSystemInfo(&system);
+    touchPages(begin, size, system.dwPageSize);
+    if (pages == DataPages::Lock) {
+        report.dataLocked = VirtualLock(begin, size) != 0;
+    }
+#else
+    (void)pages;
+    (void)touchPages;
+#endif
+    udata_close(root);
+}
+
+} // namespace
+
+void parseWarmupManifest(const std::string& text, WarmupManifest& manifest, UErrorCode& status, size_t* errorLine) {
+    if (U_FAILURE(status)) {
+        return;
+    }
+    std::istringstream lines(text);
+    std::string line;
+    for (size_t number = 1; std::getline(lines, line); ++number) {
+        std::istringstream words(line.substr(0, line.find('#')));
+        std::string name, argument, extra;
+        if (!(words >> name)) {
+            continue;  // Blank or comment
+        }
+        const WarmupService* service = nullptr;
+        for (const auto& entry : kServiceNames) {
+            if (name == entry.name) {
+                service = &entry.service;
+            }
+        }
+        if (service == nullptr || !(words >> argument) || (words >> extra)) {
+            status = U_PARSE_ERROR;
+            if (errorLine != nullptr) {
+                *errorLine = number;
+            }
+            return;
+        }
+        manifest.entries.push_back({*service, argument});
+    }
+}
+
+const char* warmupServiceName(WarmupService service) {
+    for (const auto& entry : kServiceNames) {
+        if (entry.service == service) {
+            return entry.name;
+        }
+    }
+    return "";
+}
+
+void warmUp(const WarmupManifest& manifest, const WarmupOptions& options, WarmupReport& report, UErrorCode& status) {
+    report = WarmupReport();
+    if (U_FAILURE(status)) {
+        return;
+    }
+    const auto start = Clock::now();
+    if (options.dataPages != DataPages::Keep) {
+        bringInData(options.dataPages, report);
+        report.dataNs = elapsedNs(start);
+    }
+
+    for (const auto& entry : manifest.entries) {
+        WarmupTiming timing;
+        timing.entry = entry;
+        auto opened = Clock::now();
+        open(entry, options.pool, status);
+        timing.coldNs = elapsedNs(opened);
+        if (U_SUCCESS(status) && options.measure) {
+            opened = Clock::now();
+            open(entry, options.pool, status);
+            timing.warmNs = elapsedNs(opened);
+        }
+        if (U_FAILURE(status)) {
+            break;
+        }
+        report.services.push_back(timing);
+    }
+    report.totalNs = elapsedNs(start);
+}
+
+PreloadedData::~PreloadedData() {
+#if defined(ICUADDONS_HAS_PROC_MAPS)
+    if (mapping_ != nullptr) {
+        munmap(mapping_, mappingSize_);
+        return;
+    }
+#endif
+    delete[] data_;
+}
+
+void PreloadedData::load(const std::string& path, bool hugePages, UErrorCode& status) {
+    if (U_FAILURE(status)) {
+        return;
+    }
+    if (data_ != nullptr) {
+        status = U_INVALID_STATE_ERROR;
+        return;
+    }
+    const std::string file = path.empty() ? std::string(u_getDataDirectory()) + "/" U_ICUDATA_NAME ".dat" : path;
+    std::ifstream in(file, std::ios::binary | std::ios::ate);
+    if (!in) {
+        status = U_FILE_ACCESS_ERROR;
+        return;
+    }
+    size_ = static_cast<size_t>(in.tellg());
+    in.seekg(0);
+
+#if defined(ICUADDONS_HAS_PROC_MAPS)
+    // An anonymous mapping aligned to, and a multiple of, the huge page size
+    constexpr size_t kHugePage = size_t(2) << 20;
+    const size_t rounded = (size_ + kHugePage - 1) / kHugePage * kHugePage;
+    mappingSize_ = rounded + (hugePages ? kHugePage : 0);
+    mapping_     = mmap(nullptr, mappingSize_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping_ == MAP_FAILED) {
+        mapping_ = nullptr;
+        size_    = 0;
+        status   = U_MEMORY_ALLOCATION_ERROR;
+        return;
+    }
+    const auto base = reinterpret_cast<uintptr_t>(mapping_);
+    data_ = reinterpret_cast<char*>(hugePages ? (base + kHugePage - 1) / kHugePage * kHugePage : base);
+#if defined(MADV_HUGEPAGE)
+    hugePages_ = hugePages && madvise(data_, rounded, MADV_HUGEPAGE) == 0;
+#endif
+#else
+    (void)hugePages;
+    data_ = new char[size_ > 0 ? size_ : 1];
+#endif
+
+    if (!in.read(data_, static_cast<std::streamsize>(size_))) {
+        status = U_FILE_ACCESS_ERROR;
+        return;
+    }
+#if defined(ICUADDONS_HAS_PROC_MAPS)
+    mprotect(data_, rounded, PROT_READ);
+#endif
+    udata_setCommonData(data_, &status);
+}
+
+} // namespace icuaddons
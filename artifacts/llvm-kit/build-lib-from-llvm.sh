@@ -1,35 +1,267 @@
 #!/bin/bash
 
 # build-lib-from-llvm.sh
-# Compile LLVM IR (.ll) into .o and archive into .a static library
+# Compile the LLVM IR (.bc bitcode or .ll text) of the kit into static ICU libraries:
+#   lib/libicuuc.a   (common/)
+#   lib/libicui18n.a (i18n/)
+#   lib/libicuio.a   (io/)
+#   lib/libicudata.a (stubdata/: the data entry point libicuuc references; the
+#                     data itself is the shipped .dat file)
+#   lib/libicu-llvm.a (everything, as before)
+#
+# Objects are compiled in parallel and only when their IR (or the flags)
+# changed since the last run; a module shipped as both .bc and .ll is compiled
+# from the .bc. With --lto every library is first linked into
+# one module with llvm-link and optimized as a whole with opt, so code
+# generation sees across the translation units of the library. With --module
+# the kit's pre-linked, pre-optimized icu.bc is compiled into libicu-llvm.a.
 
 set -e
+set -o pipefail
 
-TARGET_TRIPLE=${1:-native}
+usage() {
+    echo "Usage: $0 [OPTIONS] [TARGET_TRIPLE] [LLVM_VERSION]"
+    echo ""
+    echo "  TARGET_TRIPLE        e.g. x86_64-linux-gnu, x86_64-w64-windows-gnu, wasm32 (default: native)"
+    echo "  LLVM_VERSION         Picks the IR from llvm-ir-LLVM_VERSION/ (default: llvm-ir/)"
+    echo ""
+    echo "Options:"
+    echo "  -j N, --jobs=N       Parallel compile jobs (default: number of cores)"
+    echo "  -O LEVEL, --opt=LEVEL  Optimization level: 0, 1, 2, 3, s or z (default: 2)"
+    echo "  --march=CPU          Generate code for CPU (e.g. x86-64-v3, native, armv8.2-a)"
+    echo "  --mtune=CPU          Tune the code for CPU"
+    echo "  --lto                Link each library into one module and optimize it as a whole before codegen"
+    echo "  --module             Compile the single pre-linked module icu.bc into libicu-llvm.a only"
+    echo "  --src=DIR            Directory with the common/, i18n/, io/ and stubdata/ IR (default: see LLVM_VERSION)"
+    echo "  --out=DIR            Output directory (default: lib-from-llvm)"
+    echo "  --clean              Remove the output directory first (full rebuild)"
+    echo ""
+    echo "Tools (environment): CLANG, LLVM_LINK, OPT, LLVM_AR (default: clang, llvm-link, opt, llvm-ar or ar)"
+}
+
+TARGET_TRIPLE=""
+LLVM_VERSION=""
+JOBS="$(nproc 2>/dev/null || sysctl -n hw.ncpu 2>/dev/null || echo 4)"
+OPT_LEVEL=2
+MARCH=""
+MTUNE=""
+LTO=false
+MODULE_ONLY=false
+CLEAN=false
+SRC_DIR=""
 OUTPUT_DIR=lib-from-llvm
-SRC_DIR=llvm-ir
-OBJ_DIR=$OUTPUT_DIR/obj
-LIB_DIR=$OUTPUT_DIR/lib
+
+while [[ $# -gt 0 ]]; do
+    case "$1" in
+        -j)         JOBS="$2"; shift ;;
+        -j*)        JOBS="${1#-j}" ;;
+        --jobs=*)   JOBS="${1#--jobs=}" ;;
+        -O)         OPT_LEVEL="$2"; shift ;;
+        -O*)        OPT_LEVEL="${1#-O}" ;;
+        --opt=*)    OPT_LEVEL="${1#--opt=}" ;;
+        --march=*)  MARCH="${1#--march=}" ;;
+        --mtune=*)  MTUNE="${1#--mtune=}" ;;
+        --lto)      LTO=true ;;
+        --module)   MODULE_ONLY=true ;;
+        --src=*)    SRC_DIR="${1#--src=}" ;;
+        --out=*)    OUTPUT_DIR="${1#--out=}" ;;
+        --clean)    CLEAN=true ;;
+        -h|--help)  usage; exit 0 ;;
+        -*)         echo "Unknown option: $1"; usage; exit 2 ;;
+        *)
+            if   [[ -z "$TARGET_TRIPLE" ]]; then TARGET_TRIPLE="$1"
+            elif [[ -z "$LLVM_VERSION"  ]]; then LLVM_VERSION="$1"
+            else echo "Unexpected argument: $1"; usage; exit 2
+            fi ;;
+    esac
+    shift
+done
+TARGET_TRIPLE="${TARGET_TRIPLE:-native}"
+
+case "$OPT_LEVEL" in
+    0|1|2|3|s|z) ;;
+    *) echo "Invalid optimization level: $OPT_LEVEL (expected 0, 1, 2, 3, s or z)"; exit 2 ;;
+esac
 
 print() {
     echo -e "\033[1;34m$1\033[0m"
 }
 
-print "🔍 Using LLVM IR from: $SRC_DIR"
+CLANG="${CLANG:-clang}"
+LLVM_LINK="${LLVM_LINK:-llvm-link}"
+OPT="${OPT:-opt}"
+if [[ -z "$LLVM_AR" ]]; then
+    LLVM_AR="$(command -v llvm-ar || command -v ar)"
+fi
+
+# The IR folder: --src, llvm-ir-VERSION/ or llvm-ir/, descending into a single
+# platform folder (llvm-ir-18/linux-x86_64-clang-18/common, ...)
+if [[ -z "$SRC_DIR" ]]; then
+    if [[ -n "$LLVM_VERSION" && -d "llvm-ir-$LLVM_VERSION" ]]; then
+        SRC_DIR="llvm-ir-$LLVM_VERSION"
+    else
+        SRC_DIR=llvm-ir
+    fi
+fi
+if [[ ! -d "$SRC_DIR/common" ]]; then
+    PLATFORM_DIRS=("$SRC_DIR"/*/common)
+    if [[ ${#PLATFORM_DIRS[@]} -eq 1 && -d "${PLATFORM_DIRS[0]}" ]]; then
+        SRC_DIR="$(dirname "${PLATFORM_DIRS[0]}")"
+    fi
+fi
+if [[ ! -d "$SRC_DIR" ]]; then
+    echo "❌ LLVM IR directory not found: $SRC_DIR"
+    exit 1
+fi
+
+OBJ_DIR=$OUTPUT_DIR/obj
+LIB_DIR=$OUTPUT_DIR/lib
+
+# Code generation flags; every object records them, so changing them rebuilds
+CODEGEN_FLAGS=(-O"$OPT_LEVEL")
+[[ "$TARGET_TRIPLE" != native ]] && CODEGEN_FLAGS+=(-target "$TARGET_TRIPLE")
+[[ -n "$MARCH" ]]                && CODEGEN_FLAGS+=(-march="$MARCH")
+[[ -n "$MTUNE" ]]                && CODEGEN_FLAGS+=(-mtune="$MTUNE")
+
+[[ "$CLEAN" == true ]] && rm -rf "$OUTPUT_DIR"
 mkdir -p "$OBJ_DIR" "$LIB_DIR"
 
-print "🛠️  Compiling .ll to .o for target: $TARGET_TRIPLE ..."
-find "$SRC_DIR" -name '*.ll' | while read -r f; do
-    rel_path="${f#$SRC_DIR/}"
-    out_dir="$OBJ_DIR/$(dirname "$rel_path")"
-    mkdir -p "$out_dir"
-    out_file="$out_dir/$(basename "$f" .ll).o"
-    clang -c -target "$TARGET_TRIPLE" "$f" -o "$out_file"
+STAMP="$OBJ_DIR/.flags"
+FLAGS_ID="lto=$LTO module=$MODULE_ONLY ${CODEGEN_FLAGS[*]} $($CLANG --version | head -n 1)"
+if [[ ! -f "$STAMP" || "$(cat "$STAMP")" != "$FLAGS_ID" ]]; then
+    print "🧹 New flags or compiler: compiling all objects"
+    find "$OBJ_DIR" \( -name '*.o' -o -name '*.bc' \) -delete
+    echo "$FLAGS_ID" > "$STAMP"
+fi
+
+print "🔍 Using LLVM IR from: $SRC_DIR"
+print "🛠️  Target: $TARGET_TRIPLE, flags: ${CODEGEN_FLAGS[*]}$([[ "$LTO" == true ]] && echo ", whole-library LTO"), $JOBS jobs"
+
+# Library of each top-level IR folder, named like the regular packages
+LIBRARIES=(common:icuuc i18n:icui18n io:icuio stubdata:icudata)
+LIBRARY_DIRS=()
+for ENTRY in "${LIBRARIES[@]}"; do
+    [[ -d "$SRC_DIR/${ENTRY%%:*}" ]] && LIBRARY_DIRS+=("$SRC_DIR/${ENTRY%%:*}")
 done
 
-print "📚 Creating static archive: libicu-llvm.a"
-ar rcs "$LIB_DIR/libicu-llvm.a" $(find "$OBJ_DIR" -name '*.o')
+# The IR modules under the given folders, NUL-separated: *.bc, and *.ll without a .bc twin
+ir_sources() {
+    find "$@" \( -name '*.bc' -o -name '*.ll' \) -print0 | sort -z | while IFS= read -r -d '' SOURCE; do
+        [[ "$SOURCE" == *.ll && -f "${SOURCE%.ll}.bc" ]] || printf '%s\0' "$SOURCE"
+    done
+}
+
+if [[ "$MODULE_ONLY" == true ]]; then
+    if [[ ! -f "$SRC_DIR/icu.bc" ]]; then
+        echo "❌ No pre-linked module in $SRC_DIR (icu.bc)"
+        exit 1
+    fi
+    if [[ ! "$OBJ_DIR/icu.o" -nt "$SRC_DIR/icu.bc" ]]; then
+        print "🛠️  Compiling icu.bc ..."
+        "$CLANG" -c "${CODEGEN_FLAGS[@]}" -Wno-override-module "$SRC_DIR/icu.bc" -o "$OBJ_DIR/icu.o.tmp"
+        mv "$OBJ_DIR/icu.o.tmp" "$OBJ_DIR/icu.o"
+    fi
+    rm -f "$LIB_DIR/libicu-llvm.a"
+    "$LLVM_AR" rcs "$LIB_DIR/libicu-llvm.a" "$OBJ_DIR/icu.o"
+    print "✅ Done!"
+    print "   → Static library: $LIB_DIR/libicu-llvm.a"
+    exit 0
+fi
+if [[ ${#LIBRARY_DIRS[@]} -eq 0 ]]; then
+    echo "❌ No common/, i18n/ or io/ IR in $SRC_DIR"
+    exit 1
+fi
+
+# IR emitted at -O0 marks every function optnone, which no -O level can undo
+SAMPLE_IR="$(find "${LIBRARY_DIRS[@]}" -name '*.ll' | head -n 1)"
+if [[ -n "$SAMPLE_IR" ]] && grep -q '\boptnone\b' "$SAMPLE_IR"; then
+    print "⚠️  The IR was generated at -O0 (optnone): it will not be optimized. Regenerate the kit with optimizable IR."
+fi
+
+compile_one() {
+    local SOURCE="$1"
+    local REL="${SOURCE#$SRC_DIR/}"
+    local OBJECT="$OBJ_DIR/${REL%.*}.o"
+    if [[ "$OBJECT" -nt "$SOURCE" ]]; then
+        return 0
+    fi
+    mkdir -p "$(dirname "$OBJECT")"
+    "$CLANG" -c "${CODEGEN_FLAGS[@]}" -Wno-override-module "$SOURCE" -o "$OBJECT.tmp"
+    mv "$OBJECT.tmp" "$OBJECT"
+    echo "$REL"
+}
+
+# llvm-link + opt + codegen of one library into a single object
+compile_library() {
+    local DIR="$1"
+    local MODULE="$OBJ_DIR/$DIR.lto"
+    local NEWER
+    NEWER="$(find "$SRC_DIR/$DIR" \( -name '*.bc' -o -name '*.ll' \) -newer "$MODULE.o" 2>/dev/null | head -n 1)"
+    if [[ -f "$MODULE.o" && -z "$NEWER" ]]; then
+        return 0
+    fi
+    local OPT_FLAGS=(-O"$OPT_LEVEL")
+    [[ "$TARGET_TRIPLE" != native ]] && OPT_FLAGS+=(-mtriple="$TARGET_TRIPLE")
+    [[ -n "$MARCH" && "$MARCH" != native ]] && OPT_FLAGS+=(-mcpu="$MARCH")
+    ir_sources "$SRC_DIR/$DIR" | xargs -0 "$LLVM_LINK" -o "$MODULE.bc"
+    "$OPT" "${OPT_FLAGS[@]}" "$MODULE.bc" -o "$MODULE.opt.bc"
+    "$CLANG" -c "${CODEGEN_FLAGS[@]}" -Wno-override-module "$MODULE.opt.bc" -o "$MODULE.o.tmp"
+    mv "$MODULE.o.tmp" "$MODULE.o"
+    rm -f "$MODULE.bc" "$MODULE.opt.bc"
+    echo "$DIR (whole library)"
+}
+
+export SRC_DIR OBJ_DIR OPT_LEVEL TARGET_TRIPLE MARCH CLANG LLVM_LINK OPT
+export -f compile_one compile_library ir_sources
+export CODEGEN_FLAGS_LIST="${CODEGEN_FLAGS[*]}"
+
+# The workers stop at their first failing command; xargs then exits non-zero
+# once all jobs are done, and nothing is archived
+if [[ "$LTO" == true ]]; then
+    print "🔗 Linking and optimizing each library as one module ..."
+    if ! printf '%s\0' "${LIBRARY_DIRS[@]#$SRC_DIR/}" \
+        | xargs -0 -r -n 1 -P "$JOBS" bash -e -o pipefail -c 'CODEGEN_FLAGS=($CODEGEN_FLAGS_LIST); compile_library "$1"' _ \
+        | sed 's/^/   /'; then
+        echo "❌ Building a library module failed"
+        exit 1
+    fi
+else
+    print "🛠️  Compiling IR to .o ..."
+    if ! ir_sources "${LIBRARY_DIRS[@]}" \
+        | xargs -0 -r -n 1 -P "$JOBS" bash -e -o pipefail -c 'CODEGEN_FLAGS=($CODEGEN_FLAGS_LIST); compile_one "$1"' _ \
+        | sed 's/^/   /'; then
+        echo "❌ Compiling the IR failed"
+        exit 1
+    fi
+
+    # Drop objects whose IR is gone, so they do not end up in the archives
+    find "$OBJ_DIR" -name '*.o' | while read -r OBJECT; do
+        REL="${OBJECT#$OBJ_DIR/}"
+        [[ -f "$SRC_DIR/${REL%.o}.bc" || -f "$SRC_DIR/${REL%.o}.ll" ]] || rm -f "$OBJECT"
+    done
+fi
+
+archive() {
+    local ARCHIVE="$1"; shift
+    rm -f "$ARCHIVE"
+    "$LLVM_AR" rcs "$ARCHIVE" "$@"
+}
+
+print "📚 Creating static archives ..."
+for ENTRY in "${LIBRARIES[@]}"; do
+    DIR="${ENTRY%%:*}"; NAME="${ENTRY##*:}"
+    if [[ "$LTO" == true && -f "$OBJ_DIR/$DIR.lto.o" ]]; then
+        archive "$LIB_DIR/lib$NAME.a" "$OBJ_DIR/$DIR.lto.o"
+    elif [[ -d "$OBJ_DIR/$DIR" ]]; then
+        archive "$LIB_DIR/lib$NAME.a" $(find "$OBJ_DIR/$DIR" -name '*.o' | sort)
+    else
+        continue
+    fi
+    print "   → $LIB_DIR/lib$NAME.a"
+done
+# Switching --lto changes the flags, so per-file and whole-library objects never mix
+archive "$LIB_DIR/libicu-llvm.a" $(find "$OBJ_DIR" -name '*.o' | sort)
 
 print "✅ Done!"
-print "   → Static library: $LIB_DIR/libicu-llvm.a"
-print "   → Objects in:     $OBJ_DIR"
+print "   → Static libraries: $LIB_DIR/libicuuc.a, libicui18n.a, libicuio.a, libicudata.a (all in one: libicu-llvm.a)"
+print "   → Objects in:       $OBJ_DIR"
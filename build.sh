@@ -16,7 +16,35 @@ if [[ "$1" == "--help" ]]; then
   echo "  --quick                      Only build for Linux using Clang"
   echo "  --ignore-compiler-version    Skip compiler version checks"
   echo "  --dry-run                    Show what would be built, but do not execute any build commands"
+  echo "  --variant=NAME[,NAME...]     Also build optional package variants (repeatable)"
+  echo "  --data-profile=NAME[,NAME...] Also build data-only packages with filtered ICU data (repeatable)"
+  echo "  --serial                     Build one target at a time"
+  echo "  --no-cache                   Do not use ccache/sccache"
   echo "  --help                       Show this help message"
+  echo ""
+  echo "Variants:"
+  echo "  pgo                          linux-x86-64 libraries optimized with profile-guided optimization"
+  echo "  thinlto                      linux-x86-64 archives of LLVM bitcode for cross-library ThinLTO inlining"
+  echo "  static-data                  linux-x86-64 with the ICU data linked into libicudata.a (no .dat file)"
+  echo "  x86-64-v2                    linux-x86-64 for x86-64-v2 CPUs (SSE4.2, POPCNT)"
+  echo "  x86-64-v3                    linux-x86-64 for x86-64-v3 CPUs (AVX2, BMI2, FMA)"
+  echo "  x86-64-v4                    linux-x86-64 for x86-64-v4 CPUs (AVX-512)"
+  echo "  tsan                         linux-x86-64 instrumented with ThreadSanitizer (see test/run-tsan.sh)"
+  echo "  profiling                    linux-x86-64 with frame pointers, ICU tracing and a separate debug info zip"
+  echo "  size                         linux-x86-64 built with -Os and section GC (see test/compare-sizes.sh)"
+  echo "  size-text                    size, with formatting, transliteration, regex, IDNA and legacy charsets compiled out"
+  echo "  wasm-simd                    wasm-32 with WASM SIMD, pthreads and the ICU data linked in (see test/compare-wasm.sh)"
+  echo "  data-split                   Each data profile (default: full) as one file per item, for lazy loading"
+  echo ""
+  echo "Data profiles (data-filters/NAME.json, or ICU_DATA_FILTER_FILE for a custom filter):"
+  echo "  full                         The complete prebuilt ICU data"
+  echo "  minimal-normalization        Normalization and character properties only"
+  echo "  western-locales              en/fr/de/es/it/pt/nl with collation, break iteration and normalization"
+  echo ""
+  echo "Environment:"
+  echo "  BUILD_JOBS=N                 Compile jobs shared by all targets (default: nproc)"
+  echo "  MAX_PARALLEL_TARGETS=N       Targets built at the same time (default: 4)"
+  echo "  BUILD_CACHE=auto|ccache|sccache|none  Compiler cache (default: auto, ccache if installed)"
   exit 0
 fi
 
@@ -29,15 +57,42 @@ DRY_RUN=false
 QUICK_BUILD=false
 UNAME_S=""
 UNAME_M=""
+VARIANTS=()
+DATA_PROFILES=()
 for arg in "$@"; do
   case "$arg" in
     --ignore-compiler-version) IGNORE_COMPILER_VERSION=1 ;;
     --quick)                   QUICK_BUILD=true          ;;
     --prepare-only)            PREPARE_ONLY=1            ;;
     --dry-run)                 DRY_RUN=true              ;;
+    --serial)                  MAX_PARALLEL_TARGETS=1    ;;
+    --no-cache)                BUILD_CACHE=none          ;;
+    --variant=*)               IFS=',' read -r -a _VARIANT_LIST <<< "${arg#--variant=}"
+                               VARIANTS+=("${_VARIANT_LIST[@]}") ;;
+    --data-profile=*)          IFS=',' read -r -a _PROFILE_LIST <<< "${arg#--data-profile=}"
+                               DATA_PROFILES+=("${_PROFILE_LIST[@]}") ;;
   esac
 done
 
+BUILD_JOBS=${BUILD_JOBS:-$(nproc)}
+MAX_PARALLEL_TARGETS=${MAX_PARALLEL_TARGETS:-4}
+BUILD_CACHE=${BUILD_CACHE:-auto}
+
+# A custom ICU_DATA_FILTER_FILE becomes its own data profile; keep it away from the regular builds
+CUSTOM_DATA_FILTER=""
+if [[ -n "$ICU_DATA_FILTER_FILE" ]]; then
+  CUSTOM_DATA_FILTER="$(realpath "$ICU_DATA_FILTER_FILE")"
+  unset ICU_DATA_FILTER_FILE
+fi
+
+has_variant() {
+  local VARIANT
+  for VARIANT in "${VARIANTS[@]}"; do
+    [[ "$VARIANT" == "$1" ]] && return 0
+  done
+  return 1
+}
+
 
 # Disallow quick build on non-Linux
 UNAME_S=$(uname -s)
@@ -59,6 +114,8 @@ print_section "Build starts -- configurations"
 print "CLANG_VERSION: $CLANG_VERSION"
 print "ICU_VERSION:   $ICU_VERSION"
 print "ENSDK_VERSION: $ENSDK_VERSION"
+print "VARIANTS:      ${VARIANTS[*]:-none}"
+print "DATA_PROFILES: ${DATA_PROFILES[*]:-none}${CUSTOM_DATA_FILTER:+ (custom filter: $CUSTOM_DATA_FILTER)}"
 print "WORKDIR: $WORKDIR"
 print "DISTDIR: $DISTDIR"
 print "BUILDLOG: $BUILDLOG"
@@ -124,15 +181,33 @@ build_icu() {
   BUILD_DIR="$WORKDIR/build-$TARGET"
   INSTALL_DIR="$DISTDIR/$TARGET"
 
+  # Compiler cache (see setup_build_cache); emcc runs its clang through EM_COMPILER_WRAPPER
+  if [[ -n "$CACHE_LAUNCHER" ]]; then
+    if [[ "$CC" == em* ]]; then
+      export EM_COMPILER_WRAPPER="$CACHE_LAUNCHER"
+    else
+      CC="$CACHE_LAUNCHER $CC"
+      CXX="$CACHE_LAUNCHER $CXX"
+    fi
+  fi
+
   rm    -rf "$BUILD_DIR" "$INSTALL_DIR"
   mkdir -p  "$BUILD_DIR" "$INSTALL_DIR/bin" "$INSTALL_DIR/lib" "$INSTALL_DIR/include"
   cd "$BUILD_DIR"
 
   ICU_SOURCE="$WORKDIR/icu/source"
   local ENABLE_TOOLS="--disable-tools"
-  [[ "$TARGET" == "$LINUX_CLANG_TARGET_32" || "$TARGET" == "$LINUX_CLANG_TARGET_64" ]] \
+  [[ "$TARGET" == "$LINUX_CLANG_TARGET_32"* || "$TARGET" == "$LINUX_CLANG_TARGET_64"* ]] \
       && ENABLE_TOOLS="--enable-tools"
 
+  # PACKAGE_UCONFIG: ICU services compiled out (UCONFIG_NO_FORMATTING ...). ICU's tools need
+  # them, so these builds take the tools of the generic build (--with-cross-build).
+  local UCONFIG_CPPFLAGS="" SWITCH
+  for SWITCH in ${PACKAGE_UCONFIG:-}; do
+    UCONFIG_CPPFLAGS+=" -D$SWITCH=1"
+  done
+  [[ -n "$UCONFIG_CPPFLAGS" ]] && ENABLE_TOOLS="--disable-tools"
+
   CROSS_COMPILE_DIR="${EXTRA_FLAGS#--with-cross-build=}"
   if [[ "$CROSS_COMPILE_DIR" != "" && -d "$CROSS_COMPILE_DIR/bin" ]]; then
     # In the pipeline, the permission can be altered to be un-executable. This should fix it.
@@ -140,25 +215,32 @@ build_icu() {
     chmod 755 "$CROSS_COMPILE_DIR/bin"/* || true
   fi
 
+  # archive: share/icu/<version>/icudt*.dat, static: data object inside libicudata.a
+  local DATA_PACKAGING_MODE="${DATA_PACKAGING:-archive}"
+
   PKG_CONFIG_LIBDIR=                                \
   CC="$CC" CXX="$CXX" AR="$AR" RANLIB="$RANLIB"     \
   CFLAGS="$EXTRA_CFLAGS" CXXFLAGS="$EXTRA_CXXFLAGS" \
+  CPPFLAGS="$UCONFIG_CPPFLAGS"                      \
+  LDFLAGS="${EXTRA_LDFLAGS:-}"                      \
   "$ICU_SOURCE/configure"                           \
     --prefix="$INSTALL_DIR"                         \
     --host="$HOST"                                  \
     --enable-static                                 \
     --disable-shared                                \
-    --with-data-packaging=archive                   \
+    --with-data-packaging=$DATA_PACKAGING_MODE      \
     --disable-extras                                \
     --disable-tests                                 \
     --disable-samples                               \
     $ENABLE_TOOLS                                   \
     $EXTRA_FLAGS                                    \
+    ${PACKAGE_CONFIGURE_FLAGS:-}                    \
     >> "$BUILDLOG" 2>&1
     
 
-  make -j$(nproc) >> "$BUILDLOG" 2>&1
-  make install    >> "$BUILDLOG" 2>&1
+  # -j comes from the shared jobserver in MAKEFLAGS (see run_jobs)
+  make         >> "$BUILDLOG" 2>&1
+  make install >> "$BUILDLOG" 2>&1
 
   # Copy ICU headers to the install directory
   print "📋 Copying ICU headers to package..."
@@ -176,37 +258,98 @@ build_icu() {
   header_count=$(find "$INSTALL_DIR/include/unicode" -name "*.h" | wc -l)
   print "  - Copied $header_count header files"
 
+  # Programs must see the same switches as the libraries: record them in uconfig.h
+  if [[ -n "$UCONFIG_CPPFLAGS" ]]; then
+    print "  - Compiled out: ${PACKAGE_UCONFIG}"
+    UCONFIG_DEFINES="\\n/* Compiled out by build.sh for $TARGET */"
+    for SWITCH in $PACKAGE_UCONFIG; do
+      UCONFIG_DEFINES+="\\n#define $SWITCH 1"
+    done
+    sed -i "s|^#define __UCONFIG_H__\$|&\\n$UCONFIG_DEFINES|" "$INSTALL_DIR/include/unicode/uconfig.h"
+  fi
+
+  # Build the addons (addons/: allocation hooks, ...) with the same compiler and flags as ICU
+  print "📋 Building ICU addons..."
+  mkdir -p "$BUILD_DIR/addons" "$INSTALL_DIR/include/icuaddons"
+  cp "$SCRIPT_DIR/addons/include/icuaddons/"*.h "$INSTALL_DIR/include/icuaddons/"
+  for ADDON_SOURCE in "$SCRIPT_DIR/addons/src/"*.cpp; do
+    $CXX $EXTRA_CXXFLAGS -std=c++17 -DU_STATIC_IMPLEMENTATION -I"$INSTALL_DIR/include" \
+      -c "$ADDON_SOURCE" -o "$BUILD_DIR/addons/$(basename "$ADDON_SOURCE" .cpp).o" >> "$BUILDLOG" 2>&1
+  done
+  $AR rcs "$INSTALL_DIR/lib/libicuaddons.a" "$BUILD_DIR/addons/"*.o >> "$BUILDLOG" 2>&1
+  $RANLIB "$INSTALL_DIR/lib/libicuaddons.a"                         >> "$BUILDLOG" 2>&1
+
+  # Ship the CMake link helper together with the compile/link options this variant requires
+  print "📋 Adding CMake link helper..."
+  mkdir -p "$INSTALL_DIR/lib/cmake/icu"
+  cp "$SCRIPT_DIR/cmake/icu-link.cmake" "$SCRIPT_DIR/cmake/icu-select.cmake" "$INSTALL_DIR/lib/cmake/icu/"
+  cat > "$INSTALL_DIR/lib/cmake/icu/icu-package.cmake" << EOF
+# Generated by build.sh for $TARGET
+set(ICU_PACKAGE_TARGET          "$TARGET")
+set(ICU_PACKAGE_VERSION         "$ICU_VERSION")
+set(ICU_PACKAGE_COMPILE_OPTIONS "${PACKAGE_COMPILE_OPTIONS:-}")
+set(ICU_PACKAGE_LINK_OPTIONS    "${PACKAGE_LINK_OPTIONS:-}")
+set(ICU_PACKAGE_REQUIRES_CLANG  ${PACKAGE_REQUIRES_CLANG:-OFF})
+set(ICU_PACKAGE_DATA_PACKAGING  "$DATA_PACKAGING_MODE")
+set(ICU_PACKAGE_X86_64_LEVEL    "${PACKAGE_X86_64_LEVEL:-}")
+set(ICU_PACKAGE_UCONFIG         "${PACKAGE_UCONFIG:-}")
+EOF
+
+  # PACKAGE_DEBUGINFO_ZIP: the libraries with their DWARF go to a zip of their own, with a map
+  # of the ICU object (source file) that defines every symbol; the package keeps the symbols
+  if [[ -n "${PACKAGE_DEBUGINFO_ZIP:-}" ]]; then
+    print "📋 Splitting debug info into $(basename "$PACKAGE_DEBUGINFO_ZIP")..."
+    DEBUGINFO_DIR="$BUILD_DIR/debuginfo"
+    rm -rf "$DEBUGINFO_DIR"
+    mkdir -p "$DEBUGINFO_DIR/lib"
+    cp "$INSTALL_DIR/lib/"*.a "$DEBUGINFO_DIR/lib/"
+    llvm-nm --defined-only --print-file-name --demangle "$DEBUGINFO_DIR/lib/"*.a 2>> "$BUILDLOG" \
+      | sed "s|^$DEBUGINFO_DIR/lib/||" > "$DEBUGINFO_DIR/symbols.txt"
+    for LIBRARY in "$INSTALL_DIR/lib/"*.a; do
+      llvm-objcopy --strip-debug "$LIBRARY" >> "$BUILDLOG" 2>&1
+    done
+    rm -f "$PACKAGE_DEBUGINFO_ZIP"
+    (cd "$DEBUGINFO_DIR" && zip -r "$PACKAGE_DEBUGINFO_ZIP" ./) >> "$BUILDLOG" 2>&1
+    print "✅ Created $PACKAGE_DEBUGINFO_ZIP"
+  fi
+
   # Verify and handle the ICU data file
   print "📦 Verifying ICU data file..."
   
   # Check for the data file in various possible locations
   ICU_DATA_FILE=""
   
-  # Check in the standard location first
-  STANDARD_DATA_PATH="$INSTALL_DIR/share/icu/$ICU_VERSION/icudt${ICU_VERSION%%.*}l.dat"
-  if [[ -f "$STANDARD_DATA_PATH" ]]; then
-    ICU_DATA_FILE="$STANDARD_DATA_PATH"
-    print "  ✅ Found ICU data file at standard location: $ICU_DATA_FILE"
+  if [[ "$DATA_PACKAGING_MODE" == "static" ]]; then
+    # The data is a read-only object inside libicudata.a; there is no .dat file to ship
+    DATA_SIZE=$(du -h "$INSTALL_DIR/lib/libicudata.a" | cut -f1)
+    print "  ✅ ICU data linked into libicudata.a ($DATA_SIZE)"
   else
-    # Try to find it in the build directory
-    BUILD_DATA_FILE=$(find "$BUILD_DIR" -name "*.dat" | head -n 1)
-    if [[ -n "$BUILD_DATA_FILE" ]]; then
-      # Create the share directory structure
-      mkdir -p "$INSTALL_DIR/share/icu/$ICU_VERSION"
-      # Copy the data file to the standard location
-      mv "$BUILD_DATA_FILE" "$STANDARD_DATA_PATH"
+    # Check in the standard location first
+    STANDARD_DATA_PATH="$INSTALL_DIR/share/icu/$ICU_VERSION/icudt${ICU_VERSION%%.*}l.dat"
+    if [[ -f "$STANDARD_DATA_PATH" ]]; then
       ICU_DATA_FILE="$STANDARD_DATA_PATH"
-      print "  ✅ Copied ICU data file from build directory to: $ICU_DATA_FILE"
+      print "  ✅ Found ICU data file at standard location: $ICU_DATA_FILE"
     else
-      print "  ✅ No ICU data file found! Copy from source."
-      cp "$ICU_SOURCE/data/in/icudt${ICU_VERSION%%.*}l.dat" "$STANDARD_DATA_PATH"
+      # Try to find it in the build directory
+      BUILD_DATA_FILE=$(find "$BUILD_DIR" -name "*.dat" | head -n 1)
+      if [[ -n "$BUILD_DATA_FILE" ]]; then
+        # Create the share directory structure
+        mkdir -p "$INSTALL_DIR/share/icu/$ICU_VERSION"
+        # Copy the data file to the standard location
+        mv "$BUILD_DATA_FILE" "$STANDARD_DATA_PATH"
+        ICU_DATA_FILE="$STANDARD_DATA_PATH"
+        print "  ✅ Copied ICU data file from build directory to: $ICU_DATA_FILE"
+      else
+        print "  ✅ No ICU data file found! Copy from source."
+        cp "$ICU_SOURCE/data/in/icudt${ICU_VERSION%%.*}l.dat" "$STANDARD_DATA_PATH"
+      fi
     fi
-  fi
 
-  # If we found a data file, check its size
-  if [[ -n "$ICU_DATA_FILE" ]]; then
-    DATA_SIZE=$(du -h "$ICU_DATA_FILE" | cut -f1)
-    print "  - Data file size: $DATA_SIZE"
+    # If we found a data file, check its size
+    if [[ -n "$ICU_DATA_FILE" ]]; then
+      DATA_SIZE=$(du -h "$ICU_DATA_FILE" | cut -f1)
+      print "  - Data file size: $DATA_SIZE"
+    fi
   fi
 
   # Create the zip file from the install directory
@@ -219,10 +362,414 @@ build_icu() {
 }
 
 
-show-build-matrix
+# Compiler cache for all builds: ccache or sccache, whichever BUILD_CACHE selects. The cache
+# directory is per ICU version and every entry is keyed on the full compiler command line,
+# so a flag change only recompiles the targets that use it, and reverting it hits the cache.
+setup_build_cache() {
+  CACHE_LAUNCHER=""
+  case "$BUILD_CACHE" in
+    none)
+      ;;
+    auto)
+      if   command -v ccache  > /dev/null; then CACHE_LAUNCHER=ccache
+      elif command -v sccache > /dev/null; then CACHE_LAUNCHER=sccache
+      fi ;;
+    ccache|sccache)
+      command -v "$BUILD_CACHE" > /dev/null || exit_with_error "BUILD_CACHE=$BUILD_CACHE but $BUILD_CACHE is not installed."
+      CACHE_LAUNCHER="$BUILD_CACHE" ;;
+    *)
+      exit_with_error "Unknown BUILD_CACHE: $BUILD_CACHE (expected auto, ccache, sccache or none)" ;;
+  esac
+
+  case "$CACHE_LAUNCHER" in
+    ccache)
+      export CCACHE_DIR="${CCACHE_DIR:-$WORKDIR/ccache/icu-$ICU_VERSION}"
+      # Each target builds in its own directory; relative paths let them share entries
+      export CCACHE_BASEDIR="$WORKDIR"
+      export CCACHE_NOHASHDIR=true ;;
+    sccache)
+      export SCCACHE_DIR="${SCCACHE_DIR:-$WORKDIR/sccache/icu-$ICU_VERSION}" ;;
+  esac
+  print "BUILD_CACHE: ${CACHE_LAUNCHER:-none}${CCACHE_DIR:+ ($CCACHE_DIR)}${SCCACHE_DIR:+ ($SCCACHE_DIR)}"
+}
+
+# Write a CMake toolchain for building programs from test/ against the static ICU in $2.
+# The libraries are linked in dependency order (io -> i18n -> uc -> data).
+write_icu_toolchain() {
+  TOOLCHAIN_FILE="$1"; ICU_ROOT_DIR="$2"; TOOLCHAIN_CXXFLAGS="$3"; TOOLCHAIN_LDFLAGS="$4"
+  cat > "$TOOLCHAIN_FILE" << EOF
+set(CMAKE_C_COMPILER   "clang")
+set(CMAKE_CXX_COMPILER "clang++")
+set(CMAKE_C_FLAGS          "\${CMAKE_C_FLAGS} $TOOLCHAIN_CXXFLAGS")
+set(CMAKE_CXX_FLAGS        "\${CMAKE_CXX_FLAGS} $TOOLCHAIN_CXXFLAGS")
+set(CMAKE_EXE_LINKER_FLAGS "\${CMAKE_EXE_LINKER_FLAGS} $TOOLCHAIN_LDFLAGS")
+
+set(BUILD_SHARED_LIBS OFF CACHE BOOL "Build shared libraries" FORCE)
+
+function(target_link_icu TARGET)
+  target_compile_definitions(\${TARGET} PRIVATE U_STATIC_IMPLEMENTATION)
+  target_link_libraries(\${TARGET}
+    $ICU_ROOT_DIR/lib/libicuio.a
+    $ICU_ROOT_DIR/lib/libicui18n.a
+    $ICU_ROOT_DIR/lib/libicuuc.a
+    $ICU_ROOT_DIR/lib/libicudata.a
+    pthread dl m)
+endfunction()
+EOF
+}
+
+# Build icu_test and icu_benchmark from test/ against the ICU installed in $1.
+build_test_programs() {
+  ICU_ROOT_DIR="$1"; PROGRAM_DIR="$2"; PROGRAM_CXXFLAGS="$3"; PROGRAM_LDFLAGS="$4"
+  rm -rf   "$PROGRAM_DIR"
+  mkdir -p "$PROGRAM_DIR"
+  write_icu_toolchain "$PROGRAM_DIR/toolchain.cmake" "$ICU_ROOT_DIR" "$PROGRAM_CXXFLAGS" "$PROGRAM_LDFLAGS"
+  cmake -S "$SCRIPT_DIR/test" -B "$PROGRAM_DIR/build"                     \
+        -DCMAKE_TOOLCHAIN_FILE="$PROGRAM_DIR/toolchain.cmake"             \
+        -DCMAKE_BUILD_TYPE=Release                                        \
+        -DICU_ROOT="$ICU_ROOT_DIR"                                        \
+        -DICU_DATA_DIR="$ICU_ROOT_DIR/share/icu/$ICU_VERSION"             \
+        >> "$BUILDLOG" 2>&1
+  cmake --build "$PROGRAM_DIR/build" >> "$BUILDLOG" 2>&1
+}
+
+# Profile-guided build of linux-x86-64:
+#   1. build instrumented libraries,
+#   2. train them with icu_test and icu_benchmark (the API calls of test.cpp, scaled up over the benchmark corpora),
+#   3. merge the raw profiles with llvm-profdata,
+#   4. rebuild with -fprofile-use and package as a separate zip.
+build_icu_pgo() {
+  TOOLS="clang-${CLANG_VERSION}"
+  PGO_DIR="$WORKDIR/pgo"
+  PROFILE_DIR="$PGO_DIR/profiles"
+  PROFDATA="$PGO_DIR/icu.profdata"
+  INSTRUMENTED_TARGET="$LINUX_CLANG_TARGET_64-pgo-instrumented"
+  PGO_TARGET="$LINUX_CLANG_TARGET_64-pgo"
+  PGO_ZIP_FILE="$DISTDIR/icu4c-${ICU_VERSION}_${PGO_TARGET}_${TOOLS}.zip"
+  PGO_TRAINING_SCALE=${PGO_TRAINING_SCALE:-4}
+  PGO_TRAINING_TIME=${PGO_TRAINING_TIME:-0.5}
+  # The icu_benchmark suites that exercise ICU's own APIs the way applications
+  # call them. The others time process startup, allocators, threads or the
+  # addons and would skew the profile; keep this in sync with the suite table
+  # in test/bench/main.cpp.
+  PGO_TRAINING_SUITES=${PGO_TRAINING_SUITES:-calls,collation,segmentation,normalization,conversion,transliteration,formatting,search}
+
+  print_section "PGO build for $LINUX_CLANG_TARGET_64"
+  if [[ "$DRY_RUN" == true ]]; then
+    echo "[DRY RUN] Would build $INSTRUMENTED_TARGET, train it with $SCRIPT_DIR/test (suites=$PGO_TRAINING_SUITES, scale=$PGO_TRAINING_SCALE), merge profiles into $PROFDATA and package $PGO_ZIP_FILE"
+    return 0
+  fi
+
+  rm -rf   "$PGO_DIR"
+  mkdir -p "$PROFILE_DIR"
+
+  # ICU runs its own tools during the build; their profiles would skew the training, so they go to a discard directory.
+  LLVM_PROFILE_FILE="$PGO_DIR/discard/%p.profraw" \
+  EXTRA_LDFLAGS="-fprofile-generate"              \
+  build_icu                          \
+    "$INSTRUMENTED_TARGET"           \
+    ""                               \
+    clang                            \
+    clang++                          \
+    llvm-ar                          \
+    llvm-ranlib                      \
+    ""                               \
+    "-O2 -fprofile-generate"         \
+    "-O2 -fprofile-generate"         \
+    "$PGO_DIR/instrumented.zip"
+
+  print "🏋️ Training instrumented ICU..."
+  INSTRUMENTED_DIR="$DISTDIR/$INSTRUMENTED_TARGET"
+  build_test_programs "$INSTRUMENTED_DIR" "$PGO_DIR/training" "-O2" "-fprofile-generate"
+  export ICU_DATA="$INSTRUMENTED_DIR/share/icu/$ICU_VERSION"
+  LLVM_PROFILE_FILE="$PROFILE_DIR/icu_test-%p.profraw"      \
+    "$PGO_DIR/training/build/icu_test" "$INSTRUMENTED_DIR"    >> "$BUILDLOG" 2>&1
+  LLVM_PROFILE_FILE="$PROFILE_DIR/icu_benchmark-%p.profraw" \
+    "$PGO_DIR/training/build/icu_benchmark"                   \
+      --suite    "$PGO_TRAINING_SUITES"                       \
+      --scale    "$PGO_TRAINING_SCALE"                        \
+      --min-time "$PGO_TRAINING_TIME"                         >> "$BUILDLOG" 2>&1
+  unset ICU_DATA
+
+  llvm-profdata merge -output="$PROFDATA" "$PROFILE_DIR"/*.profraw >> "$BUILDLOG" 2>&1
+  print "  - Merged $(ls "$PROFILE_DIR"/*.profraw | wc -l) raw profiles into $PROFDATA"
+
+  # The instrumented libraries are only a means to an end; do not ship them.
+  rm -rf "$INSTRUMENTED_DIR"
+
+  PGO_FLAGS="-O2 -fprofile-use=$PROFDATA -Wno-profile-instr-unprofiled -Wno-profile-instr-out-of-date"
+  build_icu                 \
+    "$PGO_TARGET"           \
+    ""                      \
+    clang                   \
+    clang++                 \
+    llvm-ar                 \
+    llvm-ranlib             \
+    ""                      \
+    "$PGO_FLAGS"            \
+    "$PGO_FLAGS"            \
+    "$PGO_ZIP_FILE"
+
+  # Ship the profile next to the zip so the build can be reproduced.
+  cp "$PROFDATA" "${PGO_ZIP_FILE%.zip}.profdata"
+  print "✅ Created ${PGO_ZIP_FILE%.zip}.profdata"
+}
+
+# ICU source tree with the data sources (icu4c-*-data.zip) in place of the prebuilt
+# source/data/in/icudt*.dat, so the data can be rebuilt with a filter.
+ICU_DATA_SOURCE="$WORKDIR/icu-data-src"
+prepare_icu_data_source() {
+  if [[ "$DRY_RUN" == true ]]; then
+    echo "[DRY RUN] Would prepare the ICU data sources in $ICU_DATA_SOURCE"
+    return 0
+  fi
+
+  ICU_DATA_URL="https://github.com/unicode-org/icu/releases/download/release-${ICU_VERSION//./-}/icu4c-${ICU_VERSION//./_}-data.zip"
+  ICU_DATA_ZIP="$WORKDIR/icu4c-data.zip"
+  if [ ! -f "$ICU_DATA_ZIP" ]; then
+    print "📥 Downloading ICU data sources..."
+    curl -L -o "$ICU_DATA_ZIP" "$ICU_DATA_URL"
+  fi
+
+  rm -rf "$ICU_DATA_SOURCE"
+  cp -a "$WORKDIR/icu" "$ICU_DATA_SOURCE"
+  rm -rf "$ICU_DATA_SOURCE/source/data"
+  unzip -q "$ICU_DATA_ZIP" -d "$ICU_DATA_SOURCE/source"
+}
+
+# Data-only package for a data profile: share/icu/<version>/icudt*l.dat rebuilt from the
+# data sources with an ICU data filter (ICU_DATA_FILTER_FILE). The little-endian .dat is
+# the same for every target, so one zip per profile serves Linux, Windows and WASM;
+# unzip it over a package to replace its data file.
+build_icu_data() {
+  PROFILE="$1"; FILTER_FILE="$2"
+  print_section "Build ICU data profile $PROFILE"
+  DATA_ZIP_FILE="$DISTDIR/icu4c-${ICU_VERSION}_data-${PROFILE}.zip"
+  DATA_NAME="icudt${ICU_VERSION%%.*}l"
+  if [[ "$DRY_RUN" == true ]]; then
+    echo "[DRY RUN] Would build $DATA_NAME.dat with filter [${FILTER_FILE:-none}] and package $DATA_ZIP_FILE"
+    return 0
+  fi
+
+  PROFILE_ROOT="$DISTDIR/data-$PROFILE"
+  PROFILE_DATA_DIR="$PROFILE_ROOT/share/icu/$ICU_VERSION"
+  rm -rf   "$PROFILE_ROOT"
+  mkdir -p "$PROFILE_DATA_DIR"
+
+  if [[ -z "$FILTER_FILE" ]]; then
+    cp "$WORKDIR/icu/source/data/in/$DATA_NAME.dat" "$PROFILE_DATA_DIR/"
+  else
+    BUILD_DIR="$WORKDIR/build-data-$PROFILE"
+    rm    -rf "$BUILD_DIR"
+    mkdir -p  "$BUILD_DIR"
+    cd "$BUILD_DIR"
+
+    ICU_DATA_FILTER_FILE="$FILTER_FILE"               \
+    PKG_CONFIG_LIBDIR=                                \
+    CC="${CACHE_LAUNCHER:+$CACHE_LAUNCHER }clang"     \
+    CXX="${CACHE_LAUNCHER:+$CACHE_LAUNCHER }clang++"  \
+    CFLAGS="-O2" CXXFLAGS="-O2"                       \
+    "$ICU_DATA_SOURCE/source/configure"               \
+      --enable-static                                 \
+      --disable-shared                                \
+      --with-data-packaging=archive                   \
+      --disable-extras                                \
+      --disable-tests                                 \
+      --disable-samples                               \
+      >> "$BUILDLOG" 2>&1
+    make >> "$BUILDLOG" 2>&1
+
+    cp "$BUILD_DIR/data/out/$DATA_NAME.dat" "$PROFILE_DATA_DIR/"
+    cp "$FILTER_FILE" "$PROFILE_DATA_DIR/data-filter.json"
+  fi
+  echo "$PROFILE" > "$PROFILE_DATA_DIR/data-profile"
+
+  DATA_SIZE=$(du -h "$PROFILE_DATA_DIR/$DATA_NAME.dat" | cut -f1)
+  print "  - Data file size: $DATA_SIZE"
+
+  cd "$PROFILE_ROOT"
+  rm -f "$DATA_ZIP_FILE"
+  zip -r "$DATA_ZIP_FILE" ./  >> "$BUILDLOG" 2>&1
+  print "✅ Created $DATA_ZIP_FILE"
+}
+
+# Split data package for a data profile (variant data-split): the items of the profile's
+# .dat as separate files plus an index, for LazyData (addons/include/icuaddons/lazydata.h)
+# to fetch one locale and feature at a time. share/icu/<version>/split/ holds index.txt
+# ("<item> <bytes>" per line) and icudt*l/<item>. Uses the icupkg of the linux-x86-64
+# build, or the one on the PATH.
+build_icu_data_split() {
+  PROFILE="$1"
+  print_section "Split ICU data profile $PROFILE"
+  SPLIT_ZIP_FILE="$DISTDIR/icu4c-${ICU_VERSION}_data-${PROFILE}-split.zip"
+  DATA_NAME="icudt${ICU_VERSION%%.*}l"
+  if [[ "$DRY_RUN" == true ]]; then
+    echo "[DRY RUN] Would split $DISTDIR/data-$PROFILE/share/icu/$ICU_VERSION/$DATA_NAME.dat and package $SPLIT_ZIP_FILE"
+    return 0
+  fi
+
+  ICUPKG="$WORKDIR/build-$LINUX_CLANG_TARGET_64/bin/icupkg"
+  [[ -x "$ICUPKG" ]] || ICUPKG="$(command -v icupkg)" || exit_with_error "icupkg not found: build linux-x86-64 or install the ICU tools"
+
+  SPLIT_ROOT="$DISTDIR/data-$PROFILE-split"
+  SPLIT_DIR="$SPLIT_ROOT/share/icu/$ICU_VERSION/split"
+  rm -rf   "$SPLIT_ROOT"
+  mkdir -p "$SPLIT_DIR/$DATA_NAME"
+
+  DATA_FILE="$DISTDIR/data-$PROFILE/share/icu/$ICU_VERSION/$DATA_NAME.dat"
+  "$ICUPKG" -l -o "$SPLIT_ROOT/items.txt" "$DATA_FILE"                   >> "$BUILDLOG" 2>&1
+  "$ICUPKG" -x "$SPLIT_ROOT/items.txt" -d "$SPLIT_DIR/$DATA_NAME" "$DATA_FILE" >> "$BUILDLOG" 2>&1
+  rm -f "$SPLIT_ROOT/items.txt"
+  (cd "$SPLIT_DIR/$DATA_NAME" && find . -type f -printf '%P %s\n' | LC_ALL=C sort) > "$SPLIT_DIR/index.txt"
+  echo "$PROFILE" > "$SPLIT_ROOT/share/icu/$ICU_VERSION/data-profile"
+
+  print "  - Items: $(wc -l < "$SPLIT_DIR/index.txt")"
+
+  cd "$SPLIT_ROOT"
+  rm -f "$SPLIT_ZIP_FILE"
+  zip -r "$SPLIT_ZIP_FILE" ./  >> "$BUILDLOG" 2>&1
+  print "✅ Created $SPLIT_ZIP_FILE"
+}
+
+
+# ---------------------------------------------------------------------------
+# Build jobs
+#
+# Every package is a job. Jobs whose dependencies have finished run at the same time in
+# the background (cross builds wait for the Linux build that provides their tools). All
+# `make`s share one GNU make jobserver, so BUILD_JOBS bounds the compile jobs of the whole
+# build rather than of each target. Each job logs to $DISTDIR/logs/<job>.log; the logs are
+# appended to build.log when the build ends.
+# ---------------------------------------------------------------------------
+
+JOB_NAMES=()
+declare -A JOB_COMMANDS JOB_DEPS JOB_STATES JOB_PIDS JOB_STARTS
+
+# add_job NAME "DEPENDENCY..." COMMAND [ARG...]
+# Dependencies must be added first; dependencies that are not scheduled are ignored.
+add_job() {
+  local NAME="$1" DEPS="$2"
+  shift 2
+  JOB_NAMES+=("$NAME")
+  JOB_COMMANDS[$NAME]="$(printf '%q ' "$@")"
+  JOB_DEPS[$NAME]="$DEPS"
+  JOB_STATES[$NAME]=pending
+}
+
+# Prints "ready", "wait" or "blocked" (a dependency failed) for a pending job.
+job_readiness() {
+  local DEP READINESS=ready
+  for DEP in ${JOB_DEPS[$1]}; do
+    case "${JOB_STATES[$DEP]:-done}" in
+      done)            ;;
+      failed|skipped)  echo blocked; return ;;
+      *)               READINESS=wait ;;
+    esac
+  done
+  echo $READINESS
+}
+
+# One token per compile job beyond the one every make owns; shared through fd 3.
+start_jobserver() {
+  local FIFO="$WORKDIR/.jobserver"
+  rm -f "$FIFO"
+  mkfifo "$FIFO"
+  exec 3<>"$FIFO"
+  rm -f "$FIFO"
+  if (( BUILD_JOBS > 1 )); then
+    printf '%*s' $((BUILD_JOBS - 1)) '' | tr ' ' '+' >&3
+  fi
+  export MAKEFLAGS="-j --jobserver-auth=3,3"
+}
+
+start_job() {
+  local NAME="$1"
+  local JOB_LOG="$DISTDIR/logs/$NAME.log"
+  : > "$JOB_LOG"
+  (
+    BUILDLOG="$JOB_LOG"
+    eval "${JOB_COMMANDS[$NAME]}"
+  ) > /dev/null 2>> "$JOB_LOG" &
+  JOB_PIDS[$NAME]=$!
+  JOB_STARTS[$NAME]=$SECONDS
+  JOB_STATES[$NAME]=running
+  echo -e "▶️  Started  $NAME"
+}
+
+finish_job() {
+  local NAME="$1" STATUS="$2"
+  local ELAPSED=$((SECONDS - JOB_STARTS[$NAME]))
+  local DURATION="$((ELAPSED / 60))m$((ELAPSED % 60))s"
+  if [[ "$STATUS" -eq 0 ]]; then
+    JOB_STATES[$NAME]=done
+    echo -e "${GREEN}✅ Finished $NAME ($DURATION)${NC}"
+  else
+    JOB_STATES[$NAME]=failed
+    echo -e "${RED}❌ Failed   $NAME ($DURATION), last lines of $DISTDIR/logs/$NAME.log:${NC}"
+    tail -n 20 "$DISTDIR/logs/$NAME.log" | sed 's/^/     /'
+  fi
+}
+
+run_jobs() {
+  local NAME RUNNING FAILED=()
+  print_section "Build jobs (BUILD_JOBS=$BUILD_JOBS, MAX_PARALLEL_TARGETS=$MAX_PARALLEL_TARGETS)"
+  for NAME in "${JOB_NAMES[@]}"; do
+    print "  - $NAME${JOB_DEPS[$NAME]:+ (after ${JOB_DEPS[$NAME]// /, })}"
+  done
+  print ""
+
+  # A dry run only prints what each job would do, in dependency order.
+  if [[ "$DRY_RUN" == true ]]; then
+    for NAME in "${JOB_NAMES[@]}"; do
+      eval "${JOB_COMMANDS[$NAME]}"
+    done
+    return 0
+  fi
 
+  mkdir -p "$DISTDIR/logs"
+  start_jobserver
 
-if [[ "$LINUX_32" == true ]]; then
+  RUNNING=0
+  while true; do
+    for NAME in "${JOB_NAMES[@]}"; do
+      [[ "${JOB_STATES[$NAME]}" == pending ]] || continue
+      case "$(job_readiness "$NAME")" in
+        ready)
+          if (( RUNNING < MAX_PARALLEL_TARGETS )); then
+            start_job "$NAME"
+            RUNNING=$((RUNNING + 1))
+          fi ;;
+        blocked)
+          JOB_STATES[$NAME]=skipped
+          echo -e "${YELLOW}⏭️  Skipped  $NAME (a dependency failed)${NC}" ;;
+      esac
+    done
+    (( RUNNING > 0 )) || break
+
+    local PID="" STATUS=0
+    wait -n -p PID || STATUS=$?
+    for NAME in "${JOB_NAMES[@]}"; do
+      if [[ "${JOB_STATES[$NAME]}" == running && "${JOB_PIDS[$NAME]}" == "$PID" ]]; then
+        finish_job "$NAME" "$STATUS"
+        RUNNING=$((RUNNING - 1))
+      fi
+    done
+  done
+
+  exec 3>&-
+  unset MAKEFLAGS
+
+  for NAME in "${JOB_NAMES[@]}"; do
+    [[ -f "$DISTDIR/logs/$NAME.log" ]] && cat "$DISTDIR/logs/$NAME.log" >> "$BUILDLOG"
+    [[ "${JOB_STATES[$NAME]}" == done ]] || FAILED+=("$NAME")
+  done
+  if (( ${#FAILED[@]} > 0 )); then
+    exit_with_error "Build jobs failed or skipped: ${FAILED[*]}"
+  fi
+}
+
+
+build_linux_x86_32() {
   TOOLS="clang-${CLANG_VERSION}"
   TARGET="linux-x86-32"
   ZIP_FILE="$DISTDIR/icu4c-${ICU_VERSION}_${TARGET}_${TOOLS}.zip"
@@ -237,8 +784,9 @@ if [[ "$LINUX_32" == true ]]; then
     "-O2 -m32"  \
     "-O2 -m32"  \
     "$ZIP_FILE"
-fi
-if [[ "$LINUX_64" == true ]]; then
+}
+
+build_linux_x86_64() {
   TOOLS="clang-${CLANG_VERSION}"
   TARGET="linux-x86-64"
   ZIP_FILE="$DISTDIR/icu4c-${ICU_VERSION}_${TARGET}_${TOOLS}.zip"
@@ -253,9 +801,166 @@ if [[ "$LINUX_64" == true ]]; then
     "-O2"       \
     "-O2"       \
     "$ZIP_FILE"
-fi
+}
+
+build_linux_x86_64_thinlto() {
+  # Archives of LLVM bitcode: consumers link them with -flto=thin (see lib/cmake/icu/icu-link.cmake).
+  TOOLS="clang-${CLANG_VERSION}"
+  TARGET="linux-x86-64-thinlto"
+  ZIP_FILE="$DISTDIR/icu4c-${ICU_VERSION}_${TARGET}_${TOOLS}.zip"
+  EXTRA_LDFLAGS="-flto=thin -fuse-ld=lld"        \
+  PACKAGE_COMPILE_OPTIONS="-flto=thin"           \
+  PACKAGE_LINK_OPTIONS="-flto=thin;-fuse-ld=lld" \
+  PACKAGE_REQUIRES_CLANG=ON                      \
+  build_icu                \
+    "$TARGET"              \
+    ""                     \
+    clang                  \
+    clang++                \
+    llvm-ar                \
+    llvm-ranlib            \
+    ""                     \
+    "-O2 -flto=thin"       \
+    "-O2 -flto=thin"       \
+    "$ZIP_FILE"
+}
+
+build_linux_x86_64_static_data() {
+  # No icudt*.dat lookup at startup: the data is linked into every executable.
+  TOOLS="clang-${CLANG_VERSION}"
+  TARGET="linux-x86-64-static-data"
+  ZIP_FILE="$DISTDIR/icu4c-${ICU_VERSION}_${TARGET}_${TOOLS}.zip"
+  DATA_PACKAGING=static \
+  build_icu     \
+    "$TARGET"   \
+    ""          \
+    clang       \
+    clang++     \
+    llvm-ar     \
+    llvm-ranlib \
+    ""          \
+    "-O2"       \
+    "-O2"       \
+    "$ZIP_FILE"
+}
+
+build_linux_x86_64_level() {
+  # -march=x86-64-v$LEVEL lets the compiler use SSE4.2/AVX2/AVX-512 in the conversion and
+  # normalization loops. The data is built with the tools of the generic linux-x86-64 build,
+  # so even the v4 package builds on a machine without AVX-512.
+  LEVEL="$1"
+  TOOLS="clang-${CLANG_VERSION}"
+  TARGET="linux-x86-64-v$LEVEL"
+  ZIP_FILE="$DISTDIR/icu4c-${ICU_VERSION}_${TARGET}_${TOOLS}.zip"
+  LINUX_BUILD_DIR="$WORKDIR/build-$LINUX_CLANG_TARGET_64"
+  PACKAGE_X86_64_LEVEL="$LEVEL"             \
+  build_icu                                 \
+    "$TARGET"                               \
+    ""                                      \
+    clang                                   \
+    clang++                                 \
+    llvm-ar                                 \
+    llvm-ranlib                             \
+    "--with-cross-build=$LINUX_BUILD_DIR"   \
+    "-O2 -march=x86-64-v$LEVEL"             \
+    "-O2 -march=x86-64-v$LEVEL"             \
+    "$ZIP_FILE"
+}
+
+build_linux_x86_64_tsan() {
+  # ThreadSanitizer instrumentation for the thread-safety stress test (test/run-tsan.sh).
+  # Frame pointers and debug info keep the race reports readable. The data is built
+  # with the uninstrumented tools of the generic linux-x86-64 build.
+  TOOLS="clang-${CLANG_VERSION}"
+  TARGET="linux-x86-64-tsan"
+  ZIP_FILE="$DISTDIR/icu4c-${ICU_VERSION}_${TARGET}_${TOOLS}.zip"
+  LINUX_BUILD_DIR="$WORKDIR/build-$LINUX_CLANG_TARGET_64"
+  EXTRA_LDFLAGS="-fsanitize=thread"                              \
+  PACKAGE_COMPILE_OPTIONS="-fsanitize=thread"                    \
+  PACKAGE_LINK_OPTIONS="-fsanitize=thread"                       \
+  PACKAGE_REQUIRES_CLANG=ON                                      \
+  build_icu                                                      \
+    "$TARGET"                                                    \
+    ""                                                           \
+    clang                                                        \
+    clang++                                                      \
+    llvm-ar                                                      \
+    llvm-ranlib                                                  \
+    "--with-cross-build=$LINUX_BUILD_DIR"                        \
+    "-O1 -g -fno-omit-frame-pointer -fsanitize=thread"           \
+    "-O1 -g -fno-omit-frame-pointer -fsanitize=thread"           \
+    "$ZIP_FILE"
+}
+
+# linux-x86-64 for profiling ICU inside production programs:
+#   - frame pointers (leaf functions too), so perf record -g and eBPF profilers unwind through ICU;
+#     icu-link.cmake asks for them in the consumer's code as well
+#   - ICU configured with --enable-tracing: the trace points around service creation and data
+#     loading fire the hooks of icuaddons/trace.h (timing statistics and USDT probes)
+#   - -O2 -g, with the DWARF split off into ..._linux-x86-64-profiling-debuginfo_clang-N.zip:
+#     the package libraries keep only their symbols, the debuginfo zip holds the same
+#     libraries with full debug info (source paths relative to icu/source) and symbols.txt
+# The data is built with the tools of the generic linux-x86-64 build.
+build_linux_x86_64_profiling() {
+  TOOLS="clang-${CLANG_VERSION}"
+  TARGET="linux-x86-64-profiling"
+  ZIP_FILE="$DISTDIR/icu4c-${ICU_VERSION}_${TARGET}_${TOOLS}.zip"
+  LINUX_BUILD_DIR="$WORKDIR/build-$LINUX_CLANG_TARGET_64"
+  local FLAGS="-O2 -g -fno-omit-frame-pointer -mno-omit-leaf-frame-pointer -fdebug-prefix-map=$WORKDIR/icu/source=icu/source"
+  PACKAGE_CONFIGURE_FLAGS="--enable-tracing"                                                    \
+  PACKAGE_COMPILE_OPTIONS="-fno-omit-frame-pointer;-mno-omit-leaf-frame-pointer"               \
+  PACKAGE_DEBUGINFO_ZIP="$DISTDIR/icu4c-${ICU_VERSION}_${TARGET}-debuginfo_${TOOLS}.zip"        \
+  build_icu                                                                                     \
+    "$TARGET"                                                                                   \
+    ""                                                                                          \
+    clang                                                                                       \
+    clang++                                                                                     \
+    llvm-ar                                                                                     \
+    llvm-ranlib                                                                                 \
+    "--with-cross-build=$LINUX_BUILD_DIR"                                                       \
+    "$FLAGS"                                                                                    \
+    "$FLAGS"                                                                                    \
+    "$ZIP_FILE"
+}
 
-if [[ "$WINDOWS_32" == true ]]; then
+# Size-optimized linux-x86-64 for sidecar processes and embedded targets, by profile:
+#   size       -Os with one section per function and data object; programs linked with
+#              --gc-sections (icu-link.cmake) keep only the ICU code they reach
+#   size-text  size, with the services a text-processing program does not use compiled out:
+#              legacy charsets, transliteration, regular expressions, formatting, IDNA and
+#              service registration. Collation, break iteration, normalization, character
+#              properties, locales and UTF conversion remain.
+# The data is built with the tools of the generic linux-x86-64 build.
+build_linux_x86_64_size() {
+  PROFILE="$1"
+  TOOLS="clang-${CLANG_VERSION}"
+  TARGET="linux-x86-64-$PROFILE"
+  ZIP_FILE="$DISTDIR/icu4c-${ICU_VERSION}_${TARGET}_${TOOLS}.zip"
+  LINUX_BUILD_DIR="$WORKDIR/build-$LINUX_CLANG_TARGET_64"
+  local UCONFIG=""
+  case "$PROFILE" in
+    size)      ;;
+    size-text) UCONFIG="UCONFIG_NO_LEGACY_CONVERSION UCONFIG_NO_TRANSLITERATION UCONFIG_NO_REGULAR_EXPRESSIONS"
+               UCONFIG+=" UCONFIG_NO_FORMATTING UCONFIG_NO_IDNA UCONFIG_NO_SERVICE" ;;
+    *)         exit_with_error "Unknown size profile: $PROFILE" ;;
+  esac
+  EXTRA_LDFLAGS="-Wl,--gc-sections"                 \
+  PACKAGE_LINK_OPTIONS="-Wl,--gc-sections"          \
+  PACKAGE_UCONFIG="$UCONFIG"                        \
+  build_icu                                         \
+    "$TARGET"                                       \
+    ""                                              \
+    clang                                           \
+    clang++                                         \
+    llvm-ar                                         \
+    llvm-ranlib                                     \
+    "--with-cross-build=$LINUX_BUILD_DIR"           \
+    "-Os -ffunction-sections -fdata-sections"       \
+    "-Os -ffunction-sections -fdata-sections"       \
+    "$ZIP_FILE"
+}
+
+build_windows_x86_32() {
   TOOLS="clang-${CLANG_VERSION}"
   TARGET="windows-x86-32"
   ZIP_FILE="$DISTDIR/icu4c-${ICU_VERSION}_${TARGET}_${TOOLS}.zip"
@@ -271,9 +976,9 @@ if [[ "$WINDOWS_32" == true ]]; then
     "-O2"                                   \
     "-O2"                                   \
     "$ZIP_FILE"
-fi
+}
 
-if [[ "$WINDOWS_64" == true ]]; then
+build_windows_x86_64() {
   TOOLS="clang-${CLANG_VERSION}"
   TARGET="windows-x86-64"
   ZIP_FILE="$DISTDIR/icu4c-${ICU_VERSION}_${TARGET}_${TOOLS}.zip"
@@ -289,59 +994,237 @@ if [[ "$WINDOWS_64" == true ]]; then
     "-O2"                                     \
     "-O2"                                     \
     "$ZIP_FILE"
-fi
+}
 
-# WASM builds
-if [[ "$WASM32" == true || "$WASM64" == true ]]; then
+# LLVM IR kit (artifacts/llvm-kit): ICU as LLVM bitcode, one .bc per translation unit of
+# common/i18n/io and of stubdata (the icudt<version>_dat entry point libicuuc references,
+# empty so that ICU loads the shipped .dat file), plus icu.bc, all of them linked into one
+# module and optimized with opt. The sources are compiled with -flto, so the bitcode holds the optimized
+# pre-link IR (no optnone) and consumers can run whole-program optimization with their
+# own code. LLVM_IR_TEXT=true also ships every module as .ll.
+build_llvm_kit() {
+  BITS="$1"
+  TOOLS="clang-${CLANG_VERSION}"
+  TARGET="llvm-kit-$BITS"
+  ZIP_FILE="$DISTDIR/icu4c-${ICU_VERSION}_${TARGET}_${TOOLS}.zip"
+  if [[ "$BITS" == 32 ]]; then
+    MACHINE_FLAGS="-m32"; PLATFORM="linux-x86_32"
+  else
+    MACHINE_FLAGS="";     PLATFORM="linux-x86_64"
+  fi
+  print_section "Build LLVM IR kit for $PLATFORM"
+  if [[ "$DRY_RUN" == true ]]; then
+    echo "[DRY RUN] Would build LLVM IR kit: TARGET=$TARGET PLATFORM=$PLATFORM FLAGS=[-O2 -flto $MACHINE_FLAGS] ZIP=$ZIP_FILE"
+    return 0
+  fi
+
+  BUILD_DIR="$WORKDIR/build-$TARGET"
+  KIT_DIR="$DISTDIR/$TARGET"
+  IR_DIR="$KIT_DIR/llvm-ir-$CLANG_VERSION/$PLATFORM-$TOOLS"
+  ICU_SOURCE="$WORKDIR/icu/source"
+  rm    -rf "$BUILD_DIR" "$KIT_DIR"
+  mkdir -p  "$BUILD_DIR" "$IR_DIR" "$KIT_DIR/include/unicode"
+  cd "$BUILD_DIR"
+
+  # Only the libraries are built (no tools, no data), so no cross-build directory is needed.
+  # Linking the configure checks needs an LTO-capable linker.
+  PKG_CONFIG_LIBDIR=                                          \
+  CC=clang CXX=clang++ AR=llvm-ar RANLIB=llvm-ranlib          \
+  CFLAGS="-O2 -flto $MACHINE_FLAGS"                           \
+  CXXFLAGS="-O2 -flto $MACHINE_FLAGS"                         \
+  LDFLAGS="-flto -fuse-ld=lld $MACHINE_FLAGS"                 \
+  "$ICU_SOURCE/configure"                                     \
+    --enable-static                                           \
+    --disable-shared                                          \
+    --disable-tools                                           \
+    --disable-extras                                          \
+    --disable-tests                                           \
+    --disable-samples                                         \
+    >> "$BUILDLOG" 2>&1
+
+  for LIBRARY in common i18n io stubdata; do
+    print "📋 Emitting $LIBRARY bitcode..."
+    # -j comes from the shared jobserver in MAKEFLAGS (see run_jobs)
+    make -C "$BUILD_DIR/$LIBRARY" >> "$BUILDLOG" 2>&1
+    mkdir -p "$IR_DIR/$LIBRARY"
+    for OBJECT in "$BUILD_DIR/$LIBRARY/"*.o; do
+      MODULE="$IR_DIR/$LIBRARY/$(basename "$OBJECT" .o)"
+      cp "$OBJECT" "$MODULE.bc"
+      [[ "${LLVM_IR_TEXT:-false}" == true ]] && llvm-dis "$MODULE.bc" -o "$MODULE.ll"
+    done
+    print "  - $(ls "$IR_DIR/$LIBRARY/"*.bc | wc -l) modules"
+  done
+
+  print "🔗 Linking and optimizing the single-module icu.bc..."
+  llvm-link "$IR_DIR"/common/*.bc "$IR_DIR"/i18n/*.bc "$IR_DIR"/io/*.bc "$IR_DIR"/stubdata/*.bc -o "$BUILD_DIR/icu-linked.bc" >> "$BUILDLOG" 2>&1
+  opt -O2 "$BUILD_DIR/icu-linked.bc" -o "$IR_DIR/icu.bc"                                               >> "$BUILDLOG" 2>&1
+  [[ "${LLVM_IR_TEXT:-false}" == true ]] && llvm-dis "$IR_DIR/icu.bc" -o "$IR_DIR/icu.ll"
+
+  # Public headers, the prebuilt data archive and the kit's own build script
+  for LIBRARY in common i18n io; do
+    cp "$ICU_SOURCE/$LIBRARY/unicode/"*.h "$KIT_DIR/include/unicode/"
+  done
+  mkdir -p "$KIT_DIR/share/icu/$ICU_VERSION"
+  cp "$ICU_SOURCE/data/in/icudt${ICU_VERSION%%.*}l.dat" "$KIT_DIR/share/icu/$ICU_VERSION/"
+  cp "$SCRIPT_DIR/artifacts/llvm-kit/build-lib-from-llvm.sh" "$SCRIPT_DIR/artifacts/llvm-kit/README.md" "$KIT_DIR/"
+
+  cd "$KIT_DIR"
+  zip -r "$ZIP_FILE" ./  >> "$BUILDLOG" 2>&1
+  print "✅ Created $ZIP_FILE"
+
+  chmod -R ugo+rwx "$WORKDIR" || true
+  chmod -R ugo+rwx "$DISTDIR" || true
+}
+
+# Install and activate the Emscripten SDK used by the WASM jobs.
+setup_emsdk() {
   print_section "Build WEB ASM"
+  cd "$WORKDIR"
   if [ ! -d emsdk ]; then
     git clone https://github.com/emscripten-core/emsdk.git
   fi
   cd emsdk
-  EMSDK=$(pwd)
   git switch $ENSDK_VERSION -c "v$ENSDK_VERSION"
   ./emsdk install latest    >> "$BUILDLOG" 2>&1
   ./emsdk activate latest   >> "$BUILDLOG" 2>&1
-  cd -
   print ""
 
-  source "$EMSDK/emsdk_env.sh"
   cp "$WORKDIR/icu/source/config/mh-linux" "$WORKDIR/icu/source/config/mh-unknown"
+  # pkgdata would emit x86 assembly for the static data; let it write C that emcc can compile
+  sed -i 's/^GENCCODE_ASSEMBLY=.*/GENCCODE_ASSEMBLY=/' "$WORKDIR/icu/source/config/mh-unknown"
+}
 
-  if [[ "$WASM32" == true ]]; then
-    TOOLS="clang-${CLANG_VERSION}_emsdk-${ENSDK_VERSION}"
-    TARGET="wasm-32"
-    ZIP_FILE="$DISTDIR/icu4c-${ICU_VERSION}_${TARGET}_${TOOLS}.zip"
-    LINUX_BUILD_DIR="$WORKDIR/build-$LINUX_CLANG_TARGET_32"
-    build_icu                               \
-      "wasm-32"                             \
-      wasm32                                \
-      emcc                                  \
-      em++                                  \
-      emar                                  \
-      emranlib                              \
-      "--with-cross-build=$LINUX_BUILD_DIR" \
-      "-O2"                                 \
-      "-O2"                                 \
-      "$ZIP_FILE"
+build_wasm_32() {
+  source "$WORKDIR/emsdk/emsdk_env.sh" > /dev/null 2>&1
+  TOOLS="clang-${CLANG_VERSION}_emsdk-${ENSDK_VERSION}"
+  TARGET="wasm-32"
+  ZIP_FILE="$DISTDIR/icu4c-${ICU_VERSION}_${TARGET}_${TOOLS}.zip"
+  LINUX_BUILD_DIR="$WORKDIR/build-$LINUX_CLANG_TARGET_32"
+  build_icu                               \
+    "wasm-32"                             \
+    wasm32                                \
+    emcc                                  \
+    em++                                  \
+    emar                                  \
+    emranlib                              \
+    "--with-cross-build=$LINUX_BUILD_DIR" \
+    "-O2"                                 \
+    "-O2"                                 \
+    "$ZIP_FILE"
+}
+
+build_wasm_64() {
+  source "$WORKDIR/emsdk/emsdk_env.sh" > /dev/null 2>&1
+  TOOLS="clang-${CLANG_VERSION}_emsdk-${ENSDK_VERSION}"
+  TARGET="wasm-64"
+  ZIP_FILE="$DISTDIR/icu4c-${ICU_VERSION}_${TARGET}_${TOOLS}.zip"
+  LINUX_BUILD_DIR="$WORKDIR/build-$LINUX_CLANG_TARGET_64"
+  build_icu                               \
+    "wasm-64"                             \
+    wasm64                                \
+    emcc                                  \
+    em++                                  \
+    emar                                  \
+    emranlib                              \
+    "--with-cross-build=$LINUX_BUILD_DIR" \
+    "-O2"                                 \
+    "-O2"                                 \
+    "$ZIP_FILE"
+}
+
+build_wasm_32_simd() {
+  # -msimd128 lets the compiler vectorize the conversion and normalization loops, -pthread
+  # builds ICU with atomics and shared memory so it can run on Web Workers. The data is
+  # linked into libicudata.a: break iteration, collation and conversion work without a
+  # file system. Everything linked with the package must also use -pthread.
+  source "$WORKDIR/emsdk/emsdk_env.sh" > /dev/null 2>&1
+  TOOLS="clang-${CLANG_VERSION}_emsdk-${ENSDK_VERSION}"
+  TARGET="wasm-32-simd"
+  ZIP_FILE="$DISTDIR/icu4c-${ICU_VERSION}_${TARGET}_${TOOLS}.zip"
+  LINUX_BUILD_DIR="$WORKDIR/build-$LINUX_CLANG_TARGET_32"
+  DATA_PACKAGING=static                        \
+  PACKAGE_COMPILE_OPTIONS="-msimd128;-pthread" \
+  PACKAGE_LINK_OPTIONS="-pthread"              \
+  build_icu                                    \
+    "$TARGET"                                  \
+    wasm32                                     \
+    emcc                                       \
+    em++                                       \
+    emar                                       \
+    emranlib                                   \
+    "--with-cross-build=$LINUX_BUILD_DIR"      \
+    "-O3 -msimd128 -pthread"                   \
+    "-O3 -msimd128 -pthread"                   \
+    "$ZIP_FILE"
+}
+
+
+show-build-matrix
+setup_build_cache
+
+[[ "$LINUX_32" == true ]] && add_job linux-x86-32 "" build_linux_x86_32
+[[ "$LINUX_64" == true ]] && add_job linux-x86-64 "" build_linux_x86_64
+if [[ "$LINUX_64" == true ]]; then
+  has_variant pgo         && add_job linux-x86-64-pgo         "" build_icu_pgo
+  has_variant thinlto     && add_job linux-x86-64-thinlto     "" build_linux_x86_64_thinlto
+  has_variant static-data && add_job linux-x86-64-static-data "" build_linux_x86_64_static_data
+  has_variant tsan        && add_job linux-x86-64-tsan        linux-x86-64 build_linux_x86_64_tsan
+  has_variant profiling   && add_job linux-x86-64-profiling   linux-x86-64 build_linux_x86_64_profiling
+  for LEVEL in 2 3 4; do
+    has_variant "x86-64-v$LEVEL" && add_job "linux-x86-64-v$LEVEL" linux-x86-64 build_linux_x86_64_level "$LEVEL"
+  done
+  for PROFILE in size size-text; do
+    has_variant "$PROFILE" && add_job "linux-x86-64-$PROFILE" linux-x86-64 build_linux_x86_64_size "$PROFILE"
+  done
+fi
+
+# Filtered data profiles rebuild the data from one shared copy of the data sources
+add_data_profile_job() {
+  PROFILE="$1"; FILTER_FILE="$2"
+  if [[ -z "$FILTER_FILE" ]]; then
+    add_job "data-$PROFILE" "" build_icu_data "$PROFILE" ""
+    return
   fi
-  if [[ "$WASM64" == true ]]; then
-    TOOLS="clang-${CLANG_VERSION}_emsdk-${ENSDK_VERSION}"
-    TARGET="wasm-64"
-    ZIP_FILE="$DISTDIR/icu4c-${ICU_VERSION}_${TARGET}_${TOOLS}.zip"
-    LINUX_BUILD_DIR="$WORKDIR/build-$LINUX_CLANG_TARGET_64"
-    build_icu                               \
-      "wasm-64"                             \
-      wasm64                                \
-      emcc                                  \
-      em++                                  \
-      emar                                  \
-      emranlib                              \
-      "--with-cross-build=$LINUX_BUILD_DIR" \
-      "-O2"                                 \
-      "-O2"                                 \
-      "$ZIP_FILE"
+  [[ -n "${JOB_STATES[icu-data-source]}" ]] || add_job icu-data-source "" prepare_icu_data_source
+  add_job "data-$PROFILE" icu-data-source build_icu_data "$PROFILE" "$FILTER_FILE"
+}
+add_data_split_job() {
+  PROFILE="$1"
+  has_variant data-split || return 0
+  local DEPS="data-$PROFILE"
+  [[ "$LINUX_64" == true ]] && DEPS="$DEPS linux-x86-64"
+  add_job "data-$PROFILE-split" "$DEPS" build_icu_data_split "$PROFILE"
+}
+if [[ -n "$CUSTOM_DATA_FILTER" ]]; then
+  add_data_profile_job "$(basename "$CUSTOM_DATA_FILTER" .json)" "$CUSTOM_DATA_FILTER"
+  add_data_split_job   "$(basename "$CUSTOM_DATA_FILTER" .json)"
+fi
+# The data-split variant splits every data profile, and the full data when none is given
+if has_variant data-split && [[ ${#DATA_PROFILES[@]} -eq 0 && -z "$CUSTOM_DATA_FILTER" ]]; then
+  DATA_PROFILES=(full)
+fi
+for PROFILE in "${DATA_PROFILES[@]}"; do
+  if [[ "$PROFILE" == "full" ]]; then
+    add_data_profile_job full ""
+  elif [[ -f "$SCRIPT_DIR/data-filters/$PROFILE.json" ]]; then
+    add_data_profile_job "$PROFILE" "$SCRIPT_DIR/data-filters/$PROFILE.json"
+  else
+    exit_with_error "Unknown data profile: $PROFILE (no $SCRIPT_DIR/data-filters/$PROFILE.json)"
   fi
+  add_data_split_job "$PROFILE"
+done
+
+[[ "$WINDOWS_32" == true ]] && add_job windows-x86-32 linux-x86-32 build_windows_x86_32
+[[ "$LLVMIR32"   == true ]] && add_job llvm-kit-32    ""           build_llvm_kit 32
+[[ "$LLVMIR64"   == true ]] && add_job llvm-kit-64    ""           build_llvm_kit 64
+[[ "$WINDOWS_64" == true ]] && add_job windows-x86-64 linux-x86-64 build_windows_x86_64
+if [[ "$WASM32" == true || "$WASM64" == true ]]; then
+  add_job emsdk "" setup_emsdk
+  [[ "$WASM32" == true ]] && add_job wasm-32 "emsdk linux-x86-32" build_wasm_32
+  [[ "$WASM32" == true ]] && has_variant wasm-simd && add_job wasm-32-simd "emsdk linux-x86-32" build_wasm_32_simd
+  [[ "$WASM64" == true ]] && add_job wasm-64 "emsdk linux-x86-64" build_wasm_64
 fi
 
+run_jobs
+
 print_status "✅ ICU build is all complete."
@@ -0,0 +1,85 @@
+# icu-link.cmake: link the static ICU libraries of an extracted package
+#
+# Shipped in every package as lib/cmake/icu/icu-link.cmake.
+#
+# Usage:
+#   include(<package>/lib/cmake/icu/icu-link.cmake)
+#   target_link_icu(my_app)
+#
+# target_link_icu() adds the package include directory, links the ICU
+# libraries in dependency order (addons -> io -> i18n -> uc -> data) and applies the
+# compile/link options the package variant requires. Those options come from
+# icu-package.cmake, which build.sh writes next to this file. For example, the
+# ThinLTO package holds LLVM bitcode archives, so the final link must run
+# ThinLTO with lld.
+
+include_guard(GLOBAL)
+
+get_filename_component(ICU_PACKAGE_ROOT "${CMAKE_CURRENT_LIST_DIR}/../../.." ABSOLUTE)
+
+# Variant settings written by build.sh (may be missing in hand-made packages)
+set(ICU_PACKAGE_TARGET          "")
+set(ICU_PACKAGE_COMPILE_OPTIONS "")
+set(ICU_PACKAGE_LINK_OPTIONS    "")
+set(ICU_PACKAGE_X86_64_LEVEL    "")
+set(ICU_PACKAGE_UCONFIG         "")  # ICU services compiled out (also defined in the package's uconfig.h)
+if(EXISTS "${CMAKE_CURRENT_LIST_DIR}/icu-package.cmake")
+    include("${CMAKE_CURRENT_LIST_DIR}/icu-package.cmake")
+endif()
+
+# The x86-64-vN packages only run on CPUs of that level (see icu-select.cmake)
+if(ICU_PACKAGE_X86_64_LEVEL AND EXISTS "${CMAKE_CURRENT_LIST_DIR}/icu-select.cmake")
+    include("${CMAKE_CURRENT_LIST_DIR}/icu-select.cmake")
+    icu_host_x86_64_level(_icu_host_level)
+    if(_icu_host_level LESS ICU_PACKAGE_X86_64_LEVEL)
+        message(WARNING "The ${ICU_PACKAGE_TARGET} ICU package needs an x86-64-v${ICU_PACKAGE_X86_64_LEVEL} CPU, "
+                        "this host is x86-64-v${_icu_host_level}: programs will stop with an illegal instruction here")
+    endif()
+endif()
+
+# Library names differ between the Unix (icuuc) and MinGW static (sicuuc) builds
+set(ICU_PACKAGE_LIBRARIES "")
+foreach(component io i18n:in uc data:dt)
+    string(REPLACE ":" ";" names "${component}")
+    set(candidates "")
+    foreach(name ${names})
+        list(APPEND candidates icu${name} sicu${name})
+    endforeach()
+    list(GET names 0 component_name)
+    find_library(ICU_PACKAGE_${component_name}_LIBRARY
+        NAMES ${candidates}
+        PATHS "${ICU_PACKAGE_ROOT}/lib"
+        NO_DEFAULT_PATH)
+    if(ICU_PACKAGE_${component_name}_LIBRARY)
+        list(APPEND ICU_PACKAGE_LIBRARIES ${ICU_PACKAGE_${component_name}_LIBRARY})
+    else()
+        message(WARNING "ICU library not found in package: ${component_name}")
+    endif()
+endforeach()
+
+# Optional helpers built with the package (include/icuaddons, e.g. the allocation hooks).
+# Static, so nothing is linked in unless the application uses it.
+find_library(ICU_PACKAGE_ADDONS_LIBRARY
+    NAMES icuaddons
+    PATHS "${ICU_PACKAGE_ROOT}/lib"
+    NO_DEFAULT_PATH)
+
+function(target_link_icu TARGET)
+    target_include_directories(${TARGET} PRIVATE "${ICU_PACKAGE_ROOT}/include")
+    target_compile_definitions(${TARGET} PRIVATE U_STATIC_IMPLEMENTATION)
+    if(ICU_PACKAGE_ADDONS_LIBRARY)
+        target_link_libraries(${TARGET} ${ICU_PACKAGE_ADDONS_LIBRARY})
+    endif()
+    target_link_libraries(${TARGET} ${ICU_PACKAGE_LIBRARIES})
+    if(UNIX)
+        target_link_libraries(${TARGET} pthread dl m)
+    endif()
+
+    if(ICU_PACKAGE_COMPILE_OPTIONS OR ICU_PACKAGE_LINK_OPTIONS)
+        if(ICU_PACKAGE_REQUIRES_CLANG AND NOT CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+            message(FATAL_ERROR "The ${ICU_PACKAGE_TARGET} ICU package must be linked with Clang (found ${CMAKE_CXX_COMPILER_ID})")
+        endif()
+        target_compile_options(${TARGET} PRIVATE ${ICU_PACKAGE_COMPILE_OPTIONS})
+        target_link_options(${TARGET} PRIVATE ${ICU_PACKAGE_LINK_OPTIONS})
+    endif()
+endfunction()
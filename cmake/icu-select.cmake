@@ -0,0 +1,106 @@
+# icu-select.cmake: pick the linux-x86-64 package built for the host CPU
+#
+# Shipped in every package as lib/cmake/icu/icu-select.cmake.
+#
+# Usage:
+#   include(icu-select.cmake)
+#   icu_select_package(ICU_ROOT "/opt/icu")   # /opt/icu/<any name>/ per extracted package
+#   include("${ICU_ROOT}/lib/cmake/icu/icu-link.cmake")
+#
+# The linux-x86-64-v2/v3/v4 packages are compiled with -march=x86-64-vN and
+# stop with SIGILL on a CPU below that level. icu_select_package() probes the
+# host once and returns the highest-level linux-x86-64 package it can run,
+# falling back to the generic one. Set ICU_HOST_X86_64_LEVEL to override the
+# probe, e.g. when configuring on a build machine for a different fleet.
+
+include_guard(GLOBAL)
+
+# The x86-64 microarchitecture level of the host: 1 to 4, or 0 if not x86-64.
+# When cross-compiling this is 1, the level every x86-64 CPU supports.
+function(icu_host_x86_64_level OUT_VAR)
+    if(DEFINED ICU_HOST_X86_64_LEVEL)
+        set(${OUT_VAR} ${ICU_HOST_X86_64_LEVEL} PARENT_SCOPE)
+        return()
+    endif()
+
+    if(CMAKE_CROSSCOMPILING)
+        # The probe cannot run here: only the baseline is safe for the target
+        set(level 1)
+    elseif(NOT CMAKE_HOST_SYSTEM_PROCESSOR MATCHES "^(x86_64|AMD64|amd64)$")
+        set(level 0)
+    else()
+        set(probe_dir "${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/icu-select")
+        file(WRITE "${probe_dir}/x86-64-level.cpp" [=[
+#include <cstdio>
+int main() {
+    int level = 1;
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("ssse3")  && __builtin_cpu_supports("sse4.1")
+     && __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt")) {
+        level = 2;
+        if (__builtin_cpu_supports("avx") && __builtin_cpu_supports("avx2")
+         && __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2")
+         && __builtin_cpu_supports("fma")) {
+            level = 3;
+            if (__builtin_cpu_supports("avx512f")  && __builtin_cpu_supports("avx512bw")
+             && __builtin_cpu_supports("avx512cd") && __builtin_cpu_supports("avx512dq")
+             && __builtin_cpu_supports("avx512vl")) {
+                level = 4;
+            }
+        }
+    }
+#endif
+    std::printf("%d", level);
+    return 0;
+}
+]=])
+        try_run(run_result compile_result
+            "${probe_dir}/build" "${probe_dir}/x86-64-level.cpp"
+            RUN_OUTPUT_VARIABLE run_output)
+        if(compile_result AND run_result EQUAL 0 AND run_output MATCHES "^[1-4]$")
+            set(level ${run_output})
+        else()
+            message(WARNING "Could not detect the x86-64 level of this host; assuming the baseline")
+            set(level 1)
+        endif()
+    endif()
+
+    set(ICU_HOST_X86_64_LEVEL ${level} CACHE STRING "x86-64 microarchitecture level of the host (1-4, 0: not x86-64)")
+    set(${OUT_VAR} ${level} PARENT_SCOPE)
+endfunction()
+
+# Set OUT_VAR to the package directory under PACKAGES_DIR with the highest
+# x86-64 level the host supports. Other variants (pgo, thinlto, ...) are not
+# considered. Fails if no suitable linux-x86-64 package is found.
+function(icu_select_package OUT_VAR PACKAGES_DIR)
+    icu_host_x86_64_level(host_level)
+
+    set(best_root  "")
+    set(best_level -1)
+    file(GLOB candidates LIST_DIRECTORIES true "${PACKAGES_DIR}/*")
+    foreach(candidate ${candidates})
+        if(NOT EXISTS "${candidate}/lib/cmake/icu/icu-package.cmake")
+            continue()
+        endif()
+        set(ICU_PACKAGE_TARGET         "")
+        set(ICU_PACKAGE_X86_64_LEVEL   "")
+        include("${candidate}/lib/cmake/icu/icu-package.cmake")
+        if(NOT ICU_PACKAGE_TARGET MATCHES "^linux-x86-64(-v[2-4])?$")
+            continue()
+        endif()
+        if(NOT ICU_PACKAGE_X86_64_LEVEL)
+            set(ICU_PACKAGE_X86_64_LEVEL 1)
+        endif()
+        if(ICU_PACKAGE_X86_64_LEVEL LESS_EQUAL host_level AND ICU_PACKAGE_X86_64_LEVEL GREATER best_level)
+            set(best_root  "${candidate}")
+            set(best_level ${ICU_PACKAGE_X86_64_LEVEL})
+        endif()
+    endforeach()
+
+    if(NOT best_root)
+        message(FATAL_ERROR "No linux-x86-64 ICU package in ${PACKAGES_DIR} runs on this host (x86-64-v${host_level})")
+    endif()
+    message(STATUS "Selected ICU package for x86-64-v${host_level} host: ${best_root}")
+    set(${OUT_VAR} "${best_root}" PARENT_SCOPE)
+endfunction()
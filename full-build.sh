@@ -73,7 +73,9 @@ docker build . \
 
 
 print_section "Run the container with volume mapping for dist"
-docker run --rm -v "$WORKDIR:/app/build" -v "$DISTDIR:/app/dist" icu4c-builder:latest "$@"
+docker run --rm -v "$WORKDIR:/app/build" -v "$DISTDIR:/app/dist"  \
+  -e BUILD_JOBS -e MAX_PARALLEL_TARGETS -e BUILD_CACHE             \
+  icu4c-builder:latest "$@"
 
 
 
@@ -0,0 +1,148 @@
+/*
+ * Allocation-heavy workloads: creating and destroying ICU service objects.
+ *
+ * Every create call clones cached data into a new object graph, so the
+ * allocator is a large part of the cost, and with several threads the heap
+ * becomes a point of contention. Each workload runs on one thread and then
+ * on kThreads threads at once.
+ *
+ * Compare allocators by running the suite with --allocator system and
+ * --allocator pool (icuaddons/memory.h). With --count-allocations the
+ * results also carry allocations_per_op and bytes_per_op.
+ */
+
+#include "suites.h"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <icuaddons/memory.h>
+
+#include <unicode/brkiter.h>
+#include <unicode/coll.h>
+#include <unicode/datefmt.h>
+#include <unicode/locid.h>
+#include <unicode/numfmt.h>
+#include <unicode/translit.h>
+#include <unicode/ucnv.h>
+#include <unicode/unistr.h>
+
+namespace icubench {
+
+namespace {
+
+// Threads of the contended runs.
+constexpr size_t kThreads = 8;
+
+struct CreateWorkload {
+    const char* name;
+    std::function<UErrorCode()> createAndDestroy;
+};
+
+template <typename T>
+UErrorCode destroy(T* object, UErrorCode status) {
+    delete object;
+    return status;
+}
+
+const std::vector<CreateWorkload>& createWorkloads() {
+    static const std::vector<CreateWorkload> all = {
+        {"Collator::createInstance/en", [] {
+            UErrorCode status = U_ZERO_ERROR;
+            return destroy(icu::Collator::createInstance(icu::Locale::getEnglish(), status), status);
+        }},
+        {"Collator::createInstance/ja", [] {
+            UErrorCode status = U_ZERO_ERROR;
+            return destroy(icu::Collator::createInstance(icu::Locale::getJapanese(), status), status);
+        }},
+        {"BreakIterator::createWordInstance/en", [] {
+            UErrorCode status = U_ZERO_ERROR;
+            return destroy(icu::BreakIterator::createWordInstance(icu::Locale::getEnglish(), status), status);
+        }},
+        {"BreakIterator::createLineInstance/ja", [] {
+            UErrorCode status = U_ZERO_ERROR;
+            return destroy(icu::BreakIterator::createLineInstance(icu::Locale::getJapanese(), status), status);
+        }},
+        {"Transliterator::createInstance/Latin-Cyrillic", [] {
+            UErrorCode status = U_ZERO_ERROR;
+            return destroy(icu::Transliterator::createInstance("Latin-Cyrillic", UTRANS_FORWARD, status), status);
+        }},
+        {"NumberFormat::createInstance/de", [] {
+            UErrorCode status = U_ZERO_ERROR;
+            return destroy(icu::NumberFormat::createInstance(icu::Locale::getGermany(), status), status);
+        }},
+        {"DateFormat::createDateTimeInstance/fr", [] {
+            return destroy(icu::DateFormat::createDateTimeInstance(icu::DateFormat::kMedium, icu::DateFormat::kMedium,
+                                                                   icu::Locale::getFrance()), U_ZERO_ERROR);
+        }},
+        {"ucnv_open/Shift-JIS", [] {
+            UErrorCode status = U_ZERO_ERROR;
+            ucnv_close(ucnv_open("Shift-JIS", &status));
+            return status;
+        }},
+        {"UnicodeString/append-64", [] {
+            // Growing a string reallocates its buffer through the ICU allocator
+            icu::UnicodeString text;
+            for (int i = 0; i < 64; ++i) {
+                text.append(u"allocation ");
+            }
+            keep(text.length());
+            return U_ZERO_ERROR;
+        }},
+    };
+    return all;
+}
+
+bool threadsSupported() {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    return false;
+#else
+    return true;
+#endif
+}
+
+} // namespace
+
+void runAllocationSuite(Runner& runner) {
+    const std::string unit = "create+destroy";
+    for (const auto& entry : createWorkloads()) {
+        const Workload single{"allocation", entry.name, "", unit};
+        const Workload threaded{"allocation", std::string(entry.name) + "/threads=" + std::to_string(kThreads), "", unit};
+
+        UErrorCode status = entry.createAndDestroy();
+        if (U_FAILURE(status)) {
+            runner.skip(single, u_errorName(status));
+            runner.skip(threaded, u_errorName(status));
+            continue;
+        }
+
+        Result* result = runner.measure(single, 1, [&](size_t) {
+            entry.createAndDestroy();
+            return Work{};
+        });
+        if (result != nullptr && runner.options().countAllocations) {
+            icuaddons::AllocationScope scope;
+            entry.createAndDestroy();
+            icuaddons::AllocationCounters counters = scope.counters();
+            result->metrics["allocations_per_op"] = static_cast<double>(counters.allocations + counters.reallocations);
+            result->metrics["bytes_per_op"]       = static_cast<double>(counters.bytes);
+        }
+
+        if (!threadsSupported()) {
+            runner.skip(threaded, "threads are not supported on this platform");
+            continue;
+        }
+        // About --min-time per thread, based on the single-threaded latency
+        double meanNs = result != nullptr ? std::max(result->meanNs, 1.0) : 1e5;
+        size_t iterations = std::clamp<size_t>(static_cast<size_t>(runner.options().minSeconds * 1e9 / meanNs), 20, 200000);
+        runner.measureThreads(threaded, kThreads, iterations, [&](size_t, size_t) {
+            entry.createAndDestroy();
+            return Work{};
+        });
+    }
+}
+
+} // namespace icubench
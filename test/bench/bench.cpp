@@ -0,0 +1,287 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include <unicode/uversion.h>
+
+namespace icubench {
+
+namespace {
+
+std::string jsonEscape(const std::string& text) {
+    std::string out;
+    out.reserve(text.size() + 2);
+    for (unsigned char c : text) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n";  break;
+            case '\r': out += "\\r";  break;
+            case '\t': out += "\\t";  break;
+            default:
+                if (c < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    out += buffer;
+                } else {
+                    out += static_cast<char>(c);
+                }
+        }
+    }
+    return out;
+}
+
+std::string jsonNumber(double value) {
+    if (!std::isfinite(value)) {
+        return "null";
+    }
+    std::ostringstream out;
+    out << std::setprecision(6) << value;
+    return out.str();
+}
+
+const char* osName() {
+#if defined(__EMSCRIPTEN__)
+    return "emscripten";
+#elif defined(_WIN32)
+    return "windows";
+#elif defined(__APPLE__)
+    return "macos";
+#elif defined(__linux__)
+    return "linux";
+#else
+    return "unknown";
+#endif
+}
+
+const char* archName() {
+#if defined(__x86_64__) || defined(_M_X64)
+    return "x86_64";
+#elif defined(__i386__) || defined(_M_IX86)
+    return "x86";
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    return "arm64";
+#elif defined(__wasm64__)
+    return "wasm64";
+#elif defined(__wasm32__)
+    return "wasm32";
+#else
+    return "unknown";
+#endif
+}
+
+std::string compilerName() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + std::to_string(_MSC_VER);
+#else
+    return "unknown";
+#endif
+}
+
+std::string timestamp() {
+    std::time_t now = std::time(nullptr);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return buffer;
+}
+
+} // namespace
+
+int hostX86_64Level() {
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    // Same checks as cmake/icu-select.cmake
+    __builtin_cpu_init();
+    if (!(__builtin_cpu_supports("ssse3")  && __builtin_cpu_supports("sse4.1")
+       && __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt"))) {
+        return 1;
+    }
+    if (!(__builtin_cpu_supports("avx") && __builtin_cpu_supports("avx2")
+       && __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2")
+       && __builtin_cpu_supports("fma"))) {
+        return 2;
+    }
+    if (!(__builtin_cpu_supports("avx512f")  && __builtin_cpu_supports("avx512bw")
+       && __builtin_cpu_supports("avx512cd") && __builtin_cpu_supports("avx512dq")
+       && __builtin_cpu_supports("avx512vl"))) {
+        return 3;
+    }
+    return 4;
+#elif defined(_M_X64) || defined(_M_IX86)
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0;
+    }
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * values.size()));
+    rank = std::clamp<size_t>(rank, 1, values.size()) - 1;
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank];
+}
+
+std::string formatNanos(double ns) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    if (ns < 1e3) {
+        out << ns << " ns";
+    } else if (ns < 1e6) {
+        out << ns / 1e3 << " µs";
+    } else if (ns < 1e9) {
+        out << ns / 1e6 << " ms";
+    } else {
+        out << ns / 1e9 << " s";
+    }
+    return out.str();
+}
+
+bool Runner::suiteEnabled(const std::string& suite) const {
+    if (options_.suites.empty()) {
+        return true;
+    }
+    return std::find(options_.suites.begin(), options_.suites.end(), suite) != options_.suites.end();
+}
+
+bool Runner::selected(const std::string& suite, const std::string& name) const {
+    if (!suiteEnabled(suite)) {
+        return false;
+    }
+    if (options_.filter.empty()) {
+        return true;
+    }
+    return (suite + "/" + name).find(options_.filter) != std::string::npos;
+}
+
+Result& Runner::record(const Workload& workload, std::vector<double>& samplesNs, uint64_t bytes, uint64_t ops, double seconds) {
+    Result result;
+    result.workload = workload;
+    result.samples  = samplesNs.size();
+    result.bytes    = bytes;
+    result.ops      = ops;
+    result.seconds  = seconds;
+    if (!samplesNs.empty()) {
+        result.p50Ns  = percentile(samplesNs, 50);
+        result.p99Ns  = percentile(samplesNs, 99);
+        result.minNs  = *std::min_element(samplesNs.begin(), samplesNs.end());
+        result.maxNs  = *std::max_element(samplesNs.begin(), samplesNs.end());
+        double sum = 0;
+        for (double sample : samplesNs) {
+            sum += sample;
+        }
+        result.meanNs = sum / samplesNs.size();
+    }
+    results_.push_back(result);
+    print(results_.back());
+    return results_.back();
+}
+
+void Runner::skip(const Workload& workload, const std::string& reason) {
+    if (!selected(workload.suite, workload.name) || options_.listOnly) {
+        return;
+    }
+    std::cout << "  ⚠️ " << workload.suite << "/" << workload.name << " skipped: " << reason << std::endl;
+}
+
+void Runner::listed(const Workload& workload) {
+    std::cout << "  " << workload.suite << "/" << workload.name
+              << " [" << workload.corpus << ", per " << workload.unit << "]" << std::endl;
+}
+
+void Runner::print(const Result& result) const {
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(2);
+    line << "  ✅ " << std::left << std::setw(40) << (result.workload.suite + "/" + result.workload.name);
+    if (result.bytes > 0) {
+        line << std::right << std::setw(10) << result.mbPerSecond() << " MB/s";
+    }
+    line << std::right << std::setw(12) << result.opsPerSecond() / 1e3 << " Kops/s";
+    line << "  p50 " << formatNanos(result.p50Ns)
+         << "  p99 " << formatNanos(result.p99Ns)
+         << "  (per " << result.workload.unit << ")";
+    std::cout << line.str() << std::endl;
+}
+
+bool Runner::writeJson(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "❌ Cannot write benchmark results to " << path << std::endl;
+        return false;
+    }
+
+    UVersionInfo versionInfo;
+    u_getVersion(versionInfo);
+    char versionString[U_MAX_VERSION_STRING_LENGTH];
+    u_versionToString(versionInfo, versionString);
+
+    out << "{\n";
+    out << "  \"schema\": \"icu4c-benchmark/1\",\n";
+    out << "  \"label\": \"" << jsonEscape(options_.label) << "\",\n";
+    out << "  \"timestamp\": \"" << timestamp() << "\",\n";
+    out << "  \"icu_version\": \"" << versionString << "\",\n";
+    out << "  \"host\": {\n";
+    out << "    \"os\": \"" << osName() << "\",\n";
+    out << "    \"arch\": \"" << archName() << "\",\n";
+    out << "    \"x86_64_level\": " << hostX86_64Level() << ",\n";
+    out << "    \"cores\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "    \"compiler\": \"" << jsonEscape(compilerName()) << "\"\n";
+    out << "  },\n";
+    out << "  \"options\": {\n";
+    out << "    \"min_seconds\": " << jsonNumber(options_.minSeconds) << ",\n";
+    out << "    \"min_samples\": " << options_.minSamples << ",\n";
+    out << "    \"scale\": " << options_.scale << ",\n";
+    out << "    \"allocator\": \"" << jsonEscape(options_.allocator.empty() ? "default" : options_.allocator) << "\"\n";
+    out << "  },\n";
+    out << "  \"results\": [";
+    for (size_t i = 0; i < results_.size(); ++i) {
+        const Result& r = results_[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\n";
+        out << "      \"suite\": \""    << jsonEscape(r.workload.suite)  << "\",\n";
+        out << "      \"workload\": \"" << jsonEscape(r.workload.name)   << "\",\n";
+        out << "      \"corpus\": \""   << jsonEscape(r.workload.corpus) << "\",\n";
+        out << "      \"unit\": \""     << jsonEscape(r.workload.unit)   << "\",\n";
+        out << "      \"samples\": "    << r.samples << ",\n";
+        out << "      \"bytes\": "      << r.bytes   << ",\n";
+        out << "      \"ops\": "        << r.ops     << ",\n";
+        out << "      \"seconds\": "    << jsonNumber(r.seconds)        << ",\n";
+        out << "      \"mb_per_s\": "   << jsonNumber(r.mbPerSecond())  << ",\n";
+        out << "      \"ops_per_s\": "  << jsonNumber(r.opsPerSecond()) << ",\n";
+        out << "      \"latency_ns\": {"
+            << "\"p50\": "  << jsonNumber(r.p50Ns)  << ", "
+            << "\"p99\": "  << jsonNumber(r.p99Ns)  << ", "
+            << "\"mean\": " << jsonNumber(r.meanNs) << ", "
+            << "\"min\": "  << jsonNumber(r.minNs)  << ", "
+            << "\"max\": "  << jsonNumber(r.maxNs)  << "}";
+        if (!r.metrics.empty()) {
+            out << ",\n      \"metrics\": {";
+            bool first = true;
+            for (const auto& [key, value] : r.metrics) {
+                out << (first ? "" : ", ") << "\"" << jsonEscape(key) << "\": " << jsonNumber(value);
+                first = false;
+            }
+            out << "}";
+        }
+        out << "\n    }";
+    }
+    out << (results_.empty() ? "]\n" : "\n  ]\n");
+    out << "}\n";
+
+    std::cout << "\n📄 Benchmark results written to " << path << std::endl;
+    return static_cast<bool>(out);
+}
+
+} // namespace icubench
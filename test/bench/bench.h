@@ -0,0 +1,311 @@
+#pragma once
+
+/*
+ * ICU4C Package Benchmark - shared harness
+ *
+ * A tiny, dependency-free timing harness used by all benchmark suites.
+ * Each workload is a callable that processes one "unit" of input (a document,
+ * a batch of string pairs, ...) and reports how many input bytes and logical
+ * operations it covered. The runner calls it repeatedly, cycling through the
+ * units of a corpus, and records one latency sample per call.
+ *
+ * Throughput (MB/s, ops/s) is computed from the summed sample time, so loop
+ * and bookkeeping overhead is excluded. Latency percentiles are per call.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace icubench {
+
+// Prevent the optimizer from discarding a computed value.
+template <typename T>
+inline void keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+using Clock = std::chrono::steady_clock;
+
+// What a single workload call processed.
+struct Work {
+    uint64_t bytes = 0;  // Input bytes (UTF-8 length of the input, unless stated otherwise)
+    uint64_t ops   = 1;  // Logical operations (comparisons, boundaries, records, ...)
+};
+
+// Identifies a workload in reports and in the JSON output.
+struct Workload {
+    std::string suite;       // e.g. "collation"
+    std::string name;        // e.g. "compare/en"
+    std::string corpus;      // e.g. "multilingual-words"
+    std::string unit;        // What one latency sample covers, e.g. "document" or "32 pairs"
+};
+
+struct Result {
+    Workload    workload;
+    uint64_t    samples = 0;
+    uint64_t    bytes   = 0;
+    uint64_t    ops     = 0;
+    double      seconds = 0;
+    double      p50Ns   = 0;
+    double      p99Ns   = 0;
+    double      meanNs  = 0;
+    double      minNs   = 0;
+    double      maxNs   = 0;
+    std::map<std::string, double> metrics;  // Suite-specific extra numbers
+
+    double mbPerSecond()  const { return seconds > 0 ? bytes / 1e6 / seconds : 0; }
+    double opsPerSecond() const { return seconds > 0 ? ops / seconds : 0; }
+};
+
+struct Options {
+    std::vector<std::string> suites;          // Empty means all suites
+    std::string filter;                       // Substring match on "suite/name"
+    std::string jsonPath;                     // Where to write JSON results (empty: none)
+    std::string label;                        // Free-form label stored in the JSON (e.g. package name)
+    double      minSeconds       = 0.5;       // Minimum measured time per workload
+    uint64_t    minSamples       = 10;        // Minimum number of samples per workload
+    uint64_t    maxSamples       = 1000000;   // Upper bound on stored samples per workload
+    size_t      scale            = 1;         // Corpus size multiplier
+    bool        listOnly         = false;
+    std::string startupProbe;                 // Internal: run one cold-start probe and exit (see startup suite)
+    std::string allocator;                    // ICU allocation functions: empty (ICU default), "system" or "pool"
+    bool        countAllocations = false;     // Report allocations per operation (allocation and formatting suites)
+    std::vector<size_t> threadCounts;         // Thread counts of the threads, sort, search and tokenize suites (empty: suite default)
+    std::vector<size_t> sortSizes;            // Strings per sort in the sort suite (empty: 100k and 1M times scale)
+    size_t      streamMegabytes  = 256;       // Input file size of the streaming suite
+    std::string streamProbe;                  // Internal: run one streaming pass and exit (see streaming suite)
+    std::string streamFile;                   // Internal: input file of that pass
+};
+
+class Runner {
+public:
+    explicit Runner(const Options& options) : options_(options) {}
+
+    const Options& options() const { return options_; }
+
+    // Whether a suite was requested on the command line.
+    bool suiteEnabled(const std::string& suite) const;
+
+    // Whether a workload passes the suite and --filter selection.
+    bool selected(const std::string& suite, const std::string& name) const;
+
+    // Time `op(i)` for i = 0 .. units-1 (wrapping) until the time and sample
+    // minimums are met and every unit ran at least once.
+    template <typename Op>
+    Result* measure(const Workload& workload, size_t units, Op&& op) {
+        if (!selected(workload.suite, workload.name) || units == 0) {
+            return nullptr;
+        }
+        if (options_.listOnly) {
+            listed(workload);
+            return nullptr;
+        }
+
+        // Warm up caches and lazily-initialized ICU state.
+        for (size_t i = 0; i < units && i < 8; ++i) {
+            keep(op(i));
+        }
+
+        std::vector<double> samples;
+        samples.reserve(1024);
+        uint64_t bytes = 0;
+        uint64_t ops   = 0;
+        double   total = 0;
+        size_t   index = 0;
+        bool     fullPass = false;
+        while (true) {
+            auto start = Clock::now();
+            Work work  = op(index);
+            auto end   = Clock::now();
+
+            double ns = std::chrono::duration<double, std::nano>(end - start).count();
+            samples.push_back(ns);
+            total += ns;
+            bytes += work.bytes;
+            ops   += work.ops;
+
+            if (++index == units) {
+                index    = 0;
+                fullPass = true;
+            }
+            if (fullPass
+             && samples.size() >= options_.minSamples
+             && total >= options_.minSeconds * 1e9) {
+                break;
+            }
+            if (samples.size() >= options_.maxSamples) {
+                break;
+            }
+        }
+        return &record(workload, samples, bytes, ops, total / 1e9);
+    }
+
+    // Like measure(), but `op(i)` times itself and returns one operation's
+    // latency in nanoseconds (for example a probe run in a child process), or a
+    // negative value on failure. The time minimum applies to the wall time
+    // spent in `op`. Returns nullptr if the workload was not run or failed.
+    template <typename Op>
+    Result* measureReported(const Workload& workload, size_t units, Op&& op) {
+        if (!selected(workload.suite, workload.name) || units == 0) {
+            return nullptr;
+        }
+        if (options_.listOnly) {
+            listed(workload);
+            return nullptr;
+        }
+
+        std::vector<double> samples;
+        double total = 0;
+        auto   start = Clock::now();
+        for (size_t index = 0; ; index = (index + 1) % units) {
+            double ns = op(index);
+            if (ns < 0) {
+                return nullptr;
+            }
+            samples.push_back(ns);
+            total += ns;
+
+            double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+            if (samples.size() >= units
+             && samples.size() >= options_.minSamples
+             && elapsed >= options_.minSeconds) {
+                break;
+            }
+            if (samples.size() >= options_.maxSamples) {
+                break;
+            }
+        }
+        return &record(workload, samples, 0, samples.size(), total / 1e9);
+    }
+
+    // Like measure(), for calls that each take a long time (sorting a million
+    // strings): runs `op()` once, then again until --min-time has passed or
+    // `maxRuns` runs were timed. The minimum sample count does not apply.
+    template <typename Op>
+    Result* measureLong(const Workload& workload, size_t maxRuns, Op&& op) {
+        if (!selected(workload.suite, workload.name) || maxRuns == 0) {
+            return nullptr;
+        }
+        if (options_.listOnly) {
+            listed(workload);
+            return nullptr;
+        }
+
+        std::vector<double> samples;
+        uint64_t bytes = 0;
+        uint64_t ops   = 0;
+        double   total = 0;
+        while (samples.size() < maxRuns && (samples.empty() || total < options_.minSeconds * 1e9)) {
+            auto start = Clock::now();
+            Work work  = op();
+            auto end   = Clock::now();
+
+            double ns = std::chrono::duration<double, std::nano>(end - start).count();
+            samples.push_back(ns);
+            total += ns;
+            bytes += work.bytes;
+            ops   += work.ops;
+        }
+        return &record(workload, samples, bytes, ops, total / 1e9);
+    }
+
+    // Run `op(thread, i)` for i = 0 .. iterations-1 on `threads` threads that
+    // start together. Every call is one latency sample; throughput uses the
+    // wall time of the whole run, so it shows how the calls scale when the
+    // threads compete for shared state such as the heap.
+    template <typename Op>
+    Result* measureThreads(const Workload& workload, size_t threads, size_t iterations, Op&& op) {
+        if (!selected(workload.suite, workload.name) || threads == 0 || iterations == 0) {
+            return nullptr;
+        }
+        if (options_.listOnly) {
+            listed(workload);
+            return nullptr;
+        }
+
+        std::vector<std::vector<double>> perThread(threads);
+        std::vector<uint64_t>            threadBytes(threads);
+        std::vector<uint64_t>            threadOps(threads);
+        std::atomic<size_t>              ready{0};
+        std::atomic<bool>                go{false};
+        std::vector<std::thread>         workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                perThread[t].reserve(iterations);
+                keep(op(t, 0));  // Warm up thread-local state
+                ready.fetch_add(1);
+                while (!go.load()) {
+                    std::this_thread::yield();
+                }
+                for (size_t i = 0; i < iterations; ++i) {
+                    auto start = Clock::now();
+                    Work work  = op(t, i);
+                    auto end   = Clock::now();
+                    perThread[t].push_back(std::chrono::duration<double, std::nano>(end - start).count());
+                    threadBytes[t] += work.bytes;
+                    threadOps[t]   += work.ops;
+                }
+            });
+        }
+        while (ready.load() < threads) {
+            std::this_thread::yield();
+        }
+        auto start = Clock::now();
+        go.store(true);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::vector<double> samples;
+        uint64_t bytes = 0;
+        uint64_t ops   = 0;
+        for (size_t t = 0; t < threads; ++t) {
+            samples.insert(samples.end(), perThread[t].begin(), perThread[t].end());
+            bytes += threadBytes[t];
+            ops   += threadOps[t];
+        }
+        return &record(workload, samples, bytes, ops, seconds);
+    }
+
+    // Record a result computed outside of measure() (e.g. multi-threaded runs).
+    Result& record(const Workload& workload, std::vector<double>& samplesNs, uint64_t bytes, uint64_t ops, double seconds);
+
+    // Print a skip notice (for example when a service is unavailable in this package).
+    void skip(const Workload& workload, const std::string& reason);
+
+    const std::deque<Result>& results() const { return results_; }
+
+    // Write all results as JSON. Returns false if the file could not be written.
+    bool writeJson(const std::string& path) const;
+
+private:
+    void listed(const Workload& workload);
+    void print(const Result& result) const;
+
+    Options             options_;
+    std::deque<Result>  results_;  // Deque keeps returned Result pointers stable
+};
+
+// The x86-64 microarchitecture level (1-4) of the CPU running the benchmark,
+// or 0 on other architectures.
+int hostX86_64Level();
+
+// Summary statistics helpers.
+double percentile(std::vector<double> values, double p);
+
+// Human-readable duration, e.g. "1.23 µs".
+std::string formatNanos(double ns);
+
+} // namespace icubench
@@ -0,0 +1,148 @@
+/*
+ * Call-overhead workloads: tight loops over tiny ICU entry points
+ * (character properties, UnicodeString accessors, ucnv_getNextUChar).
+ *
+ * The work per call is small, so the cost is dominated by the call itself.
+ * Comparing these numbers between the regular archives and the ThinLTO
+ * package shows how much cross-library inlining saves
+ * (see test/compare-thinlto.sh).
+ */
+
+#include "corpus.h"
+#include "suites.h"
+
+#include <string>
+#include <vector>
+
+#include <unicode/uchar.h>
+#include <unicode/ucnv.h>
+#include <unicode/unistr.h>
+#include <unicode/uscript.h>
+#include <unicode/utf8.h>
+
+namespace icubench {
+
+namespace {
+
+// Calls per latency sample; large enough to hide the timer overhead.
+constexpr size_t kBatch = 256;
+
+std::vector<UChar32> codePoints(const Corpus& corpus) {
+    std::vector<UChar32> out;
+    for (const auto& item : corpus.items) {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(item.data());
+        const int32_t length = static_cast<int32_t>(item.size());
+        for (int32_t i = 0; i < length;) {
+            UChar32 c;
+            U8_NEXT(bytes, i, length, c);
+            out.push_back(c);
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+void runCallsSuite(Runner& runner) {
+    const Corpus corpus = multilingualDocuments(runner.options().scale);
+    const std::vector<UChar32> chars = codePoints(corpus);
+    const size_t units = chars.size() / kBatch;
+    const std::string unit = std::to_string(kBatch) + " calls";
+
+    runner.measure({"calls", "u_charType", corpus.name, unit}, units, [&](size_t u) {
+        int32_t sum = 0;
+        for (size_t k = u * kBatch; k < (u + 1) * kBatch; ++k) {
+            sum += u_charType(chars[k]);
+        }
+        keep(sum);
+        return Work{0, kBatch};
+    });
+
+    runner.measure({"calls", "u_tolower", corpus.name, unit}, units, [&](size_t u) {
+        UChar32 sum = 0;
+        for (size_t k = u * kBatch; k < (u + 1) * kBatch; ++k) {
+            sum += u_tolower(chars[k]);
+        }
+        keep(sum);
+        return Work{0, kBatch};
+    });
+
+    runner.measure({"calls", "uscript_getScript", corpus.name, unit}, units, [&](size_t u) {
+        UErrorCode error = U_ZERO_ERROR;
+        int32_t sum = 0;
+        for (size_t k = u * kBatch; k < (u + 1) * kBatch; ++k) {
+            sum += uscript_getScript(chars[k], &error);
+        }
+        keep(sum);
+        return Work{0, kBatch};
+    });
+
+    // UnicodeString accessors; charAt() and char32At() are out-of-line in libicuuc.
+    std::vector<icu::UnicodeString> texts;
+    for (const auto& item : corpus.items) {
+        texts.push_back(icu::UnicodeString::fromUTF8(item));
+    }
+    runner.measure({"calls", "UnicodeString::charAt", corpus.name, "document"}, texts.size(), [&](size_t i) {
+        const icu::UnicodeString& text = texts[i];
+        uint32_t sum = 0;
+        const int32_t length = text.length();
+        for (int32_t k = 0; k < length; ++k) {
+            sum += text.charAt(k);
+        }
+        keep(sum);
+        return Work{corpus.items[i].size(), static_cast<uint64_t>(length)};
+    });
+
+    runner.measure({"calls", "UnicodeString::char32At", corpus.name, "document"}, texts.size(), [&](size_t i) {
+        const icu::UnicodeString& text = texts[i];
+        uint32_t sum = 0;
+        uint64_t calls = 0;
+        const int32_t length = text.length();
+        for (int32_t k = 0; k < length; k = text.moveIndex32(k, 1)) {
+            sum += text.char32At(k);
+            ++calls;
+        }
+        keep(sum);
+        return Work{corpus.items[i].size(), calls};
+    });
+
+    // ucnv_getNextUChar: one call per decoded code point.
+    for (const char* charset : {"UTF-8", "Shift-JIS"}) {
+        UErrorCode status = U_ZERO_ERROR;
+        UConverter* converter = ucnv_open(charset, &status);
+        if (U_FAILURE(status)) {
+            runner.skip({"calls", std::string("ucnv_getNextUChar/") + charset, corpus.name, ""}, u_errorName(status));
+            continue;
+        }
+
+        std::vector<std::string> encoded;
+        const Corpus documents = std::string(charset) == "UTF-8" ? corpus : documentsFor("documents-ja", {"ja"}, runner.options().scale);
+        for (const auto& item : documents.items) {
+            icu::UnicodeString text = icu::UnicodeString::fromUTF8(item);
+            std::string bytes(text.length() * 4 + 4, '\0');
+            int32_t length = ucnv_fromUChars(converter, bytes.data(), static_cast<int32_t>(bytes.size()),
+                                             text.getBuffer(), text.length(), &status);
+            bytes.resize(U_SUCCESS(status) ? length : 0);
+            encoded.push_back(std::move(bytes));
+        }
+
+        runner.measure({"calls", std::string("ucnv_getNextUChar/") + charset, documents.name, "document"}, encoded.size(), [&](size_t i) {
+            UErrorCode error = U_ZERO_ERROR;
+            ucnv_resetToUnicode(converter);
+            const char* source = encoded[i].data();
+            const char* limit  = source + encoded[i].size();
+            UChar32 sum = 0;
+            uint64_t calls = 0;
+            while (source < limit && U_SUCCESS(error)) {
+                sum += ucnv_getNextUChar(converter, &source, limit, &error);
+                ++calls;
+            }
+            keep(sum);
+            return Work{encoded[i].size(), calls};
+        });
+
+        ucnv_close(converter);
+    }
+}
+
+} // namespace icubench
@@ -0,0 +1,314 @@
+/*
+ * Core workloads: the ICU services exercised by test.cpp (collation,
+ * break iteration, transliteration, conversion) plus normalization and
+ * UTF-8/UTF-16 conversion, measured over the fixed corpora in corpus.h.
+ */
+
+#include "corpus.h"
+#include "suites.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <unicode/brkiter.h>
+#include <unicode/bytestream.h>
+#include <unicode/coll.h>
+#include <unicode/locid.h>
+#include <unicode/normalizer2.h>
+#include <unicode/translit.h>
+#include <unicode/ucnv.h>
+#include <unicode/unistr.h>
+#include <unicode/ustring.h>
+
+namespace icubench {
+
+namespace {
+
+std::vector<icu::UnicodeString> toUnicode(const Corpus& corpus) {
+    std::vector<icu::UnicodeString> out;
+    out.reserve(corpus.items.size());
+    for (const auto& item : corpus.items) {
+        out.push_back(icu::UnicodeString::fromUTF8(item));
+    }
+    return out;
+}
+
+size_t longest(const std::vector<icu::UnicodeString>& texts) {
+    size_t length = 0;
+    for (const auto& text : texts) {
+        length = std::max<size_t>(length, text.length());
+    }
+    return length;
+}
+
+} // namespace
+
+void runCollationSuite(Runner& runner) {
+    const size_t batch = 32;
+    const Corpus corpus = words(20000 * runner.options().scale);
+    const std::vector<icu::UnicodeString> utf16 = toUnicode(corpus);
+    const size_t count = corpus.items.size();
+    const size_t units = count / batch;
+
+    for (const char* locale : {"en", "ja"}) {
+        const std::string suffix = std::string("/") + locale;
+        UErrorCode status = U_ZERO_ERROR;
+        std::unique_ptr<icu::Collator> collator(icu::Collator::createInstance(icu::Locale(locale), status));
+        if (U_FAILURE(status)) {
+            runner.skip({"collation", "*" + suffix, corpus.name, ""}, u_errorName(status));
+            continue;
+        }
+
+        runner.measure({"collation", "compare" + suffix, corpus.name, "32 pairs"}, units, [&](size_t unit) {
+            Work work{0, batch};
+            UErrorCode error = U_ZERO_ERROR;
+            int32_t order = 0;
+            for (size_t k = 0; k < batch; ++k) {
+                size_t i = unit * batch + k;
+                size_t j = (i + 1) % count;
+                order += collator->compare(utf16[i], utf16[j], error);
+                work.bytes += corpus.items[i].size() + corpus.items[j].size();
+            }
+            keep(order);
+            return work;
+        });
+
+        runner.measure({"collation", "compareUTF8" + suffix, corpus.name, "32 pairs"}, units, [&](size_t unit) {
+            Work work{0, batch};
+            UErrorCode error = U_ZERO_ERROR;
+            int32_t order = 0;
+            for (size_t k = 0; k < batch; ++k) {
+                size_t i = unit * batch + k;
+                size_t j = (i + 1) % count;
+                order += collator->compareUTF8(corpus.items[i], corpus.items[j], error);
+                work.bytes += corpus.items[i].size() + corpus.items[j].size();
+            }
+            keep(order);
+            return work;
+        });
+
+        runner.measure({"collation", "sortkey" + suffix, corpus.name, "32 keys"}, units, [&](size_t unit) {
+            Work work{0, batch};
+            uint8_t key[512];
+            int32_t total = 0;
+            for (size_t k = 0; k < batch; ++k) {
+                size_t i = unit * batch + k;
+                total += collator->getSortKey(utf16[i], key, sizeof(key));
+                work.bytes += corpus.items[i].size();
+            }
+            keep(key);
+            keep(total);
+            return work;
+        });
+    }
+}
+
+void runSegmentationSuite(Runner& runner) {
+    const Corpus corpus = multilingualDocuments(runner.options().scale);
+    const std::vector<icu::UnicodeString> texts = toUnicode(corpus);
+
+    struct Kind {
+        const char* name;
+        icu::BreakIterator* (*create)(const icu::Locale&, UErrorCode&);
+    };
+    const Kind kinds[] = {
+        {"word",     &icu::BreakIterator::createWordInstance},
+        {"sentence", &icu::BreakIterator::createSentenceInstance},
+        {"line",     &icu::BreakIterator::createLineInstance},
+    };
+
+    for (const auto& kind : kinds) {
+        const std::string name = std::string(kind.name) + "/en";
+        UErrorCode status = U_ZERO_ERROR;
+        std::unique_ptr<icu::BreakIterator> iterator(kind.create(icu::Locale::getUS(), status));
+        if (U_FAILURE(status)) {
+            runner.skip({"segmentation", name, corpus.name, ""}, u_errorName(status));
+            continue;
+        }
+        runner.measure({"segmentation", name, corpus.name, "document"}, texts.size(), [&](size_t i) {
+            iterator->setText(texts[i]);
+            uint64_t boundaries = 0;
+            for (int32_t p = iterator->first(); p != icu::BreakIterator::DONE; p = iterator->next()) {
+                ++boundaries;
+            }
+            return Work{corpus.items[i].size(), boundaries};
+        });
+    }
+}
+
+void runNormalizationSuite(Runner& runner) {
+    const Corpus corpus = multilingualDocuments(runner.options().scale);
+    const std::vector<icu::UnicodeString> texts = toUnicode(corpus);
+
+    struct Form {
+        const char* name;
+        const icu::Normalizer2* (*instance)(UErrorCode&);
+    };
+    const Form forms[] = {
+        {"NFC",           &icu::Normalizer2::getNFCInstance},
+        {"NFD",           &icu::Normalizer2::getNFDInstance},
+        {"NFKC",          &icu::Normalizer2::getNFKCInstance},
+        {"NFKC_Casefold", &icu::Normalizer2::getNFKCCasefoldInstance},
+    };
+
+    for (const auto& form : forms) {
+        UErrorCode status = U_ZERO_ERROR;
+        const icu::Normalizer2* normalizer = form.instance(status);
+        if (U_FAILURE(status)) {
+            runner.skip({"normalization", form.name, corpus.name, ""}, u_errorName(status));
+            continue;
+        }
+        runner.measure({"normalization", std::string(form.name) + "/utf16", corpus.name, "document"}, texts.size(), [&](size_t i) {
+            UErrorCode error = U_ZERO_ERROR;
+            icu::UnicodeString result = normalizer->normalize(texts[i], error);
+            keep(result);
+            return Work{corpus.items[i].size(), 1};
+        });
+    }
+
+    UErrorCode status = U_ZERO_ERROR;
+    const icu::Normalizer2* nfc = icu::Normalizer2::getNFCInstance(status);
+    const icu::Normalizer2* nfd = icu::Normalizer2::getNFDInstance(status);
+    if (U_FAILURE(status)) {
+        return;
+    }
+
+    std::string output;
+    runner.measure({"normalization", "NFC/utf8", corpus.name, "document"}, corpus.items.size(), [&](size_t i) {
+        UErrorCode error = U_ZERO_ERROR;
+        output.clear();
+        icu::StringByteSink<std::string> sink(&output);
+        nfc->normalizeUTF8(0, corpus.items[i], sink, nullptr, error);
+        return Work{corpus.items[i].size(), 1};
+    });
+
+    // Decomposed input makes NFC do real composition work instead of a quick-check pass.
+    std::vector<icu::UnicodeString> decomposed;
+    for (const auto& text : texts) {
+        decomposed.push_back(nfd->normalize(text, status));
+    }
+    runner.measure({"normalization", "NFC/utf16-from-nfd", corpus.name + "-nfd", "document"}, decomposed.size(), [&](size_t i) {
+        UErrorCode error = U_ZERO_ERROR;
+        icu::UnicodeString result = nfc->normalize(decomposed[i], error);
+        keep(result);
+        return Work{corpus.items[i].size(), 1};
+    });
+}
+
+void runConversionSuite(Runner& runner) {
+    const size_t scale = runner.options().scale;
+    const Corpus corpus = multilingualDocuments(scale);
+    const std::vector<icu::UnicodeString> texts = toUnicode(corpus);
+
+    std::vector<UChar> utf16Buffer(longest(texts) + 1);
+    runner.measure({"conversion", "utf8-to-utf16", corpus.name, "document"}, corpus.items.size(), [&](size_t i) {
+        UErrorCode error = U_ZERO_ERROR;
+        int32_t length = 0;
+        u_strFromUTF8(utf16Buffer.data(), static_cast<int32_t>(utf16Buffer.size()), &length,
+                      corpus.items[i].data(), static_cast<int32_t>(corpus.items[i].size()), &error);
+        keep(length);
+        return Work{corpus.items[i].size(), 1};
+    });
+
+    std::vector<char> utf8Buffer(corpus.bytes() + 1);
+    runner.measure({"conversion", "utf16-to-utf8", corpus.name, "document"}, texts.size(), [&](size_t i) {
+        UErrorCode error = U_ZERO_ERROR;
+        int32_t length = 0;
+        u_strToUTF8(utf8Buffer.data(), static_cast<int32_t>(utf8Buffer.size()), &length,
+                    texts[i].getBuffer(), texts[i].length(), &error);
+        keep(length);
+        return Work{corpus.items[i].size(), 1};
+    });
+
+    // Legacy charsets, each fed with text in languages it can represent.
+    struct Charset {
+        const char*              name;
+        std::vector<std::string> languages;
+    };
+    const Charset charsets[] = {
+        {"Shift-JIS",    {"ja"}},
+        {"GB18030",      {"zh"}},
+        {"EUC-KR",       {"ko"}},
+        {"windows-1252", {"en", "fr", "de", "es"}},
+        {"windows-1251", {"ru"}},
+        {"ISO-8859-7",   {"el"}},
+    };
+
+    for (const auto& charset : charsets) {
+        UErrorCode status = U_ZERO_ERROR;
+        UConverter* converter = ucnv_open(charset.name, &status);
+        if (U_FAILURE(status)) {
+            runner.skip({"conversion", std::string("*/") + charset.name, "", ""}, u_errorName(status));
+            continue;
+        }
+
+        const Corpus source = documentsFor(std::string("documents-") + charset.languages.front(), charset.languages, scale);
+        const std::vector<icu::UnicodeString> unicode = toUnicode(source);
+        std::vector<std::string> encoded;
+        for (const auto& text : unicode) {
+            std::string bytes(text.length() * UCNV_GET_MAX_BYTES_FOR_STRING(1, ucnv_getMaxCharSize(converter)), '\0');
+            int32_t length = ucnv_fromUChars(converter, bytes.data(), static_cast<int32_t>(bytes.size()),
+                                             text.getBuffer(), text.length(), &status);
+            bytes.resize(U_SUCCESS(status) ? length : 0);
+            encoded.push_back(std::move(bytes));
+        }
+
+        std::vector<UChar> decodeBuffer(longest(unicode) + 1);
+        // Decoding reports legacy input bytes; encoding reports UTF-8 bytes of the same text.
+        runner.measure({"conversion", std::string("decode/") + charset.name, source.name, "document"}, encoded.size(), [&](size_t i) {
+            UErrorCode error = U_ZERO_ERROR;
+            int32_t length = ucnv_toUChars(converter, decodeBuffer.data(), static_cast<int32_t>(decodeBuffer.size()),
+                                           encoded[i].data(), static_cast<int32_t>(encoded[i].size()), &error);
+            keep(length);
+            return Work{encoded[i].size(), 1};
+        });
+
+        std::vector<char> encodeBuffer(source.bytes() * 2 + 16);
+        runner.measure({"conversion", std::string("encode/") + charset.name, source.name, "document"}, unicode.size(), [&](size_t i) {
+            UErrorCode error = U_ZERO_ERROR;
+            int32_t length = ucnv_fromUChars(converter, encodeBuffer.data(), static_cast<int32_t>(encodeBuffer.size()),
+                                             unicode[i].getBuffer(), unicode[i].length(), &error);
+            keep(length);
+            return Work{source.items[i].size(), 1};
+        });
+
+        ucnv_close(converter);
+    }
+}
+
+void runTransliterationSuite(Runner& runner) {
+    const size_t scale = runner.options().scale;
+
+    struct Case {
+        const char*              id;
+        std::vector<std::string> languages;
+    };
+    const Case cases[] = {
+        {"Latin-Cyrillic", {"en", "fr", "de", "es", "vi"}},
+        {"Cyrillic-Latin", {"ru"}},
+        {"Greek-Latin",    {"el"}},
+        {"Any-Latin",      {"ru", "el", "hi", "ja", "ko", "zh"}},
+    };
+
+    for (const auto& entry : cases) {
+        const Corpus corpus = documentsFor(std::string("documents-") + entry.id, entry.languages, scale);
+        const std::vector<icu::UnicodeString> texts = toUnicode(corpus);
+
+        UErrorCode status = U_ZERO_ERROR;
+        std::unique_ptr<icu::Transliterator> transliterator(
+            icu::Transliterator::createInstance(entry.id, UTRANS_FORWARD, status));
+        if (U_FAILURE(status)) {
+            runner.skip({"transliteration", entry.id, corpus.name, ""}, u_errorName(status));
+            continue;
+        }
+        runner.measure({"transliteration", entry.id, corpus.name, "document"}, texts.size(), [&](size_t i) {
+            icu::UnicodeString text(texts[i]);
+            transliterator->transliterate(text);
+            keep(text);
+            return Work{corpus.items[i].size(), 1};
+        });
+    }
+}
+
+} // namespace icubench
@@ -0,0 +1,205 @@
+#include "corpus.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include <unicode/uchar.h>
+#include <unicode/utf8.h>
+
+namespace icubench {
+
+namespace {
+
+// Small deterministic generator so corpora are identical on every platform.
+class Lcg {
+public:
+    explicit Lcg(uint32_t seed) : state_(seed) {}
+
+    uint32_t next() {
+        state_ = state_ * 1664525u + 1013904223u;
+        return state_ >> 8;
+    }
+
+    size_t below(size_t bound) { return bound == 0 ? 0 : next() % bound; }
+
+private:
+    uint32_t state_;
+};
+
+bool isSpaceless(const std::string& language) {
+    return language == "zh" || language == "ja" || language == "th";
+}
+
+// Split a paragraph into word-like tokens.
+std::vector<std::string> tokenize(const Sample& sample) {
+    std::vector<std::string> tokens;
+    const std::string text(sample.text);
+    const auto* bytes  = reinterpret_cast<const uint8_t*>(text.data());
+    const int32_t length = static_cast<int32_t>(text.size());
+    const bool spaceless = isSpaceless(sample.language);
+
+    std::string current;
+    int32_t codePoints = 0;
+    int32_t chunk = 2;
+    for (int32_t i = 0; i < length;) {
+        int32_t start = i;
+        UChar32 c;
+        U8_NEXT(bytes, i, length, c);
+        bool separator = c < 0 || u_isWhitespace(c) || u_ispunct(c);
+        if (separator) {
+            if (!current.empty()) {
+                tokens.push_back(current);
+            }
+            current.clear();
+            codePoints = 0;
+            continue;
+        }
+        current.append(text, start, i - start);
+        if (spaceless && ++codePoints == chunk) {
+            tokens.push_back(current);
+            current.clear();
+            codePoints = 0;
+            chunk = chunk == 4 ? 2 : chunk + 1;
+        }
+    }
+    if (!current.empty()) {
+        tokens.push_back(current);
+    }
+    return tokens;
+}
+
+// Uppercase the first ASCII letter; enough to exercise case differences.
+std::string capitalize(std::string word) {
+    if (!word.empty() && word[0] >= 'a' && word[0] <= 'z') {
+        word[0] = static_cast<char>(word[0] - 'a' + 'A');
+    }
+    return word;
+}
+
+} // namespace
+
+size_t Corpus::bytes() const {
+    size_t total = 0;
+    for (const auto& item : items) {
+        total += item.size();
+    }
+    return total;
+}
+
+const std::vector<Sample>& samples() {
+    static const std::vector<Sample> all = {
+        {"en", "All human beings are born free and equal in dignity and rights. They are endowed with reason and "
+               "conscience and should act towards one another in a spirit of brotherhood."},
+        {"fr", "Tous les êtres humains naissent libres et égaux en dignité et en droits. Ils sont doués de raison "
+               "et de conscience et doivent agir les uns envers les autres dans un esprit de fraternité."},
+        {"de", "Alle Menschen sind frei und gleich an Würde und Rechten geboren. Sie sind mit Vernunft und "
+               "Gewissen begabt und sollen einander im Geist der Brüderlichkeit begegnen."},
+        {"es", "Todos los seres humanos nacen libres e iguales en dignidad y derechos y, dotados como están de "
+               "razón y conciencia, deben comportarse fraternalmente los unos con los otros."},
+        {"vi", "Tất cả mọi người sinh ra đều được tự do và bình đẳng về nhân phẩm và quyền lợi. Mọi con người "
+               "đều được tạo hóa ban cho lý trí và lương tâm và cần phải đối xử với nhau trong tình bằng hữu."},
+        {"ru", "Все люди рождаются свободными и равными в своем достоинстве и правах. Они наделены разумом и "
+               "совестью и должны поступать в отношении друг друга в духе братства."},
+        {"el", "Όλοι οι άνθρωποι γεννιούνται ελεύθεροι και ίσοι στην αξιοπρέπεια και τα δικαιώματα. Είναι "
+               "προικισμένοι με λογική και συνείδηση, και οφείλουν να συμπεριφέρονται μεταξύ τους με πνεύμα "
+               "αδελφοσύνης."},
+        {"he", "כל בני האדם נולדו בני חורין ושווים בערכם ובזכויותיהם. כולם חוננו בתבונה ובמצפון, לפיכך חובה "
+               "עליהם לנהוג איש ברעהו ברוח של אחוה."},
+        {"ar", "يولد جميع الناس أحرارًا متساوين في الكرامة والحقوق. وقد وهبوا عقلاً وضميرًا وعليهم أن يعامل "
+               "بعضهم بعضًا بروح الإخاء."},
+        {"hi", "सभी मनुष्यों को गौरव और अधिकारों के मामले में जन्मजात स्वतन्त्रता और समानता प्राप्त है। उन्हें "
+               "बुद्धि और अन्तरात्मा की देन प्राप्त है और परस्पर उन्हें भाईचारे के भाव से बर्ताव करना चाहिए।"},
+        {"th", "มนุษย์ทั้งหลายเกิดมามีอิสระและเสมอภาคกันในเกียรติศักดิ์และสิทธิ ต่างมีเหตุผลและมโนธรรม "
+               "และควรปฏิบัติต่อกันด้วยเจตนารมณ์แห่งภราดรภาพ"},
+        {"zh", "人人生而自由，在尊严和权利上一律平等。他们赋有理性和良心，并应以兄弟关系的精神相对待。"},
+        {"ja", "すべての人間は、生まれながらにして自由であり、かつ、尊厳と権利とについて平等である。"
+               "人間は、理性と良心とを授けられており、互いに同胞の精神をもって行動しなければならない。"},
+        {"ko", "모든 인간은 태어날 때부터 자유로우며 그 존엄과 권리에 있어 동등하다. 인간은 천부적으로 이성과 "
+               "양심을 부여받았으며 서로 형제애의 정신으로 행동하여야 한다."},
+    };
+    return all;
+}
+
+Corpus documentsFor(const std::string& name, const std::vector<std::string>& languages, size_t scale) {
+    Corpus corpus;
+    corpus.name = name;
+    Lcg random(0x1c4u);
+    const size_t perLanguage = 4 * std::max<size_t>(scale, 1);
+    for (const auto& sample : samples()) {
+        if (std::find(languages.begin(), languages.end(), sample.language) == languages.end()) {
+            continue;
+        }
+        const std::string separator = isSpaceless(sample.language) ? "" : " ";
+        for (size_t d = 0; d < perLanguage; ++d) {
+            size_t paragraphs = 1 + random.below(8);
+            std::string document;
+            for (size_t p = 0; p < paragraphs; ++p) {
+                if (p > 0) {
+                    document += (p % 3 == 0) ? "\n\n" : separator;
+                }
+                document += sample.text;
+            }
+            corpus.items.push_back(std::move(document));
+        }
+    }
+    return corpus;
+}
+
+Corpus multilingualDocuments(size_t scale) {
+    std::vector<std::string> languages;
+    for (const auto& sample : samples()) {
+        languages.push_back(sample.language);
+    }
+    return documentsFor("multilingual-documents", languages, scale);
+}
+
+Corpus words(size_t count) {
+    std::vector<std::string> vocabulary;
+    for (const auto& sample : samples()) {
+        auto tokens = tokenize(sample);
+        vocabulary.insert(vocabulary.end(), tokens.begin(), tokens.end());
+    }
+
+    Corpus corpus;
+    corpus.name = "multilingual-words";
+    corpus.items.reserve(count);
+    Lcg random(0x5eedu);
+    for (size_t i = 0; i < count; ++i) {
+        std::string word = vocabulary[random.below(vocabulary.size())];
+        if (random.below(4) == 0) {
+            word = capitalize(std::move(word));
+        }
+        corpus.items.push_back(std::move(word));
+    }
+    return corpus;
+}
+
+Corpus records(size_t count) {
+    std::vector<std::vector<std::string>> vocabularies;
+    std::vector<std::string> separators;
+    for (const auto& sample : samples()) {
+        vocabularies.push_back(tokenize(sample));
+        separators.push_back(isSpaceless(sample.language) ? "" : " ");
+    }
+
+    Corpus corpus;
+    corpus.name = "multilingual-records";
+    corpus.items.reserve(count);
+    Lcg random(0x50f7u);
+    for (size_t i = 0; i < count; ++i) {
+        size_t language = random.below(vocabularies.size());
+        const auto& vocabulary = vocabularies[language];
+        std::string record;
+        for (size_t w = 0, n = 1 + random.below(3); w < n; ++w) {
+            std::string word = vocabulary[random.below(vocabulary.size())];
+            if (random.below(4) == 0) {
+                word = capitalize(std::move(word));
+            }
+            record += (w == 0 ? "" : separators[language]) + word;
+        }
+        corpus.items.push_back(std::move(record));
+    }
+    return corpus;
+}
+
+} // namespace icubench
@@ -0,0 +1,49 @@
+#pragma once
+
+/*
+ * ICU4C Package Benchmark - fixed corpora
+ *
+ * All corpora are generated deterministically from a small set of embedded
+ * multilingual paragraphs (Article 1 of the Universal Declaration of Human
+ * Rights), so results are comparable between machines and package builds
+ * without shipping data files alongside the benchmark.
+ */
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace icubench {
+
+struct Sample {
+    const char* language;   // BCP 47 language code
+    const char* text;       // UTF-8 paragraph
+};
+
+struct Corpus {
+    std::string              name;
+    std::vector<std::string> items;   // UTF-8
+
+    size_t bytes() const;
+};
+
+// The embedded paragraphs, one per language.
+const std::vector<Sample>& samples();
+
+// Documents of 1-8 paragraphs in a single language, for every sample language.
+// `scale` multiplies the number of documents.
+Corpus multilingualDocuments(size_t scale);
+
+// Documents built only from the listed languages.
+Corpus documentsFor(const std::string& name, const std::vector<std::string>& languages, size_t scale);
+
+// Words taken from all samples (space-separated scripts are split on
+// whitespace/punctuation, CJK and Thai are cut into 2-4 code point chunks).
+// Some words are capitalized so case-level collation work is exercised.
+Corpus words(size_t count);
+
+// Sort records of 1-3 words of one language (like names or titles), so that
+// large sorting corpora hold many distinct strings with shared prefixes.
+Corpus records(size_t count);
+
+} // namespace icubench
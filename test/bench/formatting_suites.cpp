@@ -0,0 +1,254 @@
+/*
+ * Formatting workloads: currency amounts and dates as a reporting service
+ * formats them, one value at a time and in batches.
+ *
+ *   legacy-create    NumberFormat/DateFormat created for every value, as in
+ *                    test.cpp's locale example
+ *   legacy-cached    one NumberFormat/DateFormat, format() into a UnicodeString
+ *   formatter        one LocalizedNumberFormatter, formatDouble() (numbers only)
+ *   compiled         icuaddons::FormatterCache format into a stack buffer
+ *   compiled-batch   icuaddons::FormatterCache formatBatch() of kBatch values
+ *
+ * Every variant produces UTF-8. With --count-allocations the results carry
+ * the ICU allocations per formatted value (allocations_per_format).
+ */
+
+#include "suites.h"
+
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <icuaddons/formatting.h>
+#include <icuaddons/memory.h>
+
+#include <unicode/datefmt.h>
+#include <unicode/locid.h>
+#include <unicode/numberformatter.h>
+#include <unicode/numfmt.h>
+#include <unicode/timezone.h>
+#include <unicode/unistr.h>
+
+namespace icubench {
+
+namespace {
+
+// Values per batch, and distinct values the single-value workloads cycle through.
+constexpr size_t kBatch = 1000;
+
+struct FormatLocale {
+    const char* name;
+    const char* locale;
+    const char* currency;  // ISO 4217 code for the skeleton
+};
+
+const FormatLocale kLocales[] = {
+    {"en", "en_US", "USD"},
+    {"de", "de_DE", "EUR"},
+    {"ja", "ja_JP", "JPY"},
+};
+
+std::vector<double> amounts() {
+    std::vector<double> values;
+    uint64_t state = 0x9e3779b97f4a7c15u;
+    for (size_t i = 0; i < kBatch; ++i) {
+        state = state * 6364136223846793005u + 1442695040888963407u;
+        values.push_back(static_cast<double>(state >> 40) / 100.0);  // Up to ~167 million, two decimals
+    }
+    return values;
+}
+
+std::vector<UDate> timestamps() {
+    std::vector<UDate> values;
+    for (size_t i = 0; i < kBatch; ++i) {
+        values.push_back(1.7e12 + static_cast<double>(i) * 7919.0 * 60000.0);  // Minutes apart from late 2023
+    }
+    return values;
+}
+
+// ICU allocations of `format` divided by the values it formats.
+void countAllocations(Runner& runner, Result* result, size_t values, const std::function<void()>& format) {
+    if (result == nullptr || !runner.options().countAllocations) {
+        return;
+    }
+    icuaddons::AllocationScope scope;
+    format();
+    icuaddons::AllocationCounters counters = scope.counters();
+    result->metrics["allocations_per_format"] =
+        static_cast<double>(counters.allocations + counters.reallocations) / static_cast<double>(values);
+}
+
+void runNumberWorkloads(Runner& runner, const FormatLocale& entry, const std::vector<double>& values) {
+    const icu::Locale locale(entry.locale);
+    const icu::UnicodeString skeleton = icu::UnicodeString(u"currency/") + icu::UnicodeString(entry.currency, -1, US_INV);
+    auto workload = [&](const char* how, const std::string& unit = "value") {
+        return Workload{"formatting", std::string("currency/") + entry.name + "/" + how, "amounts", unit};
+    };
+
+    UErrorCode status = U_ZERO_ERROR;
+    icuaddons::FormatterCache formats;
+    icuaddons::CompiledNumberFormat* compiled = formats.number(locale, skeleton, status);
+    std::unique_ptr<icu::NumberFormat> legacy(icu::NumberFormat::createCurrencyInstance(locale, status));
+    if (U_FAILURE(status)) {
+        runner.skip(workload("compiled"), u_errorName(status));
+        return;
+    }
+    const icu::number::LocalizedNumberFormatter formatter = icu::number::NumberFormatter::forSkeleton(skeleton, status).locale(locale);
+
+    std::string utf8;
+    auto legacyCreate = [&](size_t i) {
+        UErrorCode error = U_ZERO_ERROR;
+        std::unique_ptr<icu::NumberFormat> created(icu::NumberFormat::createCurrencyInstance(locale, error));
+        icu::UnicodeString text;
+        created->format(values[i % kBatch], text);
+        utf8.clear();
+        text.toUTF8String(utf8);
+    };
+    Result* result = runner.measure(workload("legacy-create"), kBatch, [&](size_t i) {
+        legacyCreate(i);
+        return Work{};
+    });
+    countAllocations(runner, result, 1, [&] { legacyCreate(0); });
+
+    auto legacyCached = [&](size_t i) {
+        icu::UnicodeString text;
+        legacy->format(values[i % kBatch], text);
+        utf8.clear();
+        text.toUTF8String(utf8);
+    };
+    result = runner.measure(workload("legacy-cached"), kBatch, [&](size_t i) {
+        legacyCached(i);
+        return Work{};
+    });
+    countAllocations(runner, result, 1, [&] { legacyCached(0); });
+
+    auto modern = [&](size_t i) {
+        UErrorCode error = U_ZERO_ERROR;
+        utf8.clear();
+        formatter.formatDouble(values[i % kBatch], error).toTempString(error).toUTF8String(utf8);
+    };
+    result = runner.measure(workload("formatter"), kBatch, [&](size_t i) {
+        modern(i);
+        return Work{};
+    });
+    countAllocations(runner, result, 1, [&] { modern(0); });
+
+    char buffer[64];
+    auto single = [&](size_t i) {
+        UErrorCode error = U_ZERO_ERROR;
+        keep(compiled->format(values[i % kBatch], buffer, sizeof(buffer), error));
+    };
+    result = runner.measure(workload("compiled"), kBatch, [&](size_t i) {
+        single(i);
+        return Work{};
+    });
+    countAllocations(runner, result, 1, [&] { single(0); });
+
+    icuaddons::FormattedStrings batch;
+    auto batched = [&] {
+        UErrorCode error = U_ZERO_ERROR;
+        compiled->formatBatch(values.data(), values.size(), batch, error);
+    };
+    result = runner.measure(workload("compiled-batch", std::to_string(kBatch) + " values"), 1, [&](size_t) {
+        batched();
+        return Work{0, kBatch};
+    });
+    countAllocations(runner, result, kBatch, batched);
+
+    // The compiled format must agree with the LocalizedNumberFormatter it stands for
+    if (result != nullptr) {
+        UErrorCode error = U_ZERO_ERROR;
+        utf8.clear();
+        formatter.formatDouble(values[1], error).toTempString(error).toUTF8String(utf8);
+        if (batch.size() != kBatch || batch.string(1) != utf8) {
+            std::cerr << "❌ formatting/currency/" << entry.name << ": compiled output differs from LocalizedNumberFormatter"
+                      << std::endl;
+        }
+    }
+}
+
+void runDateWorkloads(Runner& runner, const FormatLocale& entry, const std::vector<UDate>& values) {
+    const icu::Locale locale(entry.locale);
+    auto workload = [&](const char* how, const std::string& unit = "value") {
+        return Workload{"formatting", std::string("date/") + entry.name + "/" + how, "timestamps", unit};
+    };
+
+    // The medium date and time style and the matching skeleton, both in UTC
+    UErrorCode status = U_ZERO_ERROR;
+    icuaddons::FormatterCache formats;
+    icuaddons::CompiledDateFormat* compiled = formats.date(locale, u"yMMMdjms", status, u"UTC");
+    std::unique_ptr<icu::DateFormat> legacy(
+        icu::DateFormat::createDateTimeInstance(icu::DateFormat::kMedium, icu::DateFormat::kMedium, locale));
+    if (U_FAILURE(status) || legacy == nullptr) {
+        runner.skip(workload("compiled"), U_FAILURE(status) ? u_errorName(status) : "DateFormat unavailable");
+        return;
+    }
+    legacy->adoptTimeZone(icu::TimeZone::createTimeZone(u"UTC"));
+
+    std::string utf8;
+    auto legacyCreate = [&](size_t i) {
+        std::unique_ptr<icu::DateFormat> created(
+            icu::DateFormat::createDateTimeInstance(icu::DateFormat::kMedium, icu::DateFormat::kMedium, locale));
+        created->adoptTimeZone(icu::TimeZone::createTimeZone(u"UTC"));
+        icu::UnicodeString text;
+        created->format(values[i % kBatch], text);
+        utf8.clear();
+        text.toUTF8String(utf8);
+    };
+    Result* result = runner.measure(workload("legacy-create"), kBatch, [&](size_t i) {
+        legacyCreate(i);
+        return Work{};
+    });
+    countAllocations(runner, result, 1, [&] { legacyCreate(0); });
+
+    auto legacyCached = [&](size_t i) {
+        icu::UnicodeString text;
+        legacy->format(values[i % kBatch], text);
+        utf8.clear();
+        text.toUTF8String(utf8);
+    };
+    result = runner.measure(workload("legacy-cached"), kBatch, [&](size_t i) {
+        legacyCached(i);
+        return Work{};
+    });
+    countAllocations(runner, result, 1, [&] { legacyCached(0); });
+
+    char buffer[128];
+    auto single = [&](size_t i) {
+        UErrorCode error = U_ZERO_ERROR;
+        keep(compiled->format(values[i % kBatch], buffer, sizeof(buffer), error));
+    };
+    result = runner.measure(workload("compiled"), kBatch, [&](size_t i) {
+        single(i);
+        return Work{};
+    });
+    countAllocations(runner, result, 1, [&] { single(0); });
+
+    icuaddons::FormattedStrings batch;
+    auto batched = [&] {
+        UErrorCode error = U_ZERO_ERROR;
+        compiled->formatBatch(values.data(), values.size(), batch, error);
+    };
+    result = runner.measure(workload("compiled-batch", std::to_string(kBatch) + " values"), 1, [&](size_t) {
+        batched();
+        return Work{0, kBatch};
+    });
+    countAllocations(runner, result, kBatch, batched);
+}
+
+} // namespace
+
+void runFormattingSuite(Runner& runner) {
+    const std::vector<double> values = amounts();
+    const std::vector<UDate>  dates  = timestamps();
+    for (const auto& entry : kLocales) {
+        runNumberWorkloads(runner, entry, values);
+    }
+    for (const auto& entry : kLocales) {
+        runDateWorkloads(runner, entry, dates);
+    }
+}
+
+} // namespace icubench
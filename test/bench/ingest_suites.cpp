@@ -0,0 +1,166 @@
+/*
+ * Ingest normalization: NFC and NFKC over batches of UTF-8 records.
+ *
+ * Each corpus is one batch of records (the paragraphs of the documents in
+ * corpus.h), some of them decomposed with NFD so that they need work:
+ *
+ *   ascii-heavy      en and es paragraphs, all already normalized
+ *   latin-combining  fr, de and vi paragraphs, every other one decomposed
+ *   cjk              zh and ja paragraphs (NFKC folds fullwidth punctuation)
+ *   hangul           ko paragraphs, every fourth one decomposed into jamo
+ *
+ * and is normalized three ways:
+ *
+ *   utf16  UnicodeString::fromUTF8, Normalizer2::normalize, toUTF8String per record
+ *   utf8   Normalizer2::normalizeUTF8 into a std::string per record
+ *   batch  icuaddons::normalizeBatchUTF8 (quick check, zero-copy, one arena)
+ *
+ * Throughput is input MB/s. The batch results carry the share of records
+ * that were returned without copying (zero_copy_pct).
+ */
+
+#include "corpus.h"
+#include "suites.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <icuaddons/normalize.h>
+
+#include <unicode/bytestream.h>
+#include <unicode/normalizer2.h>
+#include <unicode/unistr.h>
+
+namespace icubench {
+
+namespace {
+
+// Documents per language; the batches hold their paragraphs.
+constexpr size_t kDocumentScale = 64;
+
+struct Batch {
+    std::string              name;
+    std::vector<std::string> records;
+    std::string              text;     // The records back to back
+    std::vector<uint32_t>    offsets;  // count + 1 entries
+};
+
+// The paragraphs of `languages`, every `decomposeEvery`-th one in NFD (0: none).
+Batch makeBatch(const std::string& name, const std::vector<std::string>& languages, size_t decomposeEvery,
+                size_t scale, const icu::Normalizer2& nfd) {
+    Batch batch;
+    batch.name = name;
+    const Corpus documents = documentsFor(name, languages, kDocumentScale * scale);
+    for (const auto& document : documents.items) {
+        for (size_t begin = 0; begin < document.size();) {
+            size_t end = document.find("\n\n", begin);
+            end = end == std::string::npos ? document.size() : end;
+            std::string record = document.substr(begin, end - begin);
+            if (decomposeEvery > 0 && batch.records.size() % decomposeEvery == 0) {
+                UErrorCode status = U_ZERO_ERROR;
+                std::string decomposed;
+                icu::StringByteSink<std::string> sink(&decomposed);
+                nfd.normalizeUTF8(0, record, sink, nullptr, status);
+                record = std::move(decomposed);
+            }
+            batch.records.push_back(std::move(record));
+            begin = end + 2;
+        }
+    }
+    batch.offsets.push_back(0);
+    for (const auto& record : batch.records) {
+        batch.text += record;
+        batch.offsets.push_back(static_cast<uint32_t>(batch.text.size()));
+    }
+    return batch;
+}
+
+} // namespace
+
+void runIngestSuite(Runner& runner) {
+    struct Form {
+        const char* name;
+        const icu::Normalizer2* (*instance)(UErrorCode&);
+    };
+    const Form forms[] = {
+        {"NFC",  &icu::Normalizer2::getNFCInstance},
+        {"NFKC", &icu::Normalizer2::getNFKCInstance},
+    };
+
+    UErrorCode status = U_ZERO_ERROR;
+    const icu::Normalizer2* nfd = icu::Normalizer2::getNFDInstance(status);
+    if (U_FAILURE(status)) {
+        runner.skip({"ingest", "NFD", "", ""}, u_errorName(status));
+        return;
+    }
+    const size_t scale = runner.options().scale;
+    const std::vector<Batch> batches = {
+        makeBatch("ascii-heavy",     {"en", "es"},       0, scale, *nfd),
+        makeBatch("latin-combining", {"fr", "de", "vi"}, 2, scale, *nfd),
+        makeBatch("cjk",             {"zh", "ja"},       0, scale, *nfd),
+        makeBatch("hangul",          {"ko"},             4, scale, *nfd),
+    };
+
+    for (const auto& form : forms) {
+        status = U_ZERO_ERROR;
+        const icu::Normalizer2* normalizer = form.instance(status);
+        if (U_FAILURE(status)) {
+            runner.skip({"ingest", form.name, "", ""}, u_errorName(status));
+            continue;
+        }
+        for (const auto& batch : batches) {
+            const size_t count = batch.records.size();
+            const Work work{batch.text.size(), count};
+            const std::string unit = "batch of " + std::to_string(count) + " records";
+            auto workload = [&](const char* how) {
+                return Workload{"ingest", batch.name + "/" + form.name + "/" + how, batch.name, unit};
+            };
+
+            std::vector<std::string> output(count);
+            runner.measure(workload("utf16"), 1, [&](size_t) {
+                for (size_t i = 0; i < count; ++i) {
+                    UErrorCode error = U_ZERO_ERROR;
+                    icu::UnicodeString result = normalizer->normalize(icu::UnicodeString::fromUTF8(batch.records[i]), error);
+                    output[i].clear();
+                    result.toUTF8String(output[i]);
+                }
+                return work;
+            });
+
+            Result* reference = runner.measure(workload("utf8"), 1, [&](size_t) {
+                for (size_t i = 0; i < count; ++i) {
+                    UErrorCode error = U_ZERO_ERROR;
+                    output[i].clear();
+                    icu::StringByteSink<std::string> sink(&output[i]);
+                    normalizer->normalizeUTF8(0, batch.records[i], sink, nullptr, error);
+                }
+                return work;
+            });
+
+            icuaddons::NormalizedRecords normalized;
+            Result* result = runner.measure(workload("batch"), 1, [&](size_t) {
+                UErrorCode error = U_ZERO_ERROR;
+                icuaddons::normalizeBatchUTF8(*normalizer, batch.text.data(), batch.offsets.data(), count, normalized,
+                                              error);
+                keep(normalized.zeroCopy);
+                return work;
+            });
+            if (result == nullptr) {
+                continue;
+            }
+            result->metrics["zero_copy_pct"] = count > 0 ? 100.0 * normalized.zeroCopy / count : 0.0;
+
+            // The batch must produce what normalizeUTF8 produces record by record
+            for (size_t i = 0; reference != nullptr && i < count; ++i) {
+                if (i >= normalized.size() || normalized.record(i) != output[i]) {
+                    std::cerr << "❌ ingest/" << form.name << "/batch/" << batch.name << ": record " << i
+                              << " differs from Normalizer2::normalizeUTF8" << std::endl;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+} // namespace icubench
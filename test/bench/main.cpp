@@ -0,0 +1,259 @@
+/*
+ * ICU4C Package Benchmark
+ *
+ * Measures throughput (MB/s, ops/s) and p50/p99 latency of the packaged ICU
+ * libraries over fixed multilingual corpora, and optionally writes the
+ * results as JSON so two package builds can be compared.
+ *
+ * Usage:
+ *   icu_benchmark [--suite NAME[,NAME...]] [--filter TEXT] [--min-time SECONDS]
+ *                 [--scale N] [--json FILE] [--label TEXT] [--list]
+ *                 [--allocator system|pool] [--count-allocations]
+ *                 [--threads N[,N...]] [--sort-sizes N[,N...]] [--stream-mb N]
+ *
+ * The ICU data directory is taken from ICU_DATA, or from the ICU_DATA_DIR
+ * found by CMake at build time.
+ */
+
+#include "process.h"
+#include "suites.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <icuaddons/memory.h>
+
+#include <unicode/putil.h>
+#include <unicode/uclean.h>
+#include <unicode/uversion.h>
+
+namespace icubench {
+
+// build.sh trains the PGO variant on the ICU API suites of this table
+// (PGO_TRAINING_SUITES); update it when adding or renaming one.
+const std::vector<Suite>& suites() {
+    static const std::vector<Suite> all = {
+        {"collation",       "Collator::compare, compareUTF8 and getSortKey over a word list", &runCollationSuite},
+        {"segmentation",    "Word, sentence and line BreakIterator over documents",           &runSegmentationSuite},
+        {"normalization",   "NFC/NFD/NFKC/NFKC_Casefold over UTF-16 and UTF-8 documents",     &runNormalizationSuite},
+        {"conversion",      "UTF-8 <-> UTF-16 and legacy charset encode/decode",              &runConversionSuite},
+        {"transliteration", "Script transliterators over documents",                         &runTransliterationSuite},
+        {"calls",           "Tight loops over small ICU entry points (call overhead)",        &runCallsSuite},
+        {"startup",         "First-call latency in a fresh process: cold, from split data, after icuaddons::warmUp and preloaded", &runStartupSuite},
+        {"allocation",      "Create/destroy of ICU services on 1 and 8 threads (allocator cost)", &runAllocationSuite},
+        {"threads",         "Shared collator, break iterator clones, formatter and converters on 1..N threads", &runThreadsSuite},
+        {"sort",            "Sorting 100k-10M strings: compare, CollationKey and packed sort keys with radix sort", &runSortSuite},
+        {"streaming",       "Word segmentation and Shift-JIS encoding of a large UTF-8 file: UnicodeString copies vs mmap, UText and ucnv_convertEx", &runStreamingSuite},
+        {"pool",            "Create-use-destroy requests with and without icuaddons::ServicePool, on 1 and 8 threads", &runPoolSuite},
+        {"ingest",          "Batched NFC/NFKC of UTF-8 records: per record vs icuaddons::normalizeBatchUTF8 with quick check and zero-copy", &runIngestSuite},
+        {"formatting",      "Currency and date formatting: legacy NumberFormat/DateFormat vs precompiled skeleton formats (icuaddons::FormatterCache)", &runFormattingSuite},
+        {"search",          "Regex and collation StringSearch over UTF-8 documents: per-shard compile, UnicodeString, UText and parallel multi-pattern scans", &runSearchSuite},
+        {"tokenize",        "Word, sentence and line segmentation of a UTF-8 corpus: per-token strings, one UText iterator and icuaddons::Segmenter on 1..N threads", &runTokenizeSuite},
+        {"transcode",       "Shift-JIS, GB18030, EUC-KR and windows-125x feeds to UTF-8: ucnv_open per record, reused converters and icuaddons::Transcoder with ASCII runs and 4 KB streaming", &runTranscodeSuite},
+    };
+    return all;
+}
+
+} // namespace icubench
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n\n"
+              << "Options:\n"
+              << "  --suite NAME[,NAME...]  Run only the given suites (default: all)\n"
+              << "  --filter TEXT           Run only workloads whose \"suite/workload\" contains TEXT\n"
+              << "  --min-time SECONDS      Minimum measured time per workload (default: 0.5)\n"
+              << "  --scale N               Corpus size multiplier (default: 1)\n"
+              << "  --json FILE             Write machine-readable results to FILE\n"
+              << "  --label TEXT            Label stored in the JSON output (e.g. the package name)\n"
+              << "  --list                  List workloads without running them\n"
+              << "  --allocator NAME        Install ICU allocation functions: system or pool (icuaddons)\n"
+              << "  --count-allocations     Count ICU allocations (allocations_per_op in the allocation suite)\n"
+              << "  --threads N[,N...]      Thread counts of the threads and tokenize suites (default: 1, 2, 4, ... cores)\n"
+              << "                          and the sort and search suites (default: 1 and cores)\n"
+              << "  --sort-sizes N[,N...]   Strings per sort in the sort suite (default: 100000,1000000)\n"
+              << "  --stream-mb N           Input file size in MB of the streaming suite (default: 256)\n"
+              << "  --help                  Show this help message\n\n"
+              << "Suites:\n";
+    for (const auto& suite : icubench::suites()) {
+        std::cout << "  " << suite.name << " - " << suite.description << "\n";
+    }
+}
+
+bool parseOptions(int argc, char* argv[], icubench::Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                std::cerr << "❌ Missing value for " << arg << std::endl;
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--suite") {
+            std::stringstream list(value());
+            std::string name;
+            while (std::getline(list, name, ',')) {
+                if (!name.empty()) {
+                    options.suites.push_back(name);
+                }
+            }
+        } else if (arg == "--filter") {
+            options.filter = value();
+        } else if (arg == "--min-time") {
+            options.minSeconds = std::atof(value().c_str());
+        } else if (arg == "--scale") {
+            options.scale = std::max(1, std::atoi(value().c_str()));
+        } else if (arg == "--json") {
+            options.jsonPath = value();
+        } else if (arg == "--label") {
+            options.label = value();
+        } else if (arg == "--startup-probe") {
+            options.startupProbe = value();
+        } else if (arg == "--stream-probe") {
+            options.streamProbe = value();
+        } else if (arg == "--stream-file") {
+            options.streamFile = value();
+        } else if (arg == "--stream-mb") {
+            options.streamMegabytes = static_cast<size_t>(std::max(1, std::atoi(value().c_str())));
+        } else if (arg == "--allocator") {
+            options.allocator = value();
+            icuaddons::Allocator allocator;
+            if (!icuaddons::parseAllocator(options.allocator.c_str(), allocator)) {
+                std::cerr << "❌ Unknown allocator: " << options.allocator << " (expected system or pool)" << std::endl;
+                return false;
+            }
+        } else if (arg == "--count-allocations") {
+            options.countAllocations = true;
+        } else if (arg == "--threads") {
+            std::stringstream list(value());
+            std::string count;
+            while (std::getline(list, count, ',')) {
+                if (std::atoi(count.c_str()) < 1) {
+                    std::cerr << "❌ Invalid thread count: " << count << std::endl;
+                    return false;
+                }
+                options.threadCounts.push_back(static_cast<size_t>(std::atoi(count.c_str())));
+            }
+        } else if (arg == "--sort-sizes") {
+            std::stringstream list(value());
+            std::string count;
+            while (std::getline(list, count, ',')) {
+                if (std::atoll(count.c_str()) < 1) {
+                    std::cerr << "❌ Invalid sort size: " << count << std::endl;
+                    return false;
+                }
+                options.sortSizes.push_back(static_cast<size_t>(std::atoll(count.c_str())));
+            }
+        } else if (arg == "--list") {
+            options.listOnly = true;
+        } else if (arg == "--help") {
+            printUsage(argv[0]);
+            std::exit(0);
+        } else {
+            std::cerr << "❌ Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+
+    for (const auto& name : options.suites) {
+        bool known = false;
+        for (const auto& suite : icubench::suites()) {
+            known = known || name == suite.name;
+        }
+        if (!known) {
+            std::cerr << "❌ Unknown suite: " << name << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    icubench::Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 2;
+    }
+    icubench::setSelfPath(argv[0]);
+
+    // Allocation functions must be installed before the first ICU call
+    if (!options.allocator.empty() || options.countAllocations) {
+        icuaddons::AllocatorOptions allocatorOptions;
+        allocatorOptions.allocator = icuaddons::Allocator::System;
+        if (!options.allocator.empty()) {
+            icuaddons::parseAllocator(options.allocator.c_str(), allocatorOptions.allocator);
+        }
+        allocatorOptions.countAllocations = options.countAllocations;
+        UErrorCode status = U_ZERO_ERROR;
+        icuaddons::installAllocator(allocatorOptions, status);
+        if (U_FAILURE(status)) {
+            std::cerr << "❌ Cannot install the ICU allocator: " << u_errorName(status) << std::endl;
+            return 1;
+        }
+    }
+
+    // Point ICU at the packaged data unless ICU_DATA already does.
+#ifdef ICU_DATA_DIR
+    const char* envDataDir = std::getenv("ICU_DATA");
+    if (envDataDir == nullptr || strlen(envDataDir) == 0) {
+        u_setDataDirectory(ICU_DATA_DIR);
+    }
+#endif
+
+    // Child process of the startup suite: ICU has not loaded any data yet
+    if (!options.startupProbe.empty()) {
+        return icubench::runStartupProbe(options.startupProbe);
+    }
+    if (!options.streamProbe.empty()) {
+        return icubench::runStreamingProbe(options.streamProbe, options.streamFile);
+    }
+
+    UVersionInfo versionInfo;
+    u_getVersion(versionInfo);
+    char versionString[U_MAX_VERSION_STRING_LENGTH];
+    u_versionToString(versionInfo, versionString);
+
+    std::cout << "===== ICU4C Package Benchmark =====" << std::endl;
+    std::cout << "ICU Version: " << versionString << std::endl;
+    std::cout << "ICU data directory: " << u_getDataDirectory() << std::endl;
+    if (icubench::hostX86_64Level() > 0) {
+        std::cout << "Host CPU: x86-64-v" << icubench::hostX86_64Level() << std::endl;
+    }
+    if (!options.allocator.empty() || options.countAllocations) {
+        std::cout << "ICU allocator: " << (options.allocator.empty() ? "default" : options.allocator)
+                  << (options.countAllocations ? " (counting allocations)" : "") << std::endl;
+    }
+
+    UErrorCode status = U_ZERO_ERROR;
+    u_init(&status);
+    if (U_FAILURE(status)) {
+        std::cout << "⚠️ u_init failed (" << u_errorName(status) << "); data-dependent workloads will be skipped" << std::endl;
+    }
+
+    icubench::Runner runner(options);
+    for (const auto& suite : icubench::suites()) {
+        if (!runner.suiteEnabled(suite.name)) {
+            continue;
+        }
+        std::cout << "\n=== " << suite.name << " ===" << std::endl;
+        suite.run(runner);
+    }
+
+    if (!options.listOnly && !options.jsonPath.empty()) {
+        if (!runner.writeJson(options.jsonPath)) {
+            return 1;
+        }
+    }
+
+    u_cleanup();
+    return 0;
+}
@@ -0,0 +1,195 @@
+/*
+ * Request-style workloads: get a service object, use it once, give it back.
+ *
+ * "create" creates the object through ICU and deletes it, as test.cpp does;
+ * "pool" leases it from an icuaddons::ServicePool (icuaddons/servicepool.h).
+ * Each runs on one thread and then on kThreads threads at once. The pool
+ * results carry the pool's hit rate and the time its prototypes took to
+ * create, which the pool pays once per key instead of once per request.
+ */
+
+#include "suites.h"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <icuaddons/servicepool.h>
+
+#include <unicode/brkiter.h>
+#include <unicode/coll.h>
+#include <unicode/locid.h>
+#include <unicode/translit.h>
+#include <unicode/ucnv.h>
+#include <unicode/unistr.h>
+
+namespace icubench {
+
+namespace {
+
+// Threads of the contended runs.
+constexpr size_t kThreads = 8;
+
+// The small piece of work a request does with its object.
+const icu::UnicodeString& requestText() {
+    static const icu::UnicodeString text(u"Privet, mir! Kak dela? Eto zapros nomer odin. Vsjo v porjadke.");
+    return text;
+}
+
+UErrorCode compare(icu::Collator& collator) {
+    UErrorCode status = U_ZERO_ERROR;
+    keep(collator.compare(u"résumé", u"resume", status));
+    return status;
+}
+
+UErrorCode sentences(icu::BreakIterator& iterator) {
+    iterator.setText(requestText());
+    int32_t count = 0;
+    while (iterator.next() != icu::BreakIterator::DONE) {
+        ++count;
+    }
+    keep(count);
+    return U_ZERO_ERROR;
+}
+
+UErrorCode transliterate(icu::Transliterator& transliterator) {
+    icu::UnicodeString text(requestText());
+    transliterator.transliterate(text);
+    keep(text.length());
+    return U_ZERO_ERROR;
+}
+
+UErrorCode encode(UConverter* converter) {
+    UErrorCode status = U_ZERO_ERROR;
+    char bytes[256];
+    keep(ucnv_fromUChars(converter, bytes, sizeof(bytes), requestText().getBuffer(), requestText().length(), &status));
+    return status;
+}
+
+template <typename T>
+UErrorCode useAndDestroy(T* object, UErrorCode status, UErrorCode (*use)(T&)) {
+    std::unique_ptr<T> owned(object);
+    return U_SUCCESS(status) ? use(*owned) : status;
+}
+
+template <typename T>
+UErrorCode useLease(icuaddons::Lease<T> lease, UErrorCode status, UErrorCode (*use)(T&)) {
+    return U_SUCCESS(status) ? use(*lease) : status;
+}
+
+struct RequestWorkload {
+    const char* name;
+    std::function<UErrorCode()> create;
+    std::function<UErrorCode(icuaddons::ServicePool&)> pooled;
+};
+
+const std::vector<RequestWorkload>& requestWorkloads() {
+    static const std::vector<RequestWorkload> all = {
+        {"Collator/en",
+         [] {
+             UErrorCode status = U_ZERO_ERROR;
+             return useAndDestroy(icu::Collator::createInstance(icu::Locale::getEnglish(), status), status, compare);
+         },
+         [](icuaddons::ServicePool& pool) {
+             UErrorCode status = U_ZERO_ERROR;
+             return useLease(pool.collator(icu::Locale::getEnglish(), status), status, compare);
+         }},
+        {"BreakIterator::sentence/en",
+         [] {
+             UErrorCode status = U_ZERO_ERROR;
+             return useAndDestroy(icu::BreakIterator::createSentenceInstance(icu::Locale::getUS(), status), status, sentences);
+         },
+         [](icuaddons::ServicePool& pool) {
+             UErrorCode status = U_ZERO_ERROR;
+             return useLease(pool.breakIterator(icuaddons::BreakType::Sentence, icu::Locale::getUS(), status), status, sentences);
+         }},
+        {"Transliterator/Latin-Cyrillic",
+         [] {
+             UErrorCode status = U_ZERO_ERROR;
+             return useAndDestroy(icu::Transliterator::createInstance("Latin-Cyrillic", UTRANS_FORWARD, status), status,
+                                  transliterate);
+         },
+         [](icuaddons::ServicePool& pool) {
+             UErrorCode status = U_ZERO_ERROR;
+             return useLease(pool.transliterator("Latin-Cyrillic", UTRANS_FORWARD, status), status, transliterate);
+         }},
+        {"ucnv/Shift-JIS",
+         [] {
+             UErrorCode status = U_ZERO_ERROR;
+             UConverter* converter = ucnv_open("Shift-JIS", &status);
+             UErrorCode result = U_SUCCESS(status) ? encode(converter) : status;
+             ucnv_close(converter);
+             return result;
+         },
+         [](icuaddons::ServicePool& pool) {
+             UErrorCode status = U_ZERO_ERROR;
+             icuaddons::Lease<UConverter> converter = pool.converter("Shift-JIS", status);
+             return U_SUCCESS(status) ? encode(converter.get()) : status;
+         }},
+    };
+    return all;
+}
+
+bool threadsSupported() {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    return false;
+#else
+    return true;
+#endif
+}
+
+// Time one request function on one thread and then on kThreads threads.
+std::vector<Result*> measureRequests(Runner& runner, const std::string& name, const std::function<UErrorCode()>& request) {
+    const Workload single{"pool", name, "", "request"};
+    const Workload threaded{"pool", name + "/threads=" + std::to_string(kThreads), "", "request"};
+    Result* result = runner.measure(single, 1, [&](size_t) {
+        request();
+        return Work{};
+    });
+    if (!threadsSupported()) {
+        runner.skip(threaded, "threads are not supported on this platform");
+        return {result};
+    }
+    // About --min-time per thread, based on the single-threaded latency
+    double meanNs = result != nullptr ? std::max(result->meanNs, 1.0) : 1e5;
+    size_t iterations = std::clamp<size_t>(static_cast<size_t>(runner.options().minSeconds * 1e9 / meanNs), 20, 200000);
+    Result* threadedResult = runner.measureThreads(threaded, kThreads, iterations, [&](size_t, size_t) {
+        request();
+        return Work{};
+    });
+    return {result, threadedResult};
+}
+
+} // namespace
+
+void runPoolSuite(Runner& runner) {
+    for (const auto& entry : requestWorkloads()) {
+        const std::string createName = std::string(entry.name) + "/create";
+        const std::string poolName   = std::string(entry.name) + "/pool";
+
+        UErrorCode status = runner.options().listOnly ? U_ZERO_ERROR : entry.create();
+        if (U_FAILURE(status)) {
+            runner.skip({"pool", createName, "", "request"}, u_errorName(status));
+            runner.skip({"pool", poolName, "", "request"}, u_errorName(status));
+            continue;
+        }
+        measureRequests(runner, createName, entry.create);
+
+        // A fresh pool per workload, so its counters cover this workload alone
+        icuaddons::ServicePool pool;
+        std::vector<Result*> results = measureRequests(runner, poolName, [&] { return entry.pooled(pool); });
+        icuaddons::ServicePoolCounters counters = pool.counters();
+        const uint64_t leases = counters.hits + counters.misses;
+        for (Result* result : results) {
+            if (result != nullptr && leases > 0) {
+                result->metrics["hit_rate"]    = static_cast<double>(counters.hits) / leases;
+                result->metrics["creations"]   = static_cast<double>(counters.creations);
+                result->metrics["creation_ns"] = static_cast<double>(counters.maxCreationNs);
+            }
+        }
+    }
+}
+
+} // namespace icubench
@@ -0,0 +1,144 @@
+#include "process.h"
+
+#include "bench.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#define ICUBENCH_HAS_SPAWN 1
+#endif
+
+namespace icubench {
+
+namespace {
+
+std::string& selfPath() {
+    static std::string path;
+    return path;
+}
+
+} // namespace
+
+void setSelfPath(const char* argv0) {
+#if defined(__linux__)
+    // Immune to PATH lookups and relative paths after a chdir()
+    if (access("/proc/self/exe", X_OK) == 0) {
+        selfPath() = "/proc/self/exe";
+        return;
+    }
+#endif
+    selfPath() = argv0 != nullptr ? argv0 : "";
+}
+
+bool canRunSelf() {
+#if defined(ICUBENCH_HAS_SPAWN)
+    return !selfPath().empty();
+#else
+    return false;
+#endif
+}
+
+ChildRun runSelf(const std::vector<std::string>& args) {
+    ChildRun run;
+#if defined(ICUBENCH_HAS_SPAWN)
+    if (selfPath().empty()) {
+        run.error = "executable path unknown";
+        return run;
+    }
+
+    std::vector<char*> argv;
+    argv.push_back(const_cast<char*>(selfPath().c_str()));
+    for (const auto& arg : args) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    int pipeFds[2];
+    if (pipe(pipeFds) != 0) {
+        run.error = std::string("pipe: ") + std::strerror(errno);
+        return run;
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addclose(&actions, pipeFds[0]);
+    posix_spawn_file_actions_adddup2(&actions, pipeFds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&actions, pipeFds[1]);
+
+    auto  start = Clock::now();
+    pid_t pid   = 0;
+    bool  usePath = selfPath().find('/') == std::string::npos;
+    int   spawnError = usePath
+        ? posix_spawnp(&pid, argv[0], &actions, nullptr, argv.data(), environ)
+        : posix_spawn (&pid, argv[0], &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(pipeFds[1]);
+
+    if (spawnError != 0) {
+        close(pipeFds[0]);
+        run.error = std::string("posix_spawn: ") + std::strerror(spawnError);
+        return run;
+    }
+
+    char buffer[4096];
+    ssize_t count;
+    while ((count = read(pipeFds[0], buffer, sizeof(buffer))) != 0) {
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        run.output.append(buffer, static_cast<size_t>(count));
+    }
+    close(pipeFds[0]);
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    run.wallNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    if (WIFEXITED(status)) {
+        run.exitCode = WEXITSTATUS(status);
+        run.ok       = run.exitCode == 0;
+        if (!run.ok) {
+            run.error = "exit code " + std::to_string(run.exitCode);
+        }
+    } else {
+        run.error = "terminated abnormally";
+    }
+#else
+    (void)args;
+    run.error = "child processes are not supported on this platform";
+#endif
+    return run;
+}
+
+double outputValue(const std::string& output, const std::string& tag) {
+    size_t position = output.rfind(tag + " ");
+    return position == std::string::npos ? -1 : std::atof(output.c_str() + position + tag.size() + 1);
+}
+
+double peakRssKb() {
+#if defined(ICUBENCH_HAS_SPAWN)
+    struct rusage usage = {};
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+        return usage.ru_maxrss / 1024.0;  // Bytes on macOS
+#else
+        return static_cast<double>(usage.ru_maxrss);
+#endif
+    }
+#endif
+    return 0;
+}
+
+} // namespace icubench
@@ -0,0 +1,41 @@
+#pragma once
+
+/*
+ * ICU4C Package Benchmark - child processes
+ *
+ * Some workloads (cold start, allocator and warm-up comparisons) need a fresh
+ * process in which ICU has not loaded any data yet. They run the benchmark
+ * executable again with an internal option and read back what it printed.
+ */
+
+#include <string>
+#include <vector>
+
+namespace icubench {
+
+struct ChildRun {
+    bool        ok       = false;  // Started and exited with status 0
+    int         exitCode = -1;
+    std::string output;            // Captured stdout
+    std::string error;             // Why the child could not be run
+    double      wallNs   = 0;      // Spawn to exit, as seen by the parent
+};
+
+// Remember how this executable was started (argv[0]); call once from main().
+void setSelfPath(const char* argv0);
+
+// Whether runSelf() is supported on this platform.
+bool canRunSelf();
+
+// Run this executable again with `args` (plus the inherited environment) and
+// wait for it to exit.
+ChildRun runSelf(const std::vector<std::string>& args);
+
+// The number a child printed after `tag` and a space ("startup-probe-ns 1234"),
+// or -1 if it printed none.
+double outputValue(const std::string& output, const std::string& tag);
+
+// Peak resident set size of this process in kB, 0 where it is not known.
+double peakRssKb();
+
+} // namespace icubench
@@ -0,0 +1,250 @@
+/*
+ * Search workloads: regular expressions and collation-aware string search
+ * over the documents of a multilingual corpus, one shard per document.
+ *
+ * Regular expressions (literal, alternation, character classes, case
+ * insensitive) run three ways:
+ *
+ *   compile-per-shard  RegexPattern::compile and a new matcher per document
+ *   unicodestring      one compiled pattern and matcher, each document
+ *                      converted to a new UnicodeString
+ *   searcher           icuaddons::Searcher: one matcher reset to each
+ *                      document converted into a reused UTF-16 buffer
+ *   utf8-utext         icuaddons::Searcher with regexOverUTF8: one matcher
+ *                      reset to a UTF-8 UText of each document, no conversion
+ *
+ * StringSearch patterns run at primary, secondary and tertiary strength,
+ * opened per document (usearch_openFromCollator) and through a Searcher.
+ * "all" counts every pattern with icuaddons::countMatches() on each thread
+ * count of --threads (default 1 and the number of cores).
+ *
+ * Throughput is MB/s of searched UTF-8; the results carry the matches found.
+ */
+
+#include "corpus.h"
+#include "suites.h"
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <icuaddons/search.h>
+
+#include <unicode/coll.h>
+#include <unicode/locid.h>
+#include <unicode/regex.h>
+#include <unicode/unistr.h>
+#include <unicode/usearch.h>
+
+namespace icubench {
+
+namespace {
+
+// Documents per language of the searched corpus, times --scale.
+constexpr size_t kDocumentScale = 8;
+
+struct RegexCase {
+    const char* name;
+    const char16_t* pattern;
+    uint32_t flags;
+};
+
+const RegexCase kRegexes[] = {
+    {"literal",          u"dignity",                                                  0},
+    {"alternation",      u"free|libres|frei|свобод|ελεύθεροι|自由|자유",               0},
+    {"class",            u"\\b\\p{Lu}\\p{Ll}+\\b",                                    0},
+    {"case-insensitive", u"HUMAN|MENSCHEN|HUMAINS|HUMANOS",                           UREGEX_CASE_INSENSITIVE},
+};
+
+struct StrengthCase {
+    const char*        name;
+    UColAttributeValue strength;
+};
+
+const StrengthCase kStrengths[] = {
+    {"primary",   UCOL_PRIMARY},    // "dignite" finds "dignité" and "Dignité"
+    {"secondary", UCOL_SECONDARY},
+    {"tertiary",  UCOL_TERTIARY},
+};
+
+const char16_t kCollatedText[] = u"dignite";
+
+bool threadsSupported() {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    return false;
+#else
+    return true;
+#endif
+}
+
+void setMatches(Result* result, uint64_t matches) {
+    if (result != nullptr) {
+        result->metrics["matches"] = static_cast<double>(matches);
+    }
+}
+
+} // namespace
+
+void runSearchSuite(Runner& runner) {
+    const Corpus corpus = multilingualDocuments(kDocumentScale * runner.options().scale);
+    std::string text;
+    std::vector<uint32_t> offsets = {0};
+    for (const auto& document : corpus.items) {
+        text += document;
+        offsets.push_back(static_cast<uint32_t>(text.size()));
+    }
+    const size_t shards = corpus.items.size();
+    const Work work{text.size(), shards};
+    const std::string unit = std::to_string(shards) + " documents";
+    auto workload = [&](const std::string& name) { return Workload{"search", name, corpus.name, unit}; };
+
+    for (const auto& entry : kRegexes) {
+        const std::string name = std::string("regex/") + entry.name;
+        UErrorCode status = U_ZERO_ERROR;
+        UParseError parseError;
+        std::unique_ptr<icu::RegexPattern> pattern(icu::RegexPattern::compile(entry.pattern, entry.flags, parseError, status));
+        icuaddons::SearchPatterns patterns;
+        patterns.addRegex(entry.pattern, entry.flags, status);
+        icuaddons::Searcher searcher(patterns, status);
+        if (U_FAILURE(status)) {
+            runner.skip(workload(name + "/searcher"), u_errorName(status));
+            continue;
+        }
+        icuaddons::Searcher utext(patterns, status, true);
+
+        uint64_t matches = 0;
+        Result* result = runner.measure(workload(name + "/compile-per-shard"), 1, [&](size_t) {
+            matches = 0;
+            for (const auto& document : corpus.items) {
+                UErrorCode error = U_ZERO_ERROR;
+                UParseError parse;
+                std::unique_ptr<icu::RegexPattern> compiled(icu::RegexPattern::compile(entry.pattern, entry.flags, parse, error));
+                const icu::UnicodeString utf16 = icu::UnicodeString::fromUTF8(document);  // The matcher keeps a reference
+                std::unique_ptr<icu::RegexMatcher> matcher(compiled->matcher(utf16, error));
+                while (matcher->find(error)) {
+                    ++matches;
+                }
+            }
+            return work;
+        });
+        setMatches(result, matches);
+
+        std::unique_ptr<icu::RegexMatcher> matcher(pattern->matcher(status));
+        result = runner.measure(workload(name + "/unicodestring"), 1, [&](size_t) {
+            matches = 0;
+            for (const auto& document : corpus.items) {
+                UErrorCode error = U_ZERO_ERROR;
+                const icu::UnicodeString utf16 = icu::UnicodeString::fromUTF8(document);
+                matcher->reset(utf16);
+                while (matcher->find(error)) {
+                    ++matches;
+                }
+            }
+            return work;
+        });
+        setMatches(result, matches);
+
+        const uint64_t expected = matches;
+        for (auto* how : {&searcher, &utext}) {
+            result = runner.measure(workload(name + (how == &searcher ? "/searcher" : "/utf8-utext")), 1, [&](size_t) {
+                matches = 0;
+                for (const auto& document : corpus.items) {
+                    UErrorCode error = U_ZERO_ERROR;
+                    matches += how->count(0, document.data(), document.size(), error);
+                }
+                return work;
+            });
+            setMatches(result, matches);
+            if (result != nullptr && matches != expected) {
+                std::cerr << "❌ search/" << name << ": " << matches << " matches, expected " << expected << std::endl;
+            }
+        }
+    }
+
+    for (const auto& entry : kStrengths) {
+        const std::string name = std::string("collation/") + entry.name;
+        UErrorCode status = U_ZERO_ERROR;
+        std::unique_ptr<icu::Collator> collator(icu::Collator::createInstance(icu::Locale::getFrance(), status));
+        icuaddons::SearchPatterns patterns;
+        patterns.addCollated(kCollatedText, icu::Locale::getFrance(), entry.strength, status);
+        icuaddons::Searcher searcher(patterns, status);
+        if (U_FAILURE(status)) {
+            runner.skip(workload(name + "/searcher"), u_errorName(status));
+            continue;
+        }
+        collator->setAttribute(UCOL_STRENGTH, entry.strength, status);
+
+        uint64_t matches = 0;
+        Result* result = runner.measure(workload(name + "/open-per-shard"), 1, [&](size_t) {
+            matches = 0;
+            for (const auto& document : corpus.items) {
+                UErrorCode error = U_ZERO_ERROR;
+                const icu::UnicodeString utf16 = icu::UnicodeString::fromUTF8(document);
+                UStringSearch* search = usearch_openFromCollator(kCollatedText, -1, utf16.getBuffer(), utf16.length(),
+                                                                 collator->toUCollator(), nullptr, &error);
+                for (int32_t p = usearch_first(search, &error); U_SUCCESS(error) && p != USEARCH_DONE;
+                     p = usearch_next(search, &error)) {
+                    ++matches;
+                }
+                usearch_close(search);
+            }
+            return work;
+        });
+        setMatches(result, matches);
+
+        const uint64_t expected = matches;
+        result = runner.measure(workload(name + "/searcher"), 1, [&](size_t) {
+            matches = 0;
+            for (const auto& document : corpus.items) {
+                UErrorCode error = U_ZERO_ERROR;
+                matches += searcher.count(0, document.data(), document.size(), error);
+            }
+            return work;
+        });
+        setMatches(result, matches);
+        if (result != nullptr && matches != expected) {
+            std::cerr << "❌ search/" << name << ": " << matches << " matches, expected " << expected << std::endl;
+        }
+    }
+
+    // Every pattern at once over the shards, on several threads
+    UErrorCode status = U_ZERO_ERROR;
+    icuaddons::SearchPatterns all;
+    for (const auto& entry : kRegexes) {
+        all.addRegex(entry.pattern, entry.flags, status);
+    }
+    for (const auto& entry : kStrengths) {
+        all.addCollated(kCollatedText, icu::Locale::getFrance(), entry.strength, status);
+    }
+    std::vector<size_t> threadCounts = runner.options().threadCounts;
+    if (threadCounts.empty()) {
+        threadCounts = {1};
+        if (std::thread::hardware_concurrency() > 1) {
+            threadCounts.push_back(std::thread::hardware_concurrency());
+        }
+    }
+    if (!threadsSupported()) {
+        threadCounts = {1};
+    }
+    for (size_t threads : threadCounts) {
+        const Workload parallel = workload("all/threads=" + std::to_string(threads));
+        if (U_FAILURE(status)) {
+            runner.skip(parallel, u_errorName(status));
+            continue;
+        }
+        uint64_t matches = 0;
+        Result* result = runner.measure(parallel, 1, [&](size_t) {
+            UErrorCode error = U_ZERO_ERROR;
+            matches = 0;
+            for (uint64_t count : icuaddons::countMatches(all, text.data(), offsets.data(), shards, error, threads)) {
+                matches += count;
+            }
+            return work;
+        });
+        setMatches(result, matches);
+    }
+}
+
+} // namespace icubench
@@ -0,0 +1,242 @@
+/*
+ * Sorting workloads: ordering a large dataset of strings by collation.
+ *
+ * Each strategy sorts the same N records (--sort-sizes, default 100k and
+ * 1M) and is timed end to end, including any key generation:
+ *
+ *   compare        std::sort with Collator::compare on UTF-16 strings
+ *   compareUTF8    std::sort with Collator::compareUTF8 on the UTF-8 input
+ *   CollationKey   one CollationKey per string, std::sort with compareTo
+ *   packed+memcmp  icuaddons::buildSortKeysUTF8 into one arena, std::sort with memcmp
+ *   packed+radix   icuaddons::buildSortKeysUTF8 and icuaddons::sortedOrder (MSD radix sort)
+ *
+ * and runs on every thread count of --threads (default 1 and the number of
+ * cores). The comparator sorts split the records into one run per thread and
+ * merge the runs. Throughput counts sorted strings per second.
+ */
+
+#include "corpus.h"
+#include "suites.h"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <icuaddons/sortkeys.h>
+
+#include <unicode/coll.h>
+#include <unicode/locid.h>
+#include <unicode/sortkey.h>
+#include <unicode/unistr.h>
+
+namespace icubench {
+
+namespace {
+
+bool threadsSupported() {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    return false;
+#else
+    return true;
+#endif
+}
+
+std::string sizeLabel(size_t count) {
+    if (count % 1000000 == 0) {
+        return std::to_string(count / 1000000) + "M";
+    }
+    if (count % 1000 == 0) {
+        return std::to_string(count / 1000) + "k";
+    }
+    return std::to_string(count);
+}
+
+// Run `work(t)` for t = 0 .. threads-1 on their own threads.
+template <typename Work>
+void runOnThreads(size_t threads, Work&& work) {
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back(work, t);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+// std::sort of one run per thread, then pairwise merges of the runs.
+template <typename Less>
+void parallelSort(std::vector<uint32_t>& order, size_t threads, Less less) {
+    const size_t count = order.size();
+    std::vector<size_t> bounds;
+    for (size_t t = 0; t <= threads; ++t) {
+        bounds.push_back(count * t / threads);
+    }
+    runOnThreads(threads, [&](size_t t) {
+        std::sort(order.begin() + bounds[t], order.begin() + bounds[t + 1], less);
+    });
+    for (size_t width = 1; width < threads; width *= 2) {
+        std::vector<size_t> starts;
+        for (size_t t = 0; t + width < threads; t += 2 * width) {
+            starts.push_back(t);
+        }
+        runOnThreads(starts.size(), [&](size_t i) {
+            size_t t = starts[i];
+            std::inplace_merge(order.begin() + bounds[t], order.begin() + bounds[t + width],
+                               order.begin() + bounds[std::min(t + 2 * width, threads)], less);
+        });
+    }
+}
+
+std::vector<uint32_t> identity(size_t count) {
+    std::vector<uint32_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    return order;
+}
+
+} // namespace
+
+void runSortSuite(Runner& runner) {
+    const Options& options = runner.options();
+    std::vector<size_t> sizes = options.sortSizes;
+    if (sizes.empty()) {
+        sizes = {100000 * options.scale, 1000000 * options.scale};
+    }
+    std::vector<size_t> threadCounts = options.threadCounts;
+    if (threadCounts.empty()) {
+        threadCounts = {1};
+        if (std::thread::hardware_concurrency() > 1) {
+            threadCounts.push_back(std::thread::hardware_concurrency());
+        }
+    }
+    if (!threadsSupported()) {
+        threadCounts = {1};
+    }
+
+    UErrorCode status = U_ZERO_ERROR;
+    std::unique_ptr<icu::Collator> collator(icu::Collator::createInstance(icu::Locale::getEnglish(), status));
+    if (U_FAILURE(status)) {
+        runner.skip({"sort", "*", "", ""}, u_errorName(status));
+        return;
+    }
+
+    for (size_t count : sizes) {
+        const std::string size = sizeLabel(count);
+        auto workload = [&](const std::string& strategy, size_t threads) {
+            return Workload{"sort", strategy + "/" + size + "/threads=" + std::to_string(threads),
+                            "multilingual-records", std::to_string(count) + " strings"};
+        };
+        bool anySelected = false;
+        for (const char* strategy : {"compare", "compareUTF8", "CollationKey", "packed+memcmp", "packed+radix"}) {
+            for (size_t threads : threadCounts) {
+                anySelected = anySelected || runner.selected("sort", workload(strategy, threads).name);
+            }
+        }
+        if (!anySelected) {
+            continue;
+        }
+        if (options.listOnly) {
+            for (const char* strategy : {"compare", "compareUTF8", "CollationKey", "packed+memcmp", "packed+radix"}) {
+                for (size_t threads : threadCounts) {
+                    runner.measureLong(workload(strategy, threads), 1, [] { return Work{}; });
+                }
+            }
+            continue;
+        }
+
+        // The input: UTF-8 records back to back, as read from a file or a column
+        const Corpus corpus = records(count);
+        std::string text;
+        std::vector<uint32_t> offsets = {0};
+        offsets.reserve(count + 1);
+        for (const auto& item : corpus.items) {
+            text += item;
+            offsets.push_back(static_cast<uint32_t>(text.size()));
+        }
+        std::vector<icu::UnicodeString> utf16;
+        utf16.reserve(count);
+        for (const auto& item : corpus.items) {
+            utf16.push_back(icu::UnicodeString::fromUTF8(item));
+        }
+        const Work work{text.size(), count};
+
+        for (size_t threads : threadCounts) {
+            runner.measureLong(workload("compare", threads), 3, [&] {
+                std::vector<uint32_t> order = identity(count);
+                parallelSort(order, threads, [&](uint32_t a, uint32_t b) {
+                    UErrorCode error = U_ZERO_ERROR;
+                    return collator->compare(utf16[a], utf16[b], error) == UCOL_LESS;
+                });
+                keep(order.front());
+                return work;
+            });
+
+            runner.measureLong(workload("compareUTF8", threads), 3, [&] {
+                std::vector<uint32_t> order = identity(count);
+                parallelSort(order, threads, [&](uint32_t a, uint32_t b) {
+                    UErrorCode error = U_ZERO_ERROR;
+                    return collator->compareUTF8(corpus.items[a], corpus.items[b], error) == UCOL_LESS;
+                });
+                keep(order.front());
+                return work;
+            });
+
+            runner.measureLong(workload("CollationKey", threads), 3, [&] {
+                std::vector<icu::CollationKey> keys(count);
+                runOnThreads(threads, [&](size_t t) {
+                    UErrorCode error = U_ZERO_ERROR;
+                    for (size_t i = count * t / threads; i < count * (t + 1) / threads; ++i) {
+                        collator->getCollationKey(utf16[i], keys[i], error);
+                    }
+                });
+                std::vector<uint32_t> order = identity(count);
+                parallelSort(order, threads, [&](uint32_t a, uint32_t b) {
+                    UErrorCode error = U_ZERO_ERROR;
+                    return keys[a].compareTo(keys[b], error) == UCOL_LESS;
+                });
+                keep(order.front());
+                return work;
+            });
+
+            Result* packed = runner.measureLong(workload("packed+memcmp", threads), 3, [&] {
+                icuaddons::PackedSortKeys keys;
+                UErrorCode error = U_ZERO_ERROR;
+                icuaddons::buildSortKeysUTF8(*collator, text.data(), offsets.data(), count, keys, error, threads);
+                std::vector<uint32_t> order = identity(count);
+                parallelSort(order, threads, [&](uint32_t a, uint32_t b) { return keys.compare(a, b) < 0; });
+                keep(order.front());
+                return work;
+            });
+
+            icuaddons::PackedSortKeys keys;
+            std::vector<uint32_t> order;
+            Result* radix = runner.measureLong(workload("packed+radix", threads), 3, [&] {
+                UErrorCode error = U_ZERO_ERROR;
+                icuaddons::buildSortKeysUTF8(*collator, text.data(), offsets.data(), count, keys, error, threads);
+                icuaddons::sortedOrder(keys, order, threads);
+                keep(order.front());
+                return work;
+            });
+            for (Result* result : {packed, radix}) {
+                if (result != nullptr && radix != nullptr) {
+                    result->metrics["key_bytes_per_string"] = static_cast<double>(keys.bytes.size()) / count;
+                }
+            }
+
+            // The radix order must agree with Collator::compareUTF8
+            for (size_t i = 1; radix != nullptr && i < order.size(); ++i) {
+                UErrorCode error = U_ZERO_ERROR;
+                if (collator->compareUTF8(corpus.items[order[i - 1]], corpus.items[order[i]], error) == UCOL_GREATER) {
+                    std::cerr << "❌ sort/packed+radix/" << size << ": records " << order[i - 1] << " and " << order[i]
+                              << " are out of collation order" << std::endl;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+} // namespace icubench
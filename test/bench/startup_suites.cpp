@@ -0,0 +1,255 @@
+/*
+ * Cold-start workloads: the cost of the first ICU call in a fresh process.
+ *
+ * Each sample runs this executable again with --startup-probe NAME. The child
+ * sets up the data directory like an application would, times a single first
+ * call (which has to locate, open and map the ICU data) and prints the result.
+ * With the archive packaging this includes finding icudt*.dat on disk; with
+ * the static-data variant the data is already linked into the executable.
+ *
+ * The "lazy/" workloads start from the split data instead (build.sh
+ * --variant=data-split): the child installs icuaddons::LazyData over
+ * <data directory>/split, or ICU_SPLIT_DATA_DIR, with a fresh cache directory
+ * and times install, require() and the first call together. They are skipped
+ * when there is no split data.
+ *
+ * The "warm/" workloads first run icuaddons::warmUp() over a manifest of the
+ * probed service with DataPages::Prefault, timed apart ("warmup_ns"), and
+ * then time the same first call: the latency a server sees on its first
+ * request after warming up. The "preloaded/" workloads read the .dat into
+ * huge pages with icuaddons::PreloadedData and time that and the first call
+ * together; they are skipped when the data is not in a .dat file.
+ *
+ * The latency columns are the child's first-call time. The "process_*"
+ * metrics are spawn-to-exit wall times seen by the parent, "data_bytes" the
+ * ICU data the child had to read (the whole .dat, or the items LazyData
+ * loaded) and "maxrss_kb" its peak resident set size.
+ */
+
+#include "process.h"
+#include "suites.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <icuaddons/lazydata.h>
+#include <icuaddons/warmup.h>
+
+#include <unicode/brkiter.h>
+#include <unicode/coll.h>
+#include <unicode/locid.h>
+#include <unicode/normalizer2.h>
+#include <unicode/putil.h>
+#include <unicode/ucnv.h>
+#include <unicode/uclean.h>
+
+namespace icubench {
+
+namespace {
+
+struct Probe {
+    const char* name;
+    UErrorCode (*call)();
+    void (*require)(icuaddons::LazyData& data, UErrorCode& status);  // What the call needs of the split data
+    const char* manifest;                                            // Warm-up manifest of the service
+};
+
+const std::vector<Probe>& probes() {
+    static const std::vector<Probe> all = {
+        {"u_init", [] {
+            UErrorCode status = U_ZERO_ERROR;
+            u_init(&status);
+            return status;
+        }, [](icuaddons::LazyData&, UErrorCode&) {}, ""},
+        {"Collator::createInstance", [] {
+            UErrorCode status = U_ZERO_ERROR;
+            delete icu::Collator::createInstance(icu::Locale::getEnglish(), status);
+            return status;
+        }, [](icuaddons::LazyData& data, UErrorCode& status) {
+            data.require(icuaddons::DataFeature::Collation, "en", status);
+        }, "collator en"},
+        {"BreakIterator::createWordInstance", [] {
+            UErrorCode status = U_ZERO_ERROR;
+            delete icu::BreakIterator::createWordInstance(icu::Locale::getEnglish(), status);
+            return status;
+        }, [](icuaddons::LazyData& data, UErrorCode& status) {
+            data.require(icuaddons::DataFeature::BreakIteration, "en", status);
+        }, "word-break en"},
+        {"Normalizer2::getNFCInstance", [] {
+            UErrorCode status = U_ZERO_ERROR;
+            keep(icu::Normalizer2::getNFCInstance(status));
+            return status;
+        }, [](icuaddons::LazyData&, UErrorCode&) {}, "normalizer nfc"},
+        {"ucnv_open/Shift-JIS", [] {
+            UErrorCode status = U_ZERO_ERROR;
+            ucnv_close(ucnv_open("Shift-JIS", &status));
+            return status;
+        }, [](icuaddons::LazyData& data, UErrorCode& status) {
+            data.requireConverter("Shift-JIS", status);
+        }, "converter Shift-JIS"},
+    };
+    return all;
+}
+
+const std::string kLazyPrefix      = "lazy/";
+const std::string kWarmPrefix      = "warm/";
+const std::string kPreloadedPrefix = "preloaded/";
+
+// The .dat the regular workloads find, empty with the data linked in
+std::filesystem::path dataFile() {
+    std::filesystem::path file = std::filesystem::path(u_getDataDirectory()) / (U_ICUDATA_NAME ".dat");
+    std::error_code error;
+    return std::filesystem::is_regular_file(file, error) ? file : std::filesystem::path();
+}
+
+// The split data (index.txt, icudt*l/...) of the lazy workloads
+std::string splitDataDirectory() {
+    const char* directory = std::getenv("ICU_SPLIT_DATA_DIR");
+    if (directory != nullptr && directory[0] != '\0') {
+        return directory;
+    }
+    return std::string(u_getDataDirectory()) + "/split";
+}
+
+// Number of child processes per probe when --min-time alone would run fewer.
+constexpr size_t kMinRuns = 20;
+
+} // namespace
+
+int runStartupProbe(const std::string& name) {
+    std::string prefix;
+    for (const std::string& candidate : {kLazyPrefix, kWarmPrefix, kPreloadedPrefix}) {
+        if (name.compare(0, candidate.size(), candidate) == 0) {
+            prefix = candidate;
+        }
+    }
+    const bool lazy = prefix == kLazyPrefix;
+    const std::string probeName = name.substr(prefix.size());
+    for (const auto& probe : probes()) {
+        if (probeName != probe.name) {
+            continue;
+        }
+        std::filesystem::path cache;
+        if (lazy) {
+            cache = std::filesystem::temp_directory_path() / ("icu-lazy-data-" + std::to_string(std::random_device()()));
+        }
+        icuaddons::LazyData data(icuaddons::directoryLoader(splitDataDirectory()), cache.string());
+        icuaddons::PreloadedData preloaded;
+
+        UErrorCode status = U_ZERO_ERROR;
+        double warmupNs = -1;
+        if (prefix == kWarmPrefix) {
+            icuaddons::WarmupManifest manifest;
+            icuaddons::WarmupOptions options;
+            options.dataPages = icuaddons::DataPages::Prefault;
+            icuaddons::WarmupReport report;
+            icuaddons::parseWarmupManifest(probe.manifest, manifest, status);
+            icuaddons::warmUp(manifest, options, report, status);
+            warmupNs = static_cast<double>(report.totalNs);
+        }
+
+        auto start = Clock::now();
+        if (lazy) {
+            data.install(status);
+            probe.require(data, status);
+        } else if (prefix == kPreloadedPrefix) {
+            preloaded.load(dataFile().string(), true, status);
+        }
+        if (U_SUCCESS(status)) {
+            status = probe.call();
+        }
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+        double dataBytes = 0;
+        if (lazy) {
+            dataBytes = static_cast<double>(data.bytesLoaded());
+        } else {
+            std::error_code error;
+            auto size = std::filesystem::file_size(std::filesystem::path(u_getDataDirectory()) / (U_ICUDATA_NAME ".dat"), error);
+            dataBytes = error ? 0 : static_cast<double>(size);  // 0 with the data linked in
+        }
+        if (lazy || prefix == kPreloadedPrefix) {
+            u_cleanup();  // Unmap the items before removing them, release the preloaded data
+            std::error_code error;
+            std::filesystem::remove_all(cache, error);
+        }
+        if (U_FAILURE(status)) {
+            std::cerr << u_errorName(status) << std::endl;
+            return 1;
+        }
+        std::cout << "startup-probe-ns " << ns << std::endl;
+        std::cout << "startup-probe-data-bytes " << dataBytes << std::endl;
+        std::cout << "startup-probe-maxrss-kb " << peakRssKb() << std::endl;
+        if (warmupNs >= 0) {
+            std::cout << "startup-probe-warmup-ns " << warmupNs << std::endl;
+        }
+        if (prefix == kPreloadedPrefix) {
+            std::cout << "startup-probe-huge-pages " << (preloaded.hugePages() ? 1 : 0) << std::endl;
+        }
+        return 0;
+    }
+    std::cerr << "Unknown startup probe: " << name << std::endl;
+    return 2;
+}
+
+void runStartupSuite(Runner& runner) {
+    const bool hasSplitData = std::filesystem::exists(std::filesystem::path(splitDataDirectory()) / "index.txt");
+    const bool hasDataFile  = !dataFile().empty();
+    for (const std::string& prefix : {std::string(), kLazyPrefix, kWarmPrefix, kPreloadedPrefix}) {
+        for (const auto& probe : probes()) {
+            const Workload workload{"startup", prefix + probe.name, "", "first call"};
+            if (!canRunSelf()) {
+                runner.skip(workload, "child processes are not supported on this platform");
+                continue;
+            }
+            if (prefix == kLazyPrefix && !hasSplitData) {
+                runner.skip(workload, "no split data in " + splitDataDirectory() + " (build.sh --variant=data-split)");
+                continue;
+            }
+            if (prefix == kPreloadedPrefix && !hasDataFile) {
+                runner.skip(workload, "no " U_ICUDATA_NAME ".dat in the data directory (data linked in)");
+                continue;
+            }
+
+            std::string failure;
+            std::vector<double> processNs, dataBytes, maxRss, warmupNs, hugePages;
+            Result* result = runner.measureReported(workload, kMinRuns, [&](size_t) {
+                ChildRun run = runSelf({"--startup-probe", workload.name});
+                double ns = outputValue(run.output, "startup-probe-ns");
+                if (!run.ok || ns < 0) {
+                    failure = run.error.empty() ? "no probe output" : run.error;
+                    return -1.0;
+                }
+                processNs.push_back(run.wallNs);
+                dataBytes.push_back(outputValue(run.output, "startup-probe-data-bytes"));
+                maxRss.push_back(outputValue(run.output, "startup-probe-maxrss-kb"));
+                warmupNs.push_back(outputValue(run.output, "startup-probe-warmup-ns"));
+                hugePages.push_back(outputValue(run.output, "startup-probe-huge-pages"));
+                return ns;
+            });
+
+            if (result != nullptr) {
+                result->metrics["process_p50_ns"] = percentile(processNs, 50);
+                result->metrics["process_p99_ns"] = percentile(processNs, 99);
+                result->metrics["data_bytes"]     = percentile(dataBytes, 50);
+                if (percentile(maxRss, 50) > 0) {
+                    result->metrics["maxrss_kb"] = percentile(maxRss, 50);
+                }
+                if (prefix == kWarmPrefix) {
+                    result->metrics["warmup_ns"] = percentile(warmupNs, 50);
+                }
+                if (prefix == kPreloadedPrefix) {
+                    result->metrics["huge_pages"] = percentile(hugePages, 50);
+                }
+            } else if (!failure.empty()) {
+                runner.skip(workload, failure);
+            }
+        }
+    }
+}
+
+} // namespace icubench
@@ -0,0 +1,231 @@
+/*
+ * Streaming workloads: one pass over a large UTF-8 file, two ways.
+ *
+ *   unicodestring  How test.cpp handles text: the file is read into memory and
+ *                  every document (line) is converted into an icu::UnicodeString
+ *                  before the BreakIterator or the converter sees it.
+ *   stream         The zero-copy layer of icuaddons/utf8stream.h: the file is
+ *                  mapped, segmented through utext_openUTF8() in windows that
+ *                  are released once done, and converted with ucnv_convertEx()
+ *                  over fixed pivot and output buffers.
+ *
+ * The file (--stream-mb, default 256 MB; use 1024 or more for GB-scale runs)
+ * is generated once from the multilingual documents. Every pass runs in a
+ * child process (--stream-probe), so "maxrss_kb" is the peak resident set of
+ * that pass alone; the throughput includes the child's start-up, which is
+ * small next to the pass.
+ */
+
+#include "corpus.h"
+#include "process.h"
+#include "suites.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <icuaddons/utf8stream.h>
+
+#include <unicode/brkiter.h>
+#include <unicode/locid.h>
+#include <unicode/stringpiece.h>
+#include <unicode/ucnv.h>
+#include <unicode/unistr.h>
+
+namespace icubench {
+
+namespace {
+
+// Passes over the file per workload (each one a child process).
+constexpr size_t kRuns = 3;
+
+const char* const kTargetCharset = "Shift-JIS";
+
+// Read the file and hand every line to `document` (the UnicodeString path).
+template <typename Document>
+bool forEachLine(const std::string& path, Document&& document) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    for (size_t begin = 0; begin < text.size();) {
+        size_t end = text.find('\n', begin);
+        end = end == std::string::npos ? text.size() : end;
+        document(icu::StringPiece(text.data() + begin, static_cast<int32_t>(end - begin)));
+        begin = end + 1;
+    }
+    return true;
+}
+
+// Map the file and hand it to `window` in pieces that end after a newline (the stream path).
+template <typename Window>
+bool forEachWindow(const std::string& path, UErrorCode& status, Window&& window) {
+    icuaddons::MappedFile file(path, status);
+    for (size_t begin = 0, end = 0; U_SUCCESS(status) && begin < file.size(); begin = end) {
+        end = icuaddons::nextWindow(file.data(), begin, file.size());
+        window(file.data() + begin, end - begin, end == file.size());
+        file.release(begin, end);
+    }
+    return U_SUCCESS(status);
+}
+
+// One pass of a workload; returns the segments or output bytes it produced.
+uint64_t runPass(const std::string& name, const std::string& path, UErrorCode& status) {
+    uint64_t produced = 0;
+    if (name == "words/unicodestring" || name == "words/stream") {
+        std::unique_ptr<icu::BreakIterator> words(icu::BreakIterator::createWordInstance(icu::Locale::getEnglish(), status));
+        if (U_FAILURE(status)) {
+            return 0;
+        }
+        if (name == "words/unicodestring") {
+            forEachLine(path, [&](icu::StringPiece line) {
+                icu::UnicodeString document = icu::UnicodeString::fromUTF8(line);
+                words->setText(document);
+                for (words->first(); words->next() != icu::BreakIterator::DONE;) {
+                    ++produced;
+                }
+            }) || (status = U_FILE_ACCESS_ERROR);
+        } else {
+            forEachWindow(path, status, [&](const char* text, size_t length, bool) {
+                icuaddons::UTF8Segments segments(*words, text, length, status);
+                size_t begin = 0, end = 0;
+                while (segments.next(begin, end)) {  // Also counts the newlines between documents
+                    ++produced;
+                }
+            });
+        }
+    } else if (name == "shift-jis/unicodestring") {
+        UConverter* converter = ucnv_open(kTargetCharset, &status);
+        if (U_SUCCESS(status)) {
+            forEachLine(path, [&](icu::StringPiece line) {
+                icu::UnicodeString document = icu::UnicodeString::fromUTF8(line);
+                std::string encoded(static_cast<size_t>(UCNV_GET_MAX_BYTES_FOR_STRING(document.length(), 2)), '\0');
+                UErrorCode error = U_ZERO_ERROR;
+                produced += ucnv_fromUChars(converter, encoded.data(), static_cast<int32_t>(encoded.size()),
+                                            document.getBuffer(), document.length(), &error);
+            }) || (status = U_FILE_ACCESS_ERROR);
+        }
+        ucnv_close(converter);
+    } else if (name == "shift-jis/stream") {
+        icuaddons::StreamTranscoder transcoder("UTF-8", kTargetCharset, status);
+        forEachWindow(path, status, [&](const char* text, size_t length, bool last) {
+            transcoder.convert(text, length, last, [&](const char*, size_t bytes) { produced += bytes; }, status);
+        });
+    } else {
+        status = U_ILLEGAL_ARGUMENT_ERROR;
+    }
+    return produced;
+}
+
+const std::vector<std::string>& workloadNames() {
+    static const std::vector<std::string> all = {
+        "words/unicodestring", "words/stream", "shift-jis/unicodestring", "shift-jis/stream",
+    };
+    return all;
+}
+
+// Documents one per line until the file holds `bytes`
+bool writeInput(const std::string& path, uint64_t bytes) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    Corpus documents = multilingualDocuments(1);
+    uint64_t written = 0;
+    while (file && written < bytes) {
+        for (std::string document : documents.items) {
+            for (char& c : document) {
+                c = c == '\n' ? ' ' : c;
+            }
+            document += '\n';
+            file.write(document.data(), static_cast<std::streamsize>(document.size()));
+            written += document.size();
+        }
+    }
+    return static_cast<bool>(file);
+}
+
+} // namespace
+
+int runStreamingProbe(const std::string& name, const std::string& path) {
+    UErrorCode status = U_ZERO_ERROR;
+    uint64_t produced = runPass(name, path, status);
+    if (U_FAILURE(status)) {
+        std::cerr << u_errorName(status) << std::endl;
+        return 1;
+    }
+    std::cout << "stream-probe-produced " << produced << std::endl;
+    std::cout << "stream-probe-maxrss-kb " << peakRssKb() << std::endl;
+    return 0;
+}
+
+void runStreamingSuite(Runner& runner) {
+    const uint64_t fileBytes = static_cast<uint64_t>(runner.options().streamMegabytes) << 20;
+    std::vector<Workload> workloads;
+    bool anySelected = false;
+    for (const auto& name : workloadNames()) {
+        workloads.push_back({"streaming", name, "multilingual-lines", "file pass"});
+        anySelected = anySelected || runner.selected("streaming", name);
+    }
+    if (!anySelected) {
+        return;
+    }
+    if (!runner.options().listOnly && !canRunSelf()) {
+        for (const auto& workload : workloads) {
+            runner.skip(workload, "child processes are not supported on this platform");
+        }
+        return;
+    }
+
+    std::filesystem::path path;
+    if (!runner.options().listOnly) {
+        path = std::filesystem::temp_directory_path() / ("icu-bench-stream-" + std::to_string(std::random_device()()) + ".txt");
+        if (!writeInput(path.string(), fileBytes)) {
+            for (const auto& workload : workloads) {
+                runner.skip(workload, "cannot write the input file " + path.string());
+            }
+            return;
+        }
+    }
+    const uint64_t size = path.empty() ? 0 : std::filesystem::file_size(path);
+
+    for (const auto& workload : workloads) {
+        if (!runner.selected(workload.suite, workload.name)) {
+            continue;
+        }
+        auto pass = [&] { return runSelf({"--stream-probe", workload.name, "--stream-file", path.string()}); };
+
+        // The first pass checks the workload (and warms the page cache for both paths)
+        if (!runner.options().listOnly) {
+            ChildRun check = pass();
+            if (!check.ok) {
+                runner.skip(workload, !check.error.empty() ? check.error
+                                                           : "probe exited with status " + std::to_string(check.exitCode));
+                continue;
+            }
+        }
+
+        std::vector<double> maxRss;
+        double produced = 0;
+        Result* result = runner.measureLong(workload, kRuns, [&] {
+            ChildRun run = pass();
+            maxRss.push_back(outputValue(run.output, "stream-probe-maxrss-kb"));
+            produced = outputValue(run.output, "stream-probe-produced");
+            return Work{size, 1};
+        });
+        if (result != nullptr) {
+            result->metrics["maxrss_kb"] = percentile(maxRss, 50);
+            result->metrics[workload.name.compare(0, 5, "words") == 0 ? "segments" : "output_bytes"] = produced;
+        }
+    }
+
+    if (!path.empty()) {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    }
+}
+
+} // namespace icubench
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "bench.h"
+
+#include <string>
+#include <vector>
+
+namespace icubench {
+
+// Each suite registers its workloads with the runner. A suite skips the
+// workloads that the package under test cannot serve (missing data, trimmed
+// services, ...) instead of failing the whole run.
+void runCollationSuite(Runner& runner);
+void runSegmentationSuite(Runner& runner);
+void runNormalizationSuite(Runner& runner);
+void runConversionSuite(Runner& runner);
+void runTransliterationSuite(Runner& runner);
+void runCallsSuite(Runner& runner);
+void runStartupSuite(Runner& runner);
+void runAllocationSuite(Runner& runner);
+void runThreadsSuite(Runner& runner);
+void runSortSuite(Runner& runner);
+void runStreamingSuite(Runner& runner);
+void runPoolSuite(Runner& runner);
+void runIngestSuite(Runner& runner);
+void runFormattingSuite(Runner& runner);
+void runSearchSuite(Runner& runner);
+void runTokenizeSuite(Runner& runner);
+void runTranscodeSuite(Runner& runner);
+
+struct Suite {
+    const char* name;
+    const char* description;
+    void (*run)(Runner& runner);
+};
+
+// All suites in the order they run.
+const std::vector<Suite>& suites();
+
+// Child side of the startup suite: time the first call of one probe in this
+// fresh process and print it. Returns the process exit code.
+int runStartupProbe(const std::string& name);
+
+// Child side of the streaming suite: one pass of a workload over `path`.
+// Returns the process exit code.
+int runStreamingProbe(const std::string& name, const std::string& path);
+
+} // namespace icubench
@@ -0,0 +1,243 @@
+/*
+ * Thread scaling workloads: the ICU objects a service shares between threads.
+ *
+ * Every workload runs on each thread count of --threads (default 1, 2, 4, ...
+ * up to the number of cores). Shared objects are used the way ICU documents
+ * as thread-safe: const Collator::compare() on one instance, clones of one
+ * BreakIterator, one LocalizedNumberFormatter. The create workloads go
+ * through ICU's internal caches (UnifiedCache, the collation and converter
+ * caches, the alias table) on every call.
+ *
+ * Each result carries "speedup" (ops/s relative to the smallest thread
+ * count) and "efficiency" (speedup per thread). A workload whose efficiency
+ * drops below kContentionEfficiency on cores it does not have to share is
+ * flagged as a likely lock hotspot.
+ */
+
+#include "corpus.h"
+#include "suites.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unicode/brkiter.h>
+#include <unicode/coll.h>
+#include <unicode/locid.h>
+#include <unicode/numberformatter.h>
+#include <unicode/numfmt.h>
+#include <unicode/ucnv.h>
+#include <unicode/unistr.h>
+
+namespace icubench {
+
+namespace {
+
+// Below this speedup per thread a workload is reported as contended.
+constexpr double kContentionEfficiency = 0.5;
+
+// Items per latency sample of the batched workloads.
+constexpr size_t kBatch = 32;
+
+// Locales the create workloads cycle through, so the caches see several keys.
+const std::vector<icu::Locale>& cacheLocales() {
+    static const std::vector<icu::Locale> all = {
+        icu::Locale("en"), icu::Locale("de"), icu::Locale("fr"), icu::Locale("es"),
+        icu::Locale("ru"), icu::Locale("ar"), icu::Locale("ja"), icu::Locale("zh"),
+    };
+    return all;
+}
+
+std::vector<size_t> defaultThreadCounts() {
+    size_t cores = std::max<size_t>(2, std::thread::hardware_concurrency());
+    std::vector<size_t> counts;
+    for (size_t count = 1; count < cores; count *= 2) {
+        counts.push_back(count);
+    }
+    counts.push_back(cores);
+    return counts;
+}
+
+bool threadsSupported() {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    return false;
+#else
+    return true;
+#endif
+}
+
+// Run `op(thread, i)` on every thread count and attach the scaling metrics.
+template <typename Op>
+void runScaling(Runner& runner, const Workload& workload, Op&& op) {
+    std::vector<size_t> counts = runner.options().threadCounts;
+    if (counts.empty()) {
+        counts = defaultThreadCounts();
+    }
+
+    auto named = [&](size_t threads) {
+        Workload scaled = workload;
+        scaled.name += "/threads=" + std::to_string(threads);
+        return scaled;
+    };
+
+    // Size the runs so each thread works for about --min-time
+    bool anySelected = false;
+    for (size_t threads : counts) {
+        anySelected = anySelected || runner.selected(workload.suite, named(threads).name);
+    }
+    if (!anySelected) {
+        return;
+    }
+    size_t iterations = 1;
+    if (!runner.options().listOnly) {
+        keep(op(0, 0));
+        auto start = Clock::now();
+        size_t probes = 0;
+        while (probes < 10 || std::chrono::duration<double>(Clock::now() - start).count() < 0.02) {
+            keep(op(0, probes++));
+        }
+        double meanNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / probes;
+        iterations = std::clamp<size_t>(static_cast<size_t>(runner.options().minSeconds * 1e9 / meanNs), 10, 1000000);
+    }
+
+    std::vector<std::pair<size_t, Result*>> results;
+    for (size_t threads : counts) {
+        if (Result* result = runner.measureThreads(named(threads), threads, iterations, op)) {
+            results.emplace_back(threads, result);
+        }
+    }
+    if (results.empty()) {
+        return;
+    }
+
+    const auto& [baseThreads, base] = results.front();
+    const size_t cores = std::thread::hardware_concurrency();
+    std::ostringstream curve;
+    curve << std::fixed << std::setprecision(2);
+    const Result* flagged = nullptr;
+    for (const auto& [threads, result] : results) {
+        double speedup    = base->opsPerSecond() > 0 ? result->opsPerSecond() / base->opsPerSecond() : 0;
+        double efficiency = speedup * baseThreads / threads;
+        result->metrics["speedup"]    = speedup;
+        result->metrics["efficiency"] = efficiency;
+        curve << "  " << threads << "→" << speedup << "x";
+        if (threads > baseThreads && (cores == 0 || threads <= cores) && efficiency < kContentionEfficiency) {
+            flagged = result;
+        }
+    }
+    std::cout << "     scaling " << workload.suite << "/" << workload.name << ":" << curve.str() << std::endl;
+    if (flagged != nullptr) {
+        std::cout << "  ⚠️ " << flagged->workload.suite << "/" << flagged->workload.name << " runs at "
+                  << static_cast<int>(flagged->metrics.at("efficiency") * 100)
+                  << "% efficiency: likely lock contention inside ICU (profile it with perf, see README)" << std::endl;
+    }
+}
+
+} // namespace
+
+void runThreadsSuite(Runner& runner) {
+    if (!threadsSupported()) {
+        runner.skip({"threads", "*", "", ""}, "threads are not supported on this platform");
+        return;
+    }
+
+    const Corpus wordCorpus = words(20000 * runner.options().scale);
+    std::vector<icu::UnicodeString> wordList;
+    for (const auto& item : wordCorpus.items) {
+        wordList.push_back(icu::UnicodeString::fromUTF8(item));
+    }
+    const Corpus documents = multilingualDocuments(runner.options().scale);
+    std::vector<icu::UnicodeString> texts;
+    for (const auto& item : documents.items) {
+        texts.push_back(icu::UnicodeString::fromUTF8(item));
+    }
+    // Spread the threads over the corpus
+    auto unitOf = [](size_t thread, size_t i, size_t units) { return (thread * 7919 + i) % units; };
+
+    UErrorCode status = U_ZERO_ERROR;
+    std::unique_ptr<icu::Collator> collator(icu::Collator::createInstance(icu::Locale::getEnglish(), status));
+    if (U_SUCCESS(status)) {
+        const size_t units = wordList.size() / kBatch;
+        runScaling(runner, {"threads", "collation/compare-shared", wordCorpus.name, "32 pairs"}, [&](size_t thread, size_t i) {
+            size_t unit = unitOf(thread, i, units);
+            UErrorCode error = U_ZERO_ERROR;
+            int32_t order = 0;
+            for (size_t k = unit * kBatch; k < (unit + 1) * kBatch; ++k) {
+                order += collator->compare(wordList[k], wordList[(k + 1) % wordList.size()], error);
+            }
+            keep(order);
+            return Work{0, kBatch};
+        });
+    } else {
+        runner.skip({"threads", "collation/compare-shared", wordCorpus.name, ""}, u_errorName(status));
+    }
+
+    runScaling(runner, {"threads", "collation/createInstance", "", "create+destroy"}, [&](size_t thread, size_t i) {
+        UErrorCode error = U_ZERO_ERROR;
+        const auto& locales = cacheLocales();
+        delete icu::Collator::createInstance(locales[unitOf(thread, i, locales.size())], error);
+        return Work{};
+    });
+
+    status = U_ZERO_ERROR;
+    std::unique_ptr<icu::BreakIterator> words(icu::BreakIterator::createWordInstance(icu::Locale::getEnglish(), status));
+    if (U_SUCCESS(status)) {
+        runScaling(runner, {"threads", "segmentation/word-clone", documents.name, "document"}, [&](size_t thread, size_t i) {
+            size_t unit = unitOf(thread, i, texts.size());
+            std::unique_ptr<icu::BreakIterator> iterator(words->clone());
+            iterator->setText(texts[unit]);
+            uint64_t boundaries = 0;
+            while (iterator->next() != icu::BreakIterator::DONE) {
+                ++boundaries;
+            }
+            return Work{documents.items[unit].size(), boundaries};
+        });
+    } else {
+        runner.skip({"threads", "segmentation/word-clone", documents.name, ""}, u_errorName(status));
+    }
+
+    const icu::number::LocalizedNumberFormatter formatter =
+        icu::number::NumberFormatter::withLocale(icu::Locale::getGermany())
+            .precision(icu::number::Precision::fixedFraction(2));
+    runScaling(runner, {"threads", "number/format-shared", "", "32 numbers"}, [&](size_t thread, size_t i) {
+        UErrorCode error = U_ZERO_ERROR;
+        int32_t length = 0;
+        for (size_t k = 0; k < kBatch; ++k) {
+            double value = static_cast<double>((thread * 1000003 + i * kBatch + k) % 100000000) / 7.0;
+            length += formatter.formatDouble(value, error).toString(error).length();
+        }
+        keep(length);
+        return Work{0, kBatch};
+    });
+
+    runScaling(runner, {"threads", "number/NumberFormat::createInstance", "", "create+destroy"}, [&](size_t thread, size_t i) {
+        UErrorCode error = U_ZERO_ERROR;
+        const auto& locales = cacheLocales();
+        delete icu::NumberFormat::createInstance(locales[unitOf(thread, i, locales.size())], error);
+        return Work{};
+    });
+
+    const Corpus japanese = documentsFor("documents-ja", {"ja"}, runner.options().scale);
+    std::vector<icu::UnicodeString> japaneseTexts;
+    for (const auto& item : japanese.items) {
+        japaneseTexts.push_back(icu::UnicodeString::fromUTF8(item));
+    }
+    runScaling(runner, {"threads", "conversion/ucnv_open+fromUChars/Shift-JIS", japanese.name, "document"}, [&](size_t thread, size_t i) {
+        size_t unit = unitOf(thread, i, japaneseTexts.size());
+        const icu::UnicodeString& text = japaneseTexts[unit];
+        UErrorCode error = U_ZERO_ERROR;
+        UConverter* converter = ucnv_open("Shift-JIS", &error);
+        char buffer[16384];
+        int32_t length = ucnv_fromUChars(converter, buffer, sizeof(buffer), text.getBuffer(), text.length(), &error);
+        ucnv_close(converter);
+        keep(length);
+        return Work{japanese.items[unit].size(), 1};
+    });
+}
+
+} // namespace icubench
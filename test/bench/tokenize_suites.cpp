@@ -0,0 +1,194 @@
+/*
+ * Tokenize workloads: word, sentence and line segmentation of a multilingual
+ * corpus (the documents of multilingualDocuments(), one per line), the way
+ * test.cpp's break iterator example does it and with icuaddons::Segmenter.
+ *
+ *   unicodestring-loop  test.cpp's loop per document: UnicodeString,
+ *                       setText(), first()/next() and a UTF-8 string per token
+ *   utext-loop          one iterator over a UTF-8 UText of the whole corpus,
+ *                       boundary offsets into a vector
+ *   segmenter/threads=N icuaddons::Segmenter on N threads (64 KB shards),
+ *                       boundaries into a Segmentation
+ *
+ * The segmenter runs on each thread count of --threads (default 1, 2, 4, ...
+ * cores). Ops are tokens (segments); every result carries ns_per_token, the
+ * segmenter results their speedup and efficiency over 1 thread and the
+ * shard runs stolen (steals). Segmenter boundaries are checked against the
+ * single-threaded UText loop.
+ */
+
+#include "corpus.h"
+#include "suites.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <icuaddons/segmenter.h>
+
+#include <unicode/brkiter.h>
+#include <unicode/locid.h>
+#include <unicode/unistr.h>
+#include <unicode/utext.h>
+
+namespace icubench {
+
+namespace {
+
+// Documents per language of the corpus, times --scale (about 4 MB).
+constexpr size_t kDocumentScale = 64;
+
+constexpr size_t kShardBytes = 64 * 1024;
+
+struct Kind {
+    const char*          name;
+    icuaddons::BreakType type;
+};
+
+const Kind kKinds[] = {
+    {"word",     icuaddons::BreakType::Word},
+    {"sentence", icuaddons::BreakType::Sentence},
+    {"line",     icuaddons::BreakType::Line},
+};
+
+icu::BreakIterator* createIterator(icuaddons::BreakType type, UErrorCode& status) {
+    switch (type) {
+    case icuaddons::BreakType::Sentence: return icu::BreakIterator::createSentenceInstance(icu::Locale::getUS(), status);
+    case icuaddons::BreakType::Line:     return icu::BreakIterator::createLineInstance(icu::Locale::getUS(), status);
+    default:                             return icu::BreakIterator::createWordInstance(icu::Locale::getUS(), status);
+    }
+}
+
+std::vector<size_t> defaultThreadCounts() {
+    size_t cores = std::max<size_t>(2, std::thread::hardware_concurrency());
+    std::vector<size_t> counts;
+    for (size_t count = 1; count < cores; count *= 2) {
+        counts.push_back(count);
+    }
+    counts.push_back(cores);
+    return counts;
+}
+
+bool threadsSupported() {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    return false;
+#else
+    return true;
+#endif
+}
+
+void setNsPerToken(Result* result) {
+    if (result != nullptr && result->ops > 0) {
+        result->metrics["ns_per_token"] = result->seconds * 1e9 / static_cast<double>(result->ops);
+    }
+}
+
+} // namespace
+
+void runTokenizeSuite(Runner& runner) {
+    const Corpus corpus = multilingualDocuments(kDocumentScale * runner.options().scale);
+    std::string text;
+    for (const auto& document : corpus.items) {
+        text += document;
+        text += '\n';
+    }
+    std::vector<size_t> threadCounts = runner.options().threadCounts;
+    if (threadCounts.empty()) {
+        threadCounts = defaultThreadCounts();
+    }
+    if (!threadsSupported()) {
+        threadCounts = {1};
+    }
+    auto workload = [&](const std::string& name, const std::string& unit) {
+        return Workload{"tokenize", name, corpus.name, unit};
+    };
+
+    for (const auto& kind : kKinds) {
+        const std::string name = kind.name;
+        UErrorCode status = U_ZERO_ERROR;
+        std::unique_ptr<icu::BreakIterator> iterator(createIterator(kind.type, status));
+        icuaddons::Segmenter segmenter(kind.type, icu::Locale::getUS(), status);
+        if (U_FAILURE(status)) {
+            runner.skip(workload(name + "/segmenter", ""), u_errorName(status));
+            continue;
+        }
+
+        std::vector<std::string> tokens;
+        Result* result = runner.measure(workload(name + "/unicodestring-loop", "document"), corpus.items.size(), [&](size_t i) {
+            const icu::UnicodeString document = icu::UnicodeString::fromUTF8(corpus.items[i]);
+            iterator->setText(document);
+            tokens.clear();
+            int32_t start = iterator->first();
+            for (int32_t end = iterator->next(); end != icu::BreakIterator::DONE; start = end, end = iterator->next()) {
+                tokens.emplace_back();
+                document.tempSubString(start, end - start).toUTF8String(tokens.back());
+            }
+            return Work{corpus.items[i].size(), tokens.size()};
+        });
+        setNsPerToken(result);
+
+        std::vector<uint32_t> boundaries;
+        result = runner.measure(workload(name + "/utext-loop", "corpus"), 1, [&](size_t) {
+            UErrorCode error = U_ZERO_ERROR;
+            UText utf8 = UTEXT_INITIALIZER;
+            utext_openUTF8(&utf8, text.data(), static_cast<int64_t>(text.size()), &error);
+            iterator->setText(&utf8, error);
+            boundaries.clear();
+            for (int32_t end = iterator->next(); end != icu::BreakIterator::DONE; end = iterator->next()) {
+                boundaries.push_back(static_cast<uint32_t>(end));
+            }
+            utext_close(&utf8);
+            return Work{text.size(), boundaries.size()};
+        });
+        setNsPerToken(result);
+
+        icuaddons::SegmenterOptions options;
+        options.shardBytes = kShardBytes;
+        icuaddons::Segmentation segments;
+        std::vector<std::pair<size_t, Result*>> scaling;
+        for (size_t threads : threadCounts) {
+            options.threads = threads;
+            result = runner.measure(workload(name + "/segmenter/threads=" + std::to_string(threads), "corpus"), 1, [&](size_t) {
+                UErrorCode error = U_ZERO_ERROR;
+                segmenter.segment(text.data(), text.size(), options, segments, error);
+                return Work{text.size(), segments.size()};
+            });
+            if (result == nullptr) {
+                continue;
+            }
+            setNsPerToken(result);
+            result->metrics["steals"] = static_cast<double>(segments.steals);
+            scaling.emplace_back(threads, result);
+
+            bool same = !boundaries.empty() && segments.size() == boundaries.size();
+            for (size_t i = 0; same && i < segments.size(); ++i) {
+                same = segments.end(i) == boundaries[i];
+            }
+            if (!boundaries.empty() && !same) {
+                std::cerr << "❌ tokenize/" << name << "/segmenter/threads=" << threads << ": " << segments.size()
+                          << " segments differ from the " << boundaries.size() << " of the UText loop" << std::endl;
+            }
+        }
+
+        if (scaling.empty()) {
+            continue;
+        }
+        const auto& [baseThreads, base] = scaling.front();
+        std::ostringstream curve;
+        curve << std::fixed << std::setprecision(2);
+        for (const auto& [threads, scaled] : scaling) {
+            double speedup = base->opsPerSecond() > 0 ? scaled->opsPerSecond() / base->opsPerSecond() : 0;
+            scaled->metrics["speedup"]    = speedup;
+            scaled->metrics["efficiency"] = speedup * baseThreads / threads;
+            curve << "  " << threads << "→" << speedup << "x";
+        }
+        std::cout << "     scaling tokenize/" << name << "/segmenter:" << curve.str() << std::endl;
+    }
+}
+
+} // namespace icubench
@@ -0,0 +1,212 @@
+/*
+ * Transcode workloads: legacy charset feeds to UTF-8, record by record.
+ *
+ * A feed holds records like those of a log or message queue: ASCII framing
+ * (JSON keys, ids, a timestamp) around a paragraph of corpus.h in a language
+ * of the charset, encoded in Shift-JIS, GB18030, EUC-KR, windows-1251 or
+ * windows-1252. Each feed is converted to UTF-8 five ways:
+ *
+ *   open-per-record    ucnv_open() both charsets, ucnv_convertEx(), ucnv_close() per record
+ *   reused-converters  the same with two converters opened once
+ *   transcoder         one icuaddons::Transcoder (ASCII runs bypass the converters)
+ *   pooled-transcoder  an icuaddons::Transcoder per record, converters leased
+ *                      from a warm ServicePool
+ *   stream/4KB         the whole feed, one record per line, through
+ *                      Transcoder::transcodeChunk() in 4 KB pieces
+ *
+ * Throughput is input MB/s; ops are records. The transcoder results carry
+ * the share of input bytes copied as ASCII runs (ascii_pct). Every output is
+ * checked against open-per-record.
+ */
+
+#include "corpus.h"
+#include "suites.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <icuaddons/servicepool.h>
+#include <icuaddons/transcode.h>
+
+#include <unicode/ucnv.h>
+
+namespace icubench {
+
+namespace {
+
+// Documents per language; the records hold their paragraphs.
+constexpr size_t kDocumentScale = 16;
+
+constexpr size_t kChunkBytes = 4 * 1024;
+
+struct Feed {
+    std::vector<std::string> records;  // In the legacy charset
+    std::string              lines;    // The records, one per line
+};
+
+// UTF-8 records of the paragraphs of `languages`, each framed by ASCII
+// fields, converted to `charset`.
+Feed makeFeed(const char* charset, const std::vector<std::string>& languages, size_t scale, UErrorCode& status) {
+    Feed feed;
+    const Corpus documents = documentsFor(std::string("feed-") + charset, languages, kDocumentScale * scale);
+    for (const auto& document : documents.items) {
+        for (size_t begin = 0; begin < document.size();) {
+            size_t end = document.find("\n\n", begin);
+            end = end == std::string::npos ? document.size() : end;
+            const size_t id = feed.records.size();
+            const std::string record = "{\"id\":" + std::to_string(100000 + id) +
+                                       ",\"received\":\"2024-05-17T09:" + std::to_string(10 + id % 50) +
+                                       ":00Z\",\"source\":\"feed-" + charset + "\",\"text\":\"" +
+                                       document.substr(begin, end - begin) + "\"}";
+            std::string encoded(record.size() * 4 + 16, '\0');
+            const int32_t length = ucnv_convert(charset, "UTF-8", encoded.data(), static_cast<int32_t>(encoded.size()),
+                                                record.data(), static_cast<int32_t>(record.size()), &status);
+            if (U_FAILURE(status)) {
+                return feed;
+            }
+            encoded.resize(length);
+            feed.lines += encoded;
+            feed.lines += '\n';
+            feed.records.push_back(std::move(encoded));
+            begin = end + 2;
+        }
+    }
+    return feed;
+}
+
+} // namespace
+
+void runTranscodeSuite(Runner& runner) {
+    struct Charset {
+        const char*              name;
+        std::vector<std::string> languages;
+    };
+    const Charset charsets[] = {
+        {"Shift-JIS",    {"ja"}},
+        {"GB18030",      {"zh"}},
+        {"EUC-KR",       {"ko"}},
+        {"windows-1251", {"ru"}},
+        {"windows-1252", {"en", "fr", "de", "es"}},
+    };
+
+    icuaddons::ServicePool pool;
+    for (const auto& charset : charsets) {
+        const std::string name = charset.name;
+        UErrorCode status = U_ZERO_ERROR;
+        const Feed feed = makeFeed(charset.name, charset.languages, runner.options().scale, status);
+        if (U_FAILURE(status)) {
+            runner.skip({"transcode", name + "/*", "", ""}, u_errorName(status));
+            continue;
+        }
+        const size_t count = feed.records.size();
+        const std::string corpus = "feed-" + name;
+        auto workload = [&](const std::string& how, const std::string& unit = "record") {
+            return Workload{"transcode", name + "/" + how, corpus, unit};
+        };
+
+        std::vector<std::string> expected(count);
+        auto convertEx = [](UConverter* from, UConverter* to, const std::string& record, std::string& out) {
+            UErrorCode error = U_ZERO_ERROR;
+            UChar pivot[icuaddons::Transcoder::kPivotUnits];
+            UChar* pivotSource = pivot;
+            UChar* pivotTarget = pivot;
+            out.resize(record.size() * 3 + 16);
+            char* target = out.data();
+            const char* source = record.data();
+            ucnv_convertEx(to, from, &target, out.data() + out.size(), &source, record.data() + record.size(),
+                           pivot, &pivotSource, &pivotTarget, pivot + icuaddons::Transcoder::kPivotUnits,
+                           true, true, &error);
+            out.resize(static_cast<size_t>(target - out.data()));
+        };
+
+        Result* reference = runner.measure(workload("open-per-record"), count, [&](size_t i) {
+            UErrorCode error = U_ZERO_ERROR;
+            UConverter* from = ucnv_open(charset.name, &error);
+            UConverter* to   = ucnv_open("UTF-8", &error);
+            if (U_SUCCESS(error)) {
+                convertEx(from, to, feed.records[i], expected[i]);
+            }
+            ucnv_close(from);
+            ucnv_close(to);
+            return Work{feed.records[i].size(), 1};
+        });
+        if (reference == nullptr) {
+            continue;  // The outputs to check against were not made
+        }
+
+        UConverter* from = ucnv_open(charset.name, &status);
+        UConverter* to   = ucnv_open("UTF-8", &status);
+        std::string output;
+        if (U_SUCCESS(status)) {
+            runner.measure(workload("reused-converters"), count, [&](size_t i) {
+                convertEx(from, to, feed.records[i], output);
+                return Work{feed.records[i].size(), 1};
+            });
+        }
+        ucnv_close(from);
+        ucnv_close(to);
+
+        status = U_ZERO_ERROR;
+        icuaddons::Transcoder transcoder(charset.name, "UTF-8", status);
+        if (U_FAILURE(status)) {
+            runner.skip(workload("transcoder"), u_errorName(status));
+            continue;
+        }
+        Result* result = runner.measure(workload("transcoder"), count, [&](size_t i) {
+            UErrorCode error = U_ZERO_ERROR;
+            output.clear();
+            transcoder.transcode(feed.records[i].data(), feed.records[i].size(), output, error);
+            return Work{feed.records[i].size(), 1};
+        });
+        if (result != nullptr) {
+            const auto& counters = transcoder.counters();
+            const double total = static_cast<double>(counters.asciiBytes + counters.convertedBytes);
+            result->metrics["ascii_pct"] = total > 0 ? 100.0 * counters.asciiBytes / total : 0.0;
+            for (size_t i = 0; i < count; ++i) {
+                UErrorCode error = U_ZERO_ERROR;
+                output.clear();
+                transcoder.transcode(feed.records[i].data(), feed.records[i].size(), output, error);
+                if (output != expected[i]) {
+                    std::cerr << "❌ transcode/" << name << "/transcoder: record " << i
+                              << " differs from ucnv_convertEx" << std::endl;
+                    break;
+                }
+            }
+        }
+
+        runner.measure(workload("pooled-transcoder"), count, [&](size_t i) {
+            UErrorCode error = U_ZERO_ERROR;
+            icuaddons::Transcoder leased(charset.name, "UTF-8", error, &pool);
+            output.clear();
+            leased.transcode(feed.records[i].data(), feed.records[i].size(), output, error);
+            return Work{feed.records[i].size(), 1};
+        });
+
+        std::string streamed;
+        result = runner.measure(workload("stream/4KB", "feed"), 1, [&](size_t) {
+            UErrorCode error = U_ZERO_ERROR;
+            streamed.clear();
+            for (size_t begin = 0; begin < feed.lines.size(); begin += kChunkBytes) {
+                const size_t length = std::min(kChunkBytes, feed.lines.size() - begin);
+                transcoder.transcodeChunk(feed.lines.data() + begin, length, begin + length == feed.lines.size(),
+                                          streamed, error);
+            }
+            return Work{feed.lines.size(), count};
+        });
+        if (result != nullptr) {
+            std::string lines;
+            for (const auto& record : expected) {
+                lines += record;
+                lines += '\n';
+            }
+            if (streamed != lines) {
+                std::cerr << "❌ transcode/" << name << "/stream/4KB: the output differs from the records converted one by one"
+                          << std::endl;
+            }
+        }
+    }
+}
+
+} // namespace icubench
@@ -0,0 +1,150 @@
+#!/bin/bash
+#
+# Benchmark several packages against each other.
+#
+# Each package is extracted, the test programs are built against it (using the
+# shipped lib/cmake/icu/icu-link.cmake, so variant flags such as ThinLTO are
+# applied) and the selected benchmark suites are run. The table shows the time
+# per operation for every package and the speedup over the first one.
+#
+# Packages built for a higher x86-64 level than this host supports (see the
+# x86-64-vN variants) are skipped: they would stop with an illegal instruction.
+# WebAssembly packages (wasm-32, wasm-32-simd) are built with emcmake and run
+# headless under Node.
+#
+# Usage:
+#   test/compare-packages.sh BASELINE_ZIP ZIP...
+#
+# Environment:
+#   BENCH_SUITE      Suites to run, comma separated (default: calls)
+#   BENCH_MIN_TIME   Seconds per workload (default: 1)
+#
+# Needs clang, lld and python3; WebAssembly packages also need an activated
+# emsdk (emcmake on the PATH) and node.
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+ROOT_DIR="$(cd "$SCRIPT_DIR/.." && pwd)"
+
+if [[ -z "$ICU_VERSION" || -z "$CLANG_VERSION" ]]; then
+    source "$ROOT_DIR/versions.env"
+fi
+
+SUITE="${BENCH_SUITE:-calls}"
+MIN_TIME="${BENCH_MIN_TIME:-1}"
+
+if [[ $# -lt 2 ]]; then
+    echo "Usage: $0 BASELINE_ZIP ZIP..."
+    exit 2
+fi
+for ZIP in "$@"; do
+    if [[ ! -f "$ZIP" ]]; then
+        echo "❌ Package not found: $ZIP"
+        exit 1
+    fi
+done
+
+# Same levels as cmake/icu-select.cmake, from the kernel's CPU flags
+host_x86_64_level() {
+    local FLAGS
+    FLAGS=" $(grep -m1 '^flags' /proc/cpuinfo 2>/dev/null | cut -d: -f2) "
+    has_flags() {
+        local FLAG
+        for FLAG in "$@"; do
+            [[ "$FLAGS" == *" $FLAG "* ]] || return 1
+        done
+    }
+    if ! has_flags ssse3 sse4_1 sse4_2 popcnt; then
+        echo 1
+    elif ! has_flags avx avx2 bmi1 bmi2 fma; then
+        echo 2
+    elif ! has_flags avx512f avx512bw avx512cd avx512dq avx512vl; then
+        echo 3
+    else
+        echo 4
+    fi
+}
+HOST_LEVEL="$(host_x86_64_level)"
+echo "Host CPU: x86-64-v$HOST_LEVEL"
+echo ""
+
+WORK_DIR="$(mktemp -d)"
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+RESULTS=()
+run_package() {
+    local ZIP="$1"
+    local ICU_ROOT="$WORK_DIR/$(basename "$ZIP" .zip)"
+
+    echo "=== $(basename "$ZIP") ==="
+    # The zip holds the package root (bin/, include/, lib/, share/)
+    unzip -q "$ZIP" -d "$ICU_ROOT"
+
+    local NAME LEVEL
+    NAME="$(sed -n 's/^set(ICU_PACKAGE_TARGET *"\(.*\)")$/\1/p' "$ICU_ROOT/lib/cmake/icu/icu-package.cmake" 2>/dev/null || true)"
+    LEVEL="$(sed -n 's/^set(ICU_PACKAGE_X86_64_LEVEL *"\(.*\)")$/\1/p' "$ICU_ROOT/lib/cmake/icu/icu-package.cmake" 2>/dev/null || true)"
+    NAME="${NAME:-$(basename "$ZIP" .zip)}"
+    if [[ -n "$LEVEL" && "$LEVEL" -gt "$HOST_LEVEL" ]]; then
+        echo "⏭️  Skipped: needs an x86-64-v$LEVEL CPU"
+        echo ""
+        return
+    fi
+
+    local CONFIGURE=(env CC=clang CXX=clang++ cmake)
+    local RUN=("$ICU_ROOT-build/icu_benchmark")
+    if [[ "$NAME" == wasm-* ]]; then
+        CONFIGURE=(emcmake cmake)
+        RUN=(node "$ICU_ROOT-build/icu_benchmark.js")
+    fi
+    "${CONFIGURE[@]}" -S "$SCRIPT_DIR" -B "$ICU_ROOT-build" \
+        -DCMAKE_BUILD_TYPE=Release \
+        -DICU_ROOT="$ICU_ROOT" \
+        -DICU_DATA_DIR="$ICU_ROOT/share/icu/${ICU_VERSION}" > /dev/null
+    cmake --build "$ICU_ROOT-build" --target icu_benchmark -j"$(nproc)" > /dev/null
+
+    "${RUN[@]}" --suite "$SUITE" --min-time "$MIN_TIME" \
+        --label "$NAME" --json "$ICU_ROOT.json"
+    RESULTS+=("$ICU_ROOT.json")
+    echo ""
+}
+
+for ZIP in "$@"; do
+    run_package "$ZIP"
+done
+
+if [[ ${#RESULTS[@]} -lt 2 ]]; then
+    echo "❌ Fewer than two packages could be run on this host"
+    exit 1
+fi
+
+python3 - "${RESULTS[@]}" <<'PYEOF'
+import json
+import sys
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    return data["label"], {(r["suite"], r["workload"]): r for r in data["results"]}
+
+def ns_per_op(r):
+    return r["seconds"] * 1e9 / r["ops"] if r["ops"] else float("nan")
+
+runs = [load(path) for path in sys.argv[1:]]
+(base_label, base), others = runs[0], runs[1:]
+
+print("ns/op per package, speedup over " + base_label)
+header = f"{'workload':<40} {base_label:>16}"
+for label, _ in others:
+    header += f" {label:>24} {'':>8}"
+print(header)
+for key, base_result in base.items():
+    before = ns_per_op(base_result)
+    line = f"{key[0] + '/' + key[1]:<40} {before:>16.2f}"
+    for _, results in others:
+        if key in results:
+            after = ns_per_op(results[key])
+            line += f" {after:>24.2f} {before / after:>7.2f}x"
+        else:
+            line += f" {'-':>24} {'':>8}"
+    print(line)
+PYEOF
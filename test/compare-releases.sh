@@ -0,0 +1,199 @@
+#!/bin/bash
+#
+# Check a new package release for performance regressions against the last one.
+#
+# Both packages are extracted and the same benchmark (this checkout's test
+# programs) is built against each; test/CMakeLists.txt finds the libraries
+# and addons of each package, but only knows the ICU version of this checkout,
+# so the data file is looked up here in the package's share/icu/<version>/
+# and passed as ICU_DATA_DIR; ICU_DATA is unset for the builds and the runs
+# so that neither picks another one up. The two builds are then run in
+# turns, BENCH_TRIALS times each and pinned to the
+# same CPUs, alternating which one goes first (A B, B A, A B, ...) so that
+# drift in clock speed, temperature or background load hits both alike.
+#
+# For every workload the table shows the median ns/op of each package, the
+# change of the candidate and its 95% confidence interval, computed from the
+# per-trial ratios (trial i of the candidate over trial i of the baseline,
+# Student's t on their logarithms). A workload regressed when the whole
+# interval lies above zero and the change exceeds BENCH_THRESHOLD percent;
+# the script then exits with 1, so it can gate a release.
+#
+# Usage:
+#   test/compare-releases.sh BASELINE_ZIP CANDIDATE_ZIP
+#
+# Environment:
+#   BENCH_SUITE      Suites to run, comma separated
+#                    (default: calls,conversion,normalization,collation,segmentation)
+#   BENCH_MIN_TIME   Seconds per workload and trial (default: 0.5)
+#   BENCH_TRIALS     Runs of each package (default: 5, at least 2)
+#   BENCH_THRESHOLD  Slowdown in percent that fails the comparison (default: 5)
+#   BENCH_CPUS       CPU list to pin both runs to, as for taskset -c
+#                    (default: the last CPU; empty to not pin)
+#
+# Needs clang, lld and python3; pinning needs taskset (util-linux). Run it on
+# an otherwise idle machine: the interval only accounts for the noise it sees.
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+
+SUITE="${BENCH_SUITE:-calls,conversion,normalization,collation,segmentation}"
+MIN_TIME="${BENCH_MIN_TIME:-0.5}"
+TRIALS="${BENCH_TRIALS:-5}"
+THRESHOLD="${BENCH_THRESHOLD:-5}"
+CPUS="${BENCH_CPUS-$(($(nproc --all) - 1))}"
+
+if [[ $# -ne 2 ]]; then
+    echo "Usage: $0 BASELINE_ZIP CANDIDATE_ZIP"
+    exit 2
+fi
+for ZIP in "$@"; do
+    if [[ ! -f "$ZIP" ]]; then
+        echo "❌ Package not found: $ZIP"
+        exit 1
+    fi
+done
+if [[ ! "$TRIALS" =~ ^[0-9]+$ || "$TRIALS" -lt 2 ]]; then
+    echo "❌ BENCH_TRIALS must be at least 2 to estimate the noise"
+    exit 2
+fi
+
+PIN=()
+if [[ -n "$CPUS" ]]; then
+    if command -v taskset > /dev/null; then
+        PIN=(taskset -c "$CPUS")
+        echo "Pinned to CPU $CPUS"
+    else
+        echo "⚠️  taskset not found; the runs are not pinned"
+    fi
+fi
+echo ""
+
+WORK_DIR="$(mktemp -d)"
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+# Extract and build one package; sets LABELS[$2] and BENCHMARKS[$2]
+LABELS=()
+BENCHMARKS=()
+build_package() {
+    local ZIP="$1" SIDE="$2"
+    local ICU_ROOT="$WORK_DIR/$SIDE"
+
+    echo "=== $([[ $SIDE == 0 ]] && echo baseline || echo candidate): $(basename "$ZIP") ==="
+    # The zip holds the package root (bin/, include/, lib/, share/)
+    unzip -q "$ZIP" -d "$ICU_ROOT"
+
+    local NAME
+    NAME="$(sed -n 's/^set(ICU_PACKAGE_TARGET *"\(.*\)")$/\1/p' "$ICU_ROOT/lib/cmake/icu/icu-package.cmake" 2>/dev/null || true)"
+    if [[ "$NAME" == wasm-* ]]; then
+        echo "❌ WebAssembly packages are not supported here; use compare-wasm.sh"
+        exit 1
+    fi
+
+    # The data file of this package's ICU version, if it has one (the
+    # static-data variant builds the data into the library)
+    local DATA_FILE DATA_DIR=()
+    DATA_FILE="$(find "$ICU_ROOT/share/icu" -name 'icudt*l.dat' 2>/dev/null | sort | tail -n 1)"
+    if [[ -n "$DATA_FILE" ]]; then
+        DATA_DIR=(-DICU_DATA_DIR="$(dirname "$DATA_FILE")")
+        echo "Data: ${DATA_FILE#"$ICU_ROOT/"}"
+    fi
+
+    env -u ICU_DATA CC=clang CXX=clang++ cmake -S "$SCRIPT_DIR" -B "$ICU_ROOT-build" \
+        -DCMAKE_BUILD_TYPE=Release \
+        -DICU_ROOT="$ICU_ROOT" "${DATA_DIR[@]}" > /dev/null
+    cmake --build "$ICU_ROOT-build" --target icu_benchmark -j"$(nproc)" > /dev/null
+
+    LABELS[$SIDE]="$(basename "$ZIP" .zip)"
+    BENCHMARKS[$SIDE]="$ICU_ROOT-build/icu_benchmark"
+    echo ""
+}
+
+build_package "$1" 0
+build_package "$2" 1
+
+run_trial() {
+    local SIDE="$1" TRIAL="$2"
+    echo "--- trial $TRIAL/$TRIALS: ${LABELS[$SIDE]}"
+    env -u ICU_DATA "${PIN[@]}" "${BENCHMARKS[$SIDE]}" --suite "$SUITE" --min-time "$MIN_TIME" \
+        --label "${LABELS[$SIDE]}" --json "$WORK_DIR/$SIDE-$TRIAL.json" > "$WORK_DIR/$SIDE-$TRIAL.log" \
+        || { cat "$WORK_DIR/$SIDE-$TRIAL.log"; echo "❌ ${LABELS[$SIDE]} failed in trial $TRIAL"; exit 1; }
+    # Failed correctness checks would make the timings meaningless
+    if grep -q "❌" "$WORK_DIR/$SIDE-$TRIAL.log"; then
+        grep "❌" "$WORK_DIR/$SIDE-$TRIAL.log"
+        echo "❌ ${LABELS[$SIDE]} failed a check in trial $TRIAL"
+        exit 1
+    fi
+}
+
+for TRIAL in $(seq 1 "$TRIALS"); do
+    FIRST=$(( (TRIAL + 1) % 2 ))
+    run_trial "$FIRST" "$TRIAL"
+    run_trial "$(( 1 - FIRST ))" "$TRIAL"
+done
+echo ""
+
+python3 - "$WORK_DIR" "$TRIALS" "$THRESHOLD" <<'PYEOF'
+import json
+import math
+import statistics
+import sys
+
+work_dir, trials, threshold = sys.argv[1], int(sys.argv[2]), float(sys.argv[3])
+
+# Two-sided 95% quantiles of Student's t by degrees of freedom
+T95 = {1: 12.706, 2: 4.303, 3: 3.182, 4: 2.776, 5: 2.571, 6: 2.447, 7: 2.365, 8: 2.306,
+       9: 2.262, 10: 2.228, 12: 2.179, 15: 2.131, 20: 2.086, 30: 2.042, 60: 2.000}
+
+def t95(df):
+    return T95[max(k for k in T95 if k <= df)] if df < 120 else 1.960
+
+def load(side, trial):
+    with open(f"{work_dir}/{side}-{trial}.json") as f:
+        data = json.load(f)
+    return data["label"], {(r["suite"], r["workload"]): r for r in data["results"]}
+
+def ns_per_op(r):
+    return r["seconds"] * 1e9 / r["ops"] if r["ops"] else float("nan")
+
+runs = [[load(side, trial) for trial in range(1, trials + 1)] for side in (0, 1)]
+base_label, cand_label = runs[0][0][0], runs[1][0][0]
+
+print(f"{base_label} -> {cand_label}: ns/op (median of {trials} trials), change and 95% confidence interval")
+print(f"{'workload':<48} {'baseline':>12} {'candidate':>12} {'change':>9} {'95% CI':>19}")
+regressions, improvements, missing = [], [], []
+for key in runs[0][0][1]:
+    pairs = []
+    for trial in range(trials):
+        before, after = runs[0][trial][1].get(key), runs[1][trial][1].get(key)
+        if before and after and ns_per_op(before) > 0 and ns_per_op(after) > 0:
+            pairs.append((ns_per_op(before), ns_per_op(after)))
+    name = key[0] + "/" + key[1]
+    if len(pairs) < 2:
+        missing.append(name)
+        continue
+
+    logs = [math.log(after / before) for before, after in pairs]
+    mean = statistics.fmean(logs)
+    margin = t95(len(logs) - 1) * statistics.stdev(logs) / math.sqrt(len(logs))
+    change, low, high = (100 * (math.exp(x) - 1) for x in (mean, mean - margin, mean + margin))
+
+    verdict = ""
+    if low > 0 and change > threshold:
+        verdict = "❌ slower"
+        regressions.append(name)
+    elif high < 0 and -change > threshold:
+        verdict = "✅ faster"
+        improvements.append(name)
+    print(f"{name:<48} {statistics.median(b for b, _ in pairs):>12.2f} {statistics.median(a for _, a in pairs):>12.2f}"
+          f" {change:>+8.1f}% [{low:>+7.1f}%, {high:>+7.1f}%] {verdict}")
+
+print("")
+for name in missing:
+    print(f"⚠️  {name}: not measured by both packages")
+print(f"{len(improvements)} faster and {len(regressions)} slower by more than {threshold:g}%")
+if regressions:
+    print("❌ Significant regressions: " + ", ".join(regressions))
+    sys.exit(1)
+print("✅ No significant regression")
+PYEOF
@@ -0,0 +1,90 @@
+#!/bin/bash
+#
+# Compare the code size and instruction-cache footprint of icu_test linked
+# against several packages (e.g. linux-x86-64 and the size, size-text variants).
+#
+# Each package is extracted and icu_test is built against it with the shipped
+# lib/cmake/icu/icu-link.cmake, so the variant's link options (--gc-sections)
+# apply. The table shows the executable as linked and stripped, its .text and
+# .rodata, and, when perf can count hardware events, the instructions and the
+# L1 instruction-cache and iTLB misses of one icu_test run.
+#
+# Usage:
+#   test/compare-sizes.sh ZIP...
+#
+# Needs clang, lld, llvm-size and llvm-strip; perf is optional.
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+ROOT_DIR="$(cd "$SCRIPT_DIR/.." && pwd)"
+
+if [[ -z "$ICU_VERSION" || -z "$CLANG_VERSION" ]]; then
+    source "$ROOT_DIR/versions.env"
+fi
+
+if [[ $# -lt 1 ]]; then
+    echo "Usage: $0 ZIP..."
+    exit 2
+fi
+for ZIP in "$@"; do
+    if [[ ! -f "$ZIP" ]]; then
+        echo "❌ Package not found: $ZIP"
+        exit 1
+    fi
+done
+
+HAS_PERF=false
+if command -v perf > /dev/null && perf stat -e instructions true > /dev/null 2>&1; then
+    HAS_PERF=true
+else
+    echo "⚠️  perf cannot count hardware events here: no instruction-cache columns"
+fi
+
+WORK_DIR="$(mktemp -d)"
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+# Size of one section of an executable (llvm-size -A), 0 if it has none
+section_size() {
+    llvm-size -A "$1" | awk -v section="$2" '$1 == section { print $2; found = 1 } END { if (!found) print 0 }'
+}
+
+# Count of one perf event in perf stat -x, output, "-" if not counted
+perf_count() {
+    awk -F, -v event="$2" 'index($3, event) == 1 && $1 ~ /^[0-9]+$/ { print $1; found = 1 } END { if (!found) print "-" }' "$1"
+}
+
+printf "%-32s %12s %12s %12s %12s %14s %12s %12s\n" \
+    package linked stripped .text .rodata instructions icache-miss itlb-miss
+for ZIP in "$@"; do
+    ICU_ROOT="$WORK_DIR/$(basename "$ZIP" .zip)"
+    unzip -q "$ZIP" -d "$ICU_ROOT"
+
+    NAME="$(sed -n 's/^set(ICU_PACKAGE_TARGET *"\(.*\)")$/\1/p' "$ICU_ROOT/lib/cmake/icu/icu-package.cmake" 2>/dev/null || true)"
+    NAME="${NAME:-$(basename "$ZIP" .zip)}"
+
+    CC=clang CXX=clang++ cmake -S "$SCRIPT_DIR" -B "$ICU_ROOT-build" \
+        -DCMAKE_BUILD_TYPE=Release \
+        -DENABLE_ICU_BENCHMARK=OFF \
+        -DICU_ROOT="$ICU_ROOT" \
+        -DICU_DATA_DIR="$ICU_ROOT/share/icu/${ICU_VERSION}" > /dev/null
+    cmake --build "$ICU_ROOT-build" --target icu_test -j"$(nproc)" > /dev/null
+
+    EXE="$ICU_ROOT-build/icu_test"
+    llvm-strip -o "$EXE.stripped" "$EXE"
+
+    INSTRUCTIONS="-" ICACHE_MISSES="-" ITLB_MISSES="-"
+    if [[ "$HAS_PERF" == true ]]; then
+        perf stat -x, -o "$ICU_ROOT.perf" -e instructions,L1-icache-load-misses,iTLB-load-misses \
+            "$EXE" "$ICU_ROOT" "$ICU_ROOT/share/icu/${ICU_VERSION}" > /dev/null
+        INSTRUCTIONS="$(perf_count "$ICU_ROOT.perf" instructions)"
+        ICACHE_MISSES="$(perf_count "$ICU_ROOT.perf" L1-icache-load-misses)"
+        ITLB_MISSES="$(perf_count "$ICU_ROOT.perf" iTLB-load-misses)"
+    fi
+
+    printf "%-32s %12s %12s %12s %12s %14s %12s %12s\n" "$NAME" \
+        "$(stat -c %s "$EXE")" "$(stat -c %s "$EXE.stripped")" \
+        "$(section_size "$EXE" .text)" "$(section_size "$EXE" .rodata)" \
+        "$INSTRUCTIONS" "$ICACHE_MISSES" "$ITLB_MISSES"
+done
+echo ""
+echo "Sizes in bytes; events for one icu_test run (size-text packages skip the examples they compile out)."
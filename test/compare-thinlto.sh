@@ -0,0 +1,34 @@
+#!/bin/bash
+#
+# Compare the regular linux-x86-64 package with the ThinLTO variant.
+#
+# The test programs are built against each package (the shipped
+# lib/cmake/icu/icu-link.cmake adds -flto=thin and lld for the ThinLTO
+# package) and the "calls" benchmark suite is run. The table shows the time
+# per call and the speedup of the ThinLTO build (see compare-packages.sh).
+#
+# Usage:
+#   test/compare-thinlto.sh [REGULAR_ZIP] [THINLTO_ZIP]
+#
+# Defaults to the packages build.sh leaves in dist/. Needs clang, lld and python3.
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+ROOT_DIR="$(cd "$SCRIPT_DIR/.." && pwd)"
+
+if [[ -z "$ICU_VERSION" || -z "$CLANG_VERSION" ]]; then
+    source "$ROOT_DIR/versions.env"
+fi
+
+REGULAR_ZIP="${1:-$ROOT_DIR/dist/icu4c-${ICU_VERSION}_linux-x86-64_clang-${CLANG_VERSION}.zip}"
+THINLTO_ZIP="${2:-$ROOT_DIR/dist/icu4c-${ICU_VERSION}_linux-x86-64-thinlto_clang-${CLANG_VERSION}.zip}"
+
+for ZIP in "$REGULAR_ZIP" "$THINLTO_ZIP"; do
+    if [[ ! -f "$ZIP" ]]; then
+        echo "❌ Package not found: $ZIP"
+        echo "   Build it with: ./build.sh --linux-64 --variant=thinlto"
+        exit 1
+    fi
+done
+
+BENCH_SUITE="${BENCH_SUITE:-calls}" exec "$SCRIPT_DIR/compare-packages.sh" "$REGULAR_ZIP" "$THINLTO_ZIP"
@@ -0,0 +1,43 @@
+#!/bin/bash
+#
+# Compare the scalar wasm-32 package with the wasm-32-simd variant (WASM SIMD,
+# pthreads, data linked in) under Node.
+#
+# Builds icu_benchmark against both packages in dist/ with emcmake, runs the
+# segmentation, conversion, normalization and collation suites headless in Node
+# and prints ns/op with the speedup of the SIMD build (see compare-packages.sh).
+# BENCH_SUITE=threads also shows how the SIMD build scales on Web Workers.
+#
+# Usage:
+#   test/compare-wasm.sh [DIST_DIR]
+#
+# Needs an activated emsdk (source emsdk_env.sh), node and python3.
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+ROOT_DIR="$(cd "$SCRIPT_DIR/.." && pwd)"
+
+if [[ -z "$ICU_VERSION" || -z "$CLANG_VERSION" || -z "$ENSDK_VERSION" ]]; then
+    source "$ROOT_DIR/versions.env"
+fi
+
+DIST_DIR="${1:-$ROOT_DIR/dist}"
+
+if ! command -v emcmake > /dev/null || ! command -v node > /dev/null; then
+    echo "❌ emcmake and node are required (source emsdk/emsdk_env.sh)"
+    exit 1
+fi
+
+ZIPS=()
+for TARGET in wasm-32 wasm-32-simd; do
+    ZIP="$DIST_DIR/icu4c-${ICU_VERSION}_${TARGET}_clang-${CLANG_VERSION}_emsdk-${ENSDK_VERSION}.zip"
+    if [[ ! -f "$ZIP" ]]; then
+        echo "❌ Package not found: $ZIP"
+        echo "   Build it with: ./build.sh --wasm-32 --variant=wasm-simd"
+        exit 1
+    fi
+    ZIPS+=("$ZIP")
+done
+
+BENCH_SUITE="${BENCH_SUITE:-segmentation,conversion,normalization,collation}" \
+    exec "$SCRIPT_DIR/compare-packages.sh" "${ZIPS[@]}"
@@ -0,0 +1,39 @@
+#!/bin/bash
+#
+# Compare the generic linux-x86-64 package with the x86-64-v2/v3/v4 variants.
+#
+# Runs the suites whose inner loops benefit from wider vector instructions
+# (UTF conversion, normalization, collation) against every level package in
+# dist/ that this host can execute, and prints ns/op with the speedup over the
+# generic build (see compare-packages.sh). Run it on a machine of the fleet
+# you deploy to; levels above the host's are skipped.
+#
+# Usage:
+#   test/compare-x86-64-levels.sh [DIST_DIR]
+#
+# Needs clang, lld and python3.
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+ROOT_DIR="$(cd "$SCRIPT_DIR/.." && pwd)"
+
+if [[ -z "$ICU_VERSION" || -z "$CLANG_VERSION" ]]; then
+    source "$ROOT_DIR/versions.env"
+fi
+
+DIST_DIR="${1:-$ROOT_DIR/dist}"
+
+ZIPS=()
+for TARGET in linux-x86-64 linux-x86-64-v2 linux-x86-64-v3 linux-x86-64-v4; do
+    ZIP="$DIST_DIR/icu4c-${ICU_VERSION}_${TARGET}_clang-${CLANG_VERSION}.zip"
+    if [[ -f "$ZIP" ]]; then
+        ZIPS+=("$ZIP")
+    elif [[ "$TARGET" == linux-x86-64 ]]; then
+        echo "❌ Package not found: $ZIP"
+        echo "   Build it with: ./build.sh --linux-64 --variant=x86-64-v2,x86-64-v3,x86-64-v4"
+        exit 1
+    fi
+done
+
+BENCH_SUITE="${BENCH_SUITE:-conversion,normalization,collation,calls}" \
+    exec "$SCRIPT_DIR/compare-packages.sh" "${ZIPS[@]}"
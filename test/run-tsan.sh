@@ -0,0 +1,65 @@
+#!/bin/bash
+#
+# Run the thread-safety stress test and the threads benchmark suite under
+# ThreadSanitizer.
+#
+# The tsan package variant (./build.sh --linux-64 --variant=tsan) is built
+# with -fsanitize=thread and ships that flag in lib/cmake/icu/icu-package.cmake,
+# so the test programs built against it are instrumented as well. icu_test
+# runs with ICU_STRESS_THREADS set: it shares a Collator, clones of one
+# BreakIterator and a LocalizedNumberFormatter between the threads and churns
+# the service caches. Any data race stops the run (halt_on_error=1).
+#
+# Usage:
+#   test/run-tsan.sh [ZIP]
+#
+# Environment:
+#   ICU_STRESS_THREADS     Threads of the stress test (default: 8)
+#   ICU_STRESS_ITERATIONS  Rounds per thread (default: 200)
+#   BENCH_MIN_TIME         Seconds per benchmark workload (default: 0.2)
+#
+# Needs clang.
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+ROOT_DIR="$(cd "$SCRIPT_DIR/.." && pwd)"
+
+if [[ -z "$ICU_VERSION" || -z "$CLANG_VERSION" ]]; then
+    source "$ROOT_DIR/versions.env"
+fi
+
+ZIP="${1:-$ROOT_DIR/dist/icu4c-${ICU_VERSION}_linux-x86-64-tsan_clang-${CLANG_VERSION}.zip}"
+if [[ ! -f "$ZIP" ]]; then
+    echo "❌ Package not found: $ZIP"
+    echo "   Build it with: ./build.sh --linux-64 --variant=tsan"
+    exit 1
+fi
+
+WORK_DIR="$(mktemp -d)"
+trap 'rm -rf "$WORK_DIR"' EXIT
+ICU_ROOT="$WORK_DIR/icu"
+
+# The zip holds the package root (bin/, include/, lib/, share/)
+unzip -q "$ZIP" -d "$ICU_ROOT"
+if ! grep -q 'fsanitize=thread' "$ICU_ROOT/lib/cmake/icu/icu-package.cmake" 2>/dev/null; then
+    echo "⚠️  $(basename "$ZIP") is not a tsan package: only ICU calls made by the test code are checked"
+fi
+
+CC=clang CXX=clang++ cmake -S "$SCRIPT_DIR" -B "$WORK_DIR/build" \
+    -DCMAKE_BUILD_TYPE=RelWithDebInfo \
+    -DICU_ROOT="$ICU_ROOT" \
+    -DICU_DATA_DIR="$ICU_ROOT/share/icu/${ICU_VERSION}" > /dev/null
+cmake --build "$WORK_DIR/build" -j"$(nproc)" > /dev/null
+
+export TSAN_OPTIONS="${TSAN_OPTIONS:-halt_on_error=1 second_deadlock_stack=1}"
+
+echo "=== Thread-safety stress test ==="
+ICU_STRESS_THREADS="${ICU_STRESS_THREADS:-8}" \
+    "$WORK_DIR/build/icu_test" "$ICU_ROOT" "$ICU_ROOT/share/icu/${ICU_VERSION}"
+
+echo ""
+echo "=== Threads benchmark suite (timings are distorted by the instrumentation) ==="
+"$WORK_DIR/build/icu_benchmark" --suite threads --min-time "${BENCH_MIN_TIME:-0.2}"
+
+echo ""
+echo "✅ No data races reported"
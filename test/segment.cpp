@@ -0,0 +1,219 @@
+/*
+ * ICU4C segmentation driver
+ *
+ * Segments a UTF-8 file with icuaddons::Segmenter on several threads and
+ * reports the segments found, the throughput and the cost per token. With
+ * --compare it also runs a single BreakIterator over the whole file, as the
+ * break iterator example of test.cpp does, and checks that both find the same
+ * boundaries. With --print it writes one "begin<TAB>end<TAB>status" line per
+ * segment (byte offsets, rule status / 100).
+ *
+ * Usage:
+ *   icu_segment [--type word|sentence|line|character] [--locale ID]
+ *               [--threads N] [--shard-kb N] [--compare] [--print] FILE
+ *
+ * The ICU data directory is taken from ICU_DATA, or from the ICU_DATA_DIR
+ * found by CMake at build time.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <icuaddons/segmenter.h>
+#include <icuaddons/utf8stream.h>
+
+#include <unicode/brkiter.h>
+#include <unicode/locid.h>
+#include <unicode/putil.h>
+#include <unicode/utext.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    icuaddons::BreakType type      = icuaddons::BreakType::Word;
+    std::string          locale    = "en";
+    size_t               threads   = std::max(1u, std::thread::hardware_concurrency());
+    size_t               shardKb   = 1024;
+    bool                 compare   = false;
+    bool                 print     = false;
+    std::string          file;
+};
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options] FILE\n\n"
+              << "Options:\n"
+              << "  --type NAME     word, sentence, line or character (default: word)\n"
+              << "  --locale ID     Locale of the break rules (default: en)\n"
+              << "  --threads N     Segmenting threads (default: cores)\n"
+              << "  --shard-kb N    Target shard size in kB (default: 1024)\n"
+              << "  --compare       Also run one BreakIterator over the file and compare\n"
+              << "  --print         Write the segments, one \"begin end status\" line each\n"
+              << "  --help          Show this help message\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                std::cerr << "❌ Missing value for " << arg << std::endl;
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--type") {
+            const std::string type = value();
+            if (type == "word") {
+                options.type = icuaddons::BreakType::Word;
+            } else if (type == "sentence") {
+                options.type = icuaddons::BreakType::Sentence;
+            } else if (type == "line") {
+                options.type = icuaddons::BreakType::Line;
+            } else if (type == "character") {
+                options.type = icuaddons::BreakType::Character;
+            } else {
+                std::cerr << "❌ Unknown segment type: " << type << std::endl;
+                return false;
+            }
+        } else if (arg == "--locale") {
+            options.locale = value();
+        } else if (arg == "--threads") {
+            options.threads = static_cast<size_t>(std::max(1, std::atoi(value().c_str())));
+        } else if (arg == "--shard-kb") {
+            options.shardKb = static_cast<size_t>(std::max(1, std::atoi(value().c_str())));
+        } else if (arg == "--compare") {
+            options.compare = true;
+        } else if (arg == "--print") {
+            options.print = true;
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            std::exit(0);
+        } else if (!arg.empty() && arg[0] != '-' && options.file.empty()) {
+            options.file = arg;
+        } else {
+            std::cerr << "❌ Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+    if (options.file.empty()) {
+        printUsage(argv[0]);
+        return false;
+    }
+    return true;
+}
+
+icu::BreakIterator* createIterator(icuaddons::BreakType type, const icu::Locale& locale, UErrorCode& status) {
+    switch (type) {
+    case icuaddons::BreakType::Character: return icu::BreakIterator::createCharacterInstance(locale, status);
+    case icuaddons::BreakType::Sentence:  return icu::BreakIterator::createSentenceInstance(locale, status);
+    case icuaddons::BreakType::Line:      return icu::BreakIterator::createLineInstance(locale, status);
+    case icuaddons::BreakType::Word:      break;
+    }
+    return icu::BreakIterator::createWordInstance(locale, status);
+}
+
+double seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void report(const char* what, size_t segments, size_t bytes, double elapsed) {
+    std::cerr << what << ": " << segments << " segments in " << elapsed * 1e3 << " ms, "
+              << bytes / elapsed / 1e6 << " MB/s, " << elapsed * 1e9 / std::max<size_t>(1, segments) << " ns/token"
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 2;
+    }
+
+    // Point ICU at the packaged data unless ICU_DATA already does.
+#ifdef ICU_DATA_DIR
+    const char* envDataDir = std::getenv("ICU_DATA");
+    if (envDataDir == nullptr || strlen(envDataDir) == 0) {
+        u_setDataDirectory(ICU_DATA_DIR);
+    }
+#endif
+
+    UErrorCode status = U_ZERO_ERROR;
+    icuaddons::MappedFile file(options.file, status);
+    if (U_FAILURE(status)) {
+        std::cerr << "❌ Cannot read " << options.file << ": " << u_errorName(status) << std::endl;
+        return 1;
+    }
+    const icu::Locale locale(options.locale.c_str());
+    icuaddons::Segmenter segmenter(options.type, locale, status);
+    if (U_FAILURE(status)) {
+        std::cerr << "❌ Cannot create the break iterator: " << u_errorName(status) << std::endl;
+        return 1;
+    }
+
+    icuaddons::SegmenterOptions segmenterOptions;
+    segmenterOptions.threads    = options.threads;
+    segmenterOptions.shardBytes = options.shardKb * 1024;
+    segmenterOptions.ruleStatus = options.print;
+    icuaddons::Segmentation segments;
+    auto start = Clock::now();
+    segmenter.segment(file.data(), file.size(), segmenterOptions, segments, status);
+    const double elapsed = seconds(start);
+    if (U_FAILURE(status)) {
+        std::cerr << "❌ Segmentation failed: " << u_errorName(status) << std::endl;
+        return 1;
+    }
+    report(("Segmenter on " + std::to_string(options.threads) + " threads").c_str(), segments.size(), file.size(), elapsed);
+    std::cerr << "  " << segments.shardOffsets.size() << " shards, " << segments.steals << " runs stolen" << std::endl;
+
+    int exitCode = 0;
+    if (options.compare) {
+        if (file.size() > icuaddons::kMaxWindowBytes) {
+            std::cerr << "⚠️ The file is larger than one BreakIterator can take; not compared" << std::endl;
+        } else {
+            std::unique_ptr<icu::BreakIterator> iterator(createIterator(options.type, locale, status));
+            start = Clock::now();
+            std::vector<uint32_t> boundaries;
+            UText utf8 = UTEXT_INITIALIZER;
+            utext_openUTF8(&utf8, file.data(), static_cast<int64_t>(file.size()), &status);
+            iterator->setText(&utf8, status);
+            for (int32_t end = iterator->next(); U_SUCCESS(status) && end != icu::BreakIterator::DONE; end = iterator->next()) {
+                boundaries.push_back(static_cast<uint32_t>(end));
+            }
+            utext_close(&utf8);
+            const double single = seconds(start);
+            report("BreakIterator on 1 thread", boundaries.size(), file.size(), single);
+            std::cerr << "  speedup " << single / elapsed << "x" << std::endl;
+
+            size_t mismatch = 0;
+            while (mismatch < std::min(boundaries.size(), segments.size()) && boundaries[mismatch] == segments.end(mismatch)) {
+                ++mismatch;
+            }
+            if (U_FAILURE(status) || boundaries.size() != segments.size() || mismatch != boundaries.size()) {
+                std::cerr << "❌ The boundaries differ from segment " << mismatch
+                          << " (shards cut without a newline split segments)" << std::endl;
+                exitCode = 1;
+            } else {
+                std::cerr << "✅ Same boundaries" << std::endl;
+            }
+        }
+    }
+
+    if (options.print) {
+        for (size_t i = 0; i < segments.size(); ++i) {
+            std::cout << segments.begin(i) << '\t' << segments.end(i) << '\t' << static_cast<int>(segments.statuses[i]) << '\n';
+        }
+    }
+    return exitCode;
+}
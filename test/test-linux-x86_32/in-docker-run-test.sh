@@ -13,6 +13,14 @@ echo "ZIP file: "$(find /app -iname "icu4c*_linux-*-${BITNESS}_*.zip")
 unzip -q $(find /app -iname "icu4c*_linux-*-${BITNESS}_*.zip")
 echo "Extraction complete."
 
+# Replace the data file with a data profile package (build.sh --data-profile=NAME)
+if [ -f "/app/data-profile.zip" ]; then
+    echo "Applying data profile package..."
+    unzip -o -q /app/data-profile.zip -d /app/icu
+    export ICU_DATA_PROFILE=$(cat /app/icu/share/icu/${ICU_VERSION}/data-profile)
+    echo "Data profile: $ICU_DATA_PROFILE"
+fi
+
 # Set up ICU data path - ensure the data file is properly located
 if [ -f "/app/icu/share/icu/${ICU_VERSION}/icudt*l.dat" ]; then
     echo "Found ICU data file in share/icu/${ICU_VERSION}/"
@@ -78,6 +86,10 @@ if [ -f "$DATA_FILE" ]; then
     echo "Verifying ICU data file access:"
     ls -la /app/icu_data/
     
+    cd /app/icu
+elif grep -qs 'ICU_PACKAGE_DATA_PACKAGING *"static"' /app/icu/lib/cmake/icu/icu-package.cmake; then
+    # static-data packages link the data into libicudata.a, so there is no file to point ICU_DATA at
+    echo "ICU data is linked into libicudata.a (static data packaging)"
     cd /app/icu
 else
     echo "ERROR: ICU data file not found at $DATA_FILE"
@@ -149,4 +161,11 @@ fi
 echo "Using ICU_DATA=$ICU_DATA"
 ./icu_test
 
+# Run the benchmark when requested; results land in the mounted /app/results directory
+if [[ "${RUN_BENCHMARK:-false}" == "true" && -x ./icu_benchmark ]]; then
+    echo -e "\nRunning ICU benchmark:\n"
+    PACKAGE_NAME=${PACKAGE_NAME:-$(basename "$(find /app -iname "icu4c*_linux-*-${BITNESS}_*.zip")" .zip)}
+    ./icu_benchmark --label "$PACKAGE_NAME" --json "/app/results/${PACKAGE_NAME}.json"
+fi
+
 echo -e "\nTest completed successfully!"
@@ -55,6 +55,7 @@ echo -e "\n${YELLOW}=== Running ICU4C tests ===${NC}"
 # Ensure shared test files are available
 SHARED_TEST_CPP="$SCRIPT_DIR/../test.cpp"
 SHARED_CMAKE="$SCRIPT_DIR/../CMakeLists.txt"
+SHARED_BENCH="$SCRIPT_DIR/../bench"
 
 if [[ ! -f "$SHARED_TEST_CPP" ]]; then
     echo -e "${YELLOW}Error: Shared test.cpp not found at $SHARED_TEST_CPP${NC}"
@@ -68,12 +69,33 @@ fi
 
 VOLUMES=\
 
+# DATA_PROFILE=NAME tests the package with the data of dist/icu4c-<version>_data-NAME.zip
+DATA_PROFILE_ARGS=()
+if [[ -n "$DATA_PROFILE" ]]; then
+    DATA_PROFILE_PACKAGE="$ROOT_DIR/dist/icu4c-${ICU_VERSION}_data-${DATA_PROFILE}.zip"
+    if [[ ! -f "$DATA_PROFILE_PACKAGE" ]]; then
+        echo -e "${YELLOW}Error: Data profile package not found: $DATA_PROFILE_PACKAGE${NC}"
+        echo -e "Build it with: ./build.sh --data-profile=$DATA_PROFILE"
+        exit 1
+    fi
+    DATA_PROFILE_ARGS=(-v "$DATA_PROFILE_PACKAGE:/app/data-profile.zip:ro")
+fi
+
+# Benchmark results (RUN_BENCHMARK=true) are written next to the packages
+BENCHMARK_DIR="$ROOT_DIR/dist/benchmark"
+mkdir -p "$BENCHMARK_DIR"
+
 # Run the container with all necessary volumes
 echo -e "\n${YELLOW}=== Running ICU4C tests ===${NC}"
 docker run --rm \
+    -e RUN_BENCHMARK="${RUN_BENCHMARK:-false}" \
+    -e ICU_ALLOCATOR -e ICU_COUNT_ALLOCATIONS -e ICU_STRESS_THREADS -e ICU_STRESS_ITERATIONS -e ICU_TRACE \
     -v "$ICU_PACKAGE:/app/icu4c-${ICU_VERSION}_linux-x86-${BITNESS}_clang-${CLANG_VERSION}.zip:ro" \
     -v "$SHARED_TEST_CPP:/app/test.cpp:ro"                                                         \
     -v "$SHARED_CMAKE:/app/CMakeLists.txt.common:ro"                                               \
+    -v "$SHARED_BENCH:/app/bench:ro"                                                               \
+    -v "$BENCHMARK_DIR:/app/results"                                                               \
+    "${DATA_PROFILE_ARGS[@]}"                                                                      \
     icu4c-test-linux-x86_$BITNESS
 
 echo -e "\n${GREEN}✅ Tests completed successfully!${NC}"
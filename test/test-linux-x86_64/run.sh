@@ -20,8 +20,9 @@ if [[ -z "$ICU_VERSION" || -z "$CLANG_VERSION" ]]; then
     echo -e "Using versions from versions.env: ICU=${GREEN}$ICU_VERSION${NC}, Clang=${GREEN}$CLANG_VERSION${NC}"
 fi
 
-# Check if the ICU package exists
-ICU_PACKAGE="$ROOT_DIR/dist/icu4c-${ICU_VERSION}_linux-x86-${BITNESS}_clang-${CLANG_VERSION}.zip"
+# Check if the ICU package exists (PACKAGE_VARIANT=static-data, pgo, ... tests a package variant)
+PACKAGE_TARGET="linux-x86-${BITNESS}${PACKAGE_VARIANT:+-$PACKAGE_VARIANT}"
+ICU_PACKAGE="$ROOT_DIR/dist/icu4c-${ICU_VERSION}_${PACKAGE_TARGET}_clang-${CLANG_VERSION}.zip"
 if [[ ! -f "$ICU_PACKAGE" ]]; then
     echo -e "\n${YELLOW}ICU package not found: $ICU_PACKAGE${NC}"
     echo -e "Building ICU package first..."
@@ -29,7 +30,7 @@ if [[ ! -f "$ICU_PACKAGE" ]]; then
     # Check if we should do a quick build
     if [[ "$(uname -s)" == "Linux" ]]; then
         echo -e "Running build with LINUX_${BITNESS}=true..."
-        (cd "$ROOT_DIR" && export LINUX_${BITNESS}=true && ./build.sh)
+        (cd "$ROOT_DIR" && export LINUX_${BITNESS}=true && ./build.sh ${PACKAGE_VARIANT:+--variant=$PACKAGE_VARIANT})
     fi
     
     # Check again if the package exists
@@ -55,6 +56,7 @@ echo -e "\n${YELLOW}=== Running ICU4C tests ===${NC}"
 # Ensure shared test files are available
 SHARED_TEST_CPP="$SCRIPT_DIR/../test.cpp"
 SHARED_CMAKE="$SCRIPT_DIR/../CMakeLists.txt"
+SHARED_BENCH="$SCRIPT_DIR/../bench"
 
 if [[ ! -f "$SHARED_TEST_CPP" ]]; then
     echo -e "${YELLOW}Error: Shared test.cpp not found at $SHARED_TEST_CPP${NC}"
@@ -66,12 +68,34 @@ if [[ ! -f "$SHARED_CMAKE" ]]; then
     exit 1
 fi
 
+# DATA_PROFILE=NAME tests the package with the data of dist/icu4c-<version>_data-NAME.zip
+DATA_PROFILE_ARGS=()
+if [[ -n "$DATA_PROFILE" ]]; then
+    DATA_PROFILE_PACKAGE="$ROOT_DIR/dist/icu4c-${ICU_VERSION}_data-${DATA_PROFILE}.zip"
+    if [[ ! -f "$DATA_PROFILE_PACKAGE" ]]; then
+        echo -e "${YELLOW}Error: Data profile package not found: $DATA_PROFILE_PACKAGE${NC}"
+        echo -e "Build it with: ./build.sh --data-profile=$DATA_PROFILE"
+        exit 1
+    fi
+    DATA_PROFILE_ARGS=(-v "$DATA_PROFILE_PACKAGE:/app/data-profile.zip:ro")
+fi
+
+# Benchmark results (RUN_BENCHMARK=true) are written next to the packages
+BENCHMARK_DIR="$ROOT_DIR/dist/benchmark"
+mkdir -p "$BENCHMARK_DIR"
+
 # Run the container with all necessary volumes
 echo -e "\n${YELLOW}=== Running ICU4C tests ===${NC}"
 docker run --rm \
+    -e RUN_BENCHMARK="${RUN_BENCHMARK:-false}" \
+    -e ICU_ALLOCATOR -e ICU_COUNT_ALLOCATIONS -e ICU_STRESS_THREADS -e ICU_STRESS_ITERATIONS -e ICU_TRACE \
+    -e PACKAGE_NAME="$(basename "$ICU_PACKAGE" .zip)" \
     -v "$ICU_PACKAGE:/app/icu4c-${ICU_VERSION}_linux-x86-${BITNESS}_clang-${CLANG_VERSION}.zip:ro" \
     -v "$SHARED_TEST_CPP:/app/test.cpp:ro"                                                         \
     -v "$SHARED_CMAKE:/app/CMakeLists.txt.common:ro"                                               \
+    -v "$SHARED_BENCH:/app/bench:ro"                                                               \
+    -v "$BENCHMARK_DIR:/app/results"                                                               \
+    "${DATA_PROFILE_ARGS[@]}"                                                                      \
     icu4c-test-linux-x86_$BITNESS
 
 echo -e "\n${GREEN}✅ Tests completed successfully!${NC}"
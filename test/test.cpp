@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -6,23 +7,40 @@
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <map>
+#include <set>
+#include <iomanip>
+#include <type_traits>
+#include <atomic>
+#include <thread>
+#include <random>
 
 /*
  * ICU4C Cross-Platform Test
  * 
  * This test verifies the ICU4C package across different platforms including WebAssembly.
  * 
- * WebAssembly (WASM) Limitations:
- * - Limited file system access in the sandboxed environment
- * - The following ICU features have limited or no support in WASM:
- *   1. Break Iterator (sentence/word boundary analysis) - Missing resource data
- *   2. Transliteration - Missing transliteration rules
- *   3. Collation - Limited locale data
- *   4. Calendar data - Limited calendar support
- *   5. Converter data - Limited charset conversion support
- * 
- * When running in WASM environment, tests for these features will be skipped
- * with appropriate messages indicating the limitation.
+ * WebAssembly (WASM):
+ * - Break iteration, transliteration, collation, calendars and converters
+ *   all need the ICU data. The wasm-32/wasm-64 packages ship it as
+ *   icudt*.dat, which a WASM program only sees through a file system: the
+ *   CMake build links with -sNODERAWFS=1 so Node reads it from the host
+ *   (browsers need --preload-file or u_setCommonData()). The wasm-32-simd
+ *   variant links the data into libicudata.a and needs no file at all.
+ *
+ * Allocations:
+ * - ICU_COUNT_ALLOCATIONS=1 counts the allocations and bytes ICU requests for
+ *   each API call the examples make and prints a summary at the end.
+ * - ICU_ALLOCATOR=pool runs everything on the pooling allocator of the
+ *   icuaddons library (see icuaddons/memory.h); "system" is the default.
+ *
+ * Thread-safety stress:
+ * - ICU_STRESS_THREADS=N hammers shared ICU objects (one Collator, clones of
+ *   one BreakIterator, one LocalizedNumberFormatter) and the service caches
+ *   (createInstance, ucnv_open) from N threads and checks every result
+ *   against a single-threaded reference. ICU_STRESS_ITERATIONS sets the
+ *   rounds per thread (default 200). Run it on the tsan package variant
+ *   (test/run-tsan.sh) to have ThreadSanitizer report data races.
  */
 
 // For ICU functionality
@@ -45,6 +63,22 @@
 #include <unicode/ures.h>
 #include <unicode/coll.h>
 #include <unicode/resbund.h>
+#include <unicode/normalizer2.h>
+#include <unicode/numberformatter.h>
+
+// Addons shipped with the package (libicuaddons.a): allocation hooks, bulk sort keys, service pool, trace hooks
+#include <icuaddons/formatting.h>
+#include <icuaddons/lazydata.h>
+#include <icuaddons/memory.h>
+#include <icuaddons/normalize.h>
+#include <icuaddons/search.h>
+#include <icuaddons/segmenter.h>
+#include <icuaddons/sortkeys.h>
+#include <icuaddons/servicepool.h>
+#include <icuaddons/trace.h>
+#include <icuaddons/transcode.h>
+#include <icuaddons/utf8stream.h>
+#include <icuaddons/warmup.h>
 
 // Platform-specific path separators and extensions
 #ifdef _WIN32
@@ -68,6 +102,14 @@ private:
     bool all_requirements_met = true;
     std::string icu_root;
     std::string icu_data_dir;
+    std::string data_profile;   // Data profile under test (ICU_DATA_PROFILE), empty for the full data set
+    std::string executable_path;  // This program, run again for the checks that need a fresh process
+    bool count_allocations = false;  // ICU_COUNT_ALLOCATIONS: report allocations per ICU API call
+    std::vector<std::pair<std::string, icuaddons::AllocationCounters>> allocation_report;
+    
+    // Text of the segmentation addon checks: accents, an apostrophe, a number and Greek
+    static constexpr const char* kSegmentationSample =
+        "Größe matters: naïve café-goers can't wait 3.5 hours. Ελληνικά κείμενα!";
     
     // Construct platform-specific path
     std::string buildPath(const std::vector<std::string>& components) {
@@ -132,6 +174,110 @@ public:
         if (envDataDir != nullptr && strlen(envDataDir) > 0) {
             icu_data_dir = envDataDir;
         }
+        
+        // Slim data packages built with build.sh --data-profile=NAME
+        const char* envProfile = std::getenv("ICU_DATA_PROFILE");
+        if (envProfile != nullptr && strlen(envProfile) > 0 && std::string(envProfile) != "full") {
+            data_profile = envProfile;
+        }
+        
+        count_allocations = allocationCountingRequested();
+    }
+    
+    // Path of this program (argv[0])
+    void setExecutablePath(const std::string& path) {
+        executable_path = path;
+    }
+    
+    // Whether ICU_COUNT_ALLOCATIONS asks for allocation counts (main() installs the counting hooks)
+    static bool allocationCountingRequested() {
+        const char* envCount = std::getenv("ICU_COUNT_ALLOCATIONS");
+        return envCount != nullptr && strlen(envCount) > 0 && std::string(envCount) != "0";
+    }
+    
+    // Run one ICU API call; in allocation counting mode also record what ICU allocated for it
+    template <typename Call>
+    auto track(const std::string& api, Call&& call) -> decltype(call()) {
+        icuaddons::AllocationScope scope;
+        auto record = [&] {
+            if (count_allocations) {
+                allocation_report.emplace_back(api, scope.counters());
+            }
+        };
+        if constexpr (std::is_void_v<decltype(call())>) {
+            call();
+            record();
+        } else {
+            auto result = call();
+            record();
+            return result;
+        }
+    }
+    
+    // Whether ICU_TRACE asks for the time spent in ICU's traced functions (main() installs the trace hooks)
+    static bool tracingRequested() {
+        const char* envTrace = std::getenv("ICU_TRACE");
+        return envTrace != nullptr && strlen(envTrace) > 0 && std::string(envTrace) != "0";
+    }
+    
+    // Print the statistics collected by the trace hooks
+    static void printTraceReport() {
+        if (!tracingRequested()) {
+            return;
+        }
+        std::cout << "\n=== ICU Traced Functions ===" << std::endl;
+        if (!icuaddons::tracingAvailable()) {
+            std::cout << "ICU was built without tracing: use the profiling package (build.sh --variant=profiling)" << std::endl;
+            return;
+        }
+        std::cout << std::left << std::setw(40) << "function"
+                  << std::right << std::setw(8) << "calls" << std::setw(14) << "total µs" << std::setw(12) << "max µs" << std::endl;
+        for (const auto& entry : icuaddons::traceStatistics()) {
+            std::cout << std::left << std::setw(40) << (entry.name != nullptr ? entry.name : "?")
+                      << std::right << std::setw(8) << entry.calls << std::setw(14) << entry.totalNs / 1000
+                      << std::setw(12) << entry.maxNs / 1000 << std::endl;
+        }
+    }
+    
+    // Print the allocations recorded by track()
+    void printAllocationReport() const {
+        if (!count_allocations) {
+            return;
+        }
+        std::cout << "\n=== ICU Allocations per API Call ===" << std::endl;
+        std::cout << std::left << std::setw(52) << "API call"
+                  << std::right << std::setw(8) << "allocs" << std::setw(8) << "frees" << std::setw(12) << "bytes" << std::endl;
+        for (const auto& [api, counters] : allocation_report) {
+            std::cout << std::left << std::setw(52) << api
+                      << std::right << std::setw(8) << counters.allocations + counters.reallocations
+                      << std::setw(8) << counters.frees << std::setw(12) << counters.bytes << std::endl;
+        }
+    }
+    
+    // Whether an addon check is skipped because the data profile does not
+    // promise the feature its service needs
+    bool addonSkippedByProfile(const std::string& feature) const {
+        if (profileIncludes(feature)) {
+            return false;
+        }
+        std::cout << "   ⏭️ Skipped: needs " << feature << ", which is not part of the " << data_profile << " data profile" << std::endl;
+        return true;
+    }
+    
+    // Whether a specific data profile (not the full data set) is being tested
+    bool hasDataProfile() const {
+        return !data_profile.empty();
+    }
+    
+    // Whether the data under test promises a feature. The profiles mirror the
+    // filters in data-filters/; the full data set serves everything.
+    bool profileIncludes(const std::string& feature) const {
+        static const std::map<std::string, std::set<std::string>> profiles = {
+            {"minimal-normalization", {"properties", "normalization"}},
+            {"western-locales",       {"properties", "normalization", "collation", "resources", "break-iteration", "western-locales"}},
+        };
+        auto profile = profiles.find(data_profile);
+        return profile == profiles.end() || profile->second.count(feature) > 0;
     }
     
     // Test if the ICU package is properly installed
@@ -274,11 +420,14 @@ public:
         std::cout << "French Locale: " << fr.getName() << " (" << toString(fr.getDisplayName(frName)) << ")" << std::endl;
         std::cout << "Japanese Locale: " << jp.getName() << " (" << toString(jp.getDisplayName(jpName)) << ")" << std::endl;
         
+#if UCONFIG_NO_FORMATTING
+        std::cout << "Currency formatting: skipped, formatting is compiled out of this ICU build" << std::endl;
+#else
         // Number formatting
         UErrorCode status = U_ZERO_ERROR;
-        std::unique_ptr<icu::NumberFormat> nf_us(icu::NumberFormat::createCurrencyInstance(us, status));
-        std::unique_ptr<icu::NumberFormat> nf_fr(icu::NumberFormat::createCurrencyInstance(fr, status));
-        std::unique_ptr<icu::NumberFormat> nf_jp(icu::NumberFormat::createCurrencyInstance(jp, status));
+        std::unique_ptr<icu::NumberFormat> nf_us(track("NumberFormat::createCurrencyInstance(en_US)", [&] { return icu::NumberFormat::createCurrencyInstance(us, status); }));
+        std::unique_ptr<icu::NumberFormat> nf_fr(track("NumberFormat::createCurrencyInstance(fr_FR)", [&] { return icu::NumberFormat::createCurrencyInstance(fr, status); }));
+        std::unique_ptr<icu::NumberFormat> nf_jp(track("NumberFormat::createCurrencyInstance(ja_JP)", [&] { return icu::NumberFormat::createCurrencyInstance(jp, status); }));
         
         double amount = 1234567.89;
         icu::UnicodeString result_us, result_fr, result_jp;
@@ -293,6 +442,7 @@ public:
             std::cout << "  France: " << toString(result_fr) << std::endl;
             std::cout << "  Japan: " << toString(result_jp) << std::endl;
         }
+#endif
     }
     
     // Example 3: Text boundary analysis
@@ -312,9 +462,9 @@ public:
         icu::UnicodeString text("Hello, world! This is a test. How are you? 你好，世界！这是一个测试。");
         
         // Create a sentence break iterator
-        std::unique_ptr<icu::BreakIterator> sentenceIterator(
-            icu::BreakIterator::createSentenceInstance(icu::Locale::getUS(), status)
-        );
+        std::unique_ptr<icu::BreakIterator> sentenceIterator(track("BreakIterator::createSentenceInstance", [&] {
+            return icu::BreakIterator::createSentenceInstance(icu::Locale::getUS(), status);
+        }));
         
         if (U_FAILURE(status)) {
             std::cout << "Error creating sentence iterator: " << u_errorName(status) << std::endl;
@@ -338,9 +488,9 @@ public:
         
         // Create a word break iterator
         status = U_ZERO_ERROR;
-        std::unique_ptr<icu::BreakIterator> wordIterator(
-            icu::BreakIterator::createWordInstance(icu::Locale::getUS(), status)
-        );
+        std::unique_ptr<icu::BreakIterator> wordIterator(track("BreakIterator::createWordInstance", [&] {
+            return icu::BreakIterator::createWordInstance(icu::Locale::getUS(), status);
+        }));
         
         if (U_FAILURE(status)) {
             std::cout << "Error creating word iterator: " << u_errorName(status) << std::endl;
@@ -368,6 +518,9 @@ public:
     // Example 4: Transliteration
     void runTransliterationExample() {
         std::cout << "\n=== Running Transliteration Example ===" << std::endl;
+#if UCONFIG_NO_TRANSLITERATION
+        std::cout << "Skipped: transliteration is compiled out of this ICU build" << std::endl;
+#else
         
         // Helper function to convert UnicodeString to std::string for output
         auto toString = [](const icu::UnicodeString& ustr) -> std::string {
@@ -379,9 +532,9 @@ public:
         UErrorCode status = U_ZERO_ERROR;
         
         // Create a transliterator for Latin to Cyrillic
-        std::unique_ptr<icu::Transliterator> latinToCyrillic(
-            icu::Transliterator::createInstance("Latin-Cyrillic", UTRANS_FORWARD, status)
-        );
+        std::unique_ptr<icu::Transliterator> latinToCyrillic(track("Transliterator::createInstance(Latin-Cyrillic)", [&] {
+            return icu::Transliterator::createInstance("Latin-Cyrillic", UTRANS_FORWARD, status);
+        }));
         
         if (U_FAILURE(status)) {
             std::cout << "Error creating transliterator: " << u_errorName(status) << std::endl;
@@ -392,30 +545,30 @@ public:
         icu::UnicodeString latinText("Privet, mir! Kak dela?");
         std::cout << "Original text: " << toString(latinText) << std::endl;
         
-        latinToCyrillic->transliterate(latinText);
+        track("Transliterator::transliterate(Latin-Cyrillic)", [&] { latinToCyrillic->transliterate(latinText); });
         std::cout << "Transliterated to Cyrillic: " << toString(latinText) << std::endl;
         
         // Create a transliterator for Cyrillic to Latin
         status = U_ZERO_ERROR;
-        std::unique_ptr<icu::Transliterator> cyrillicToLatin(
-            icu::Transliterator::createInstance("Cyrillic-Latin", UTRANS_FORWARD, status)
-        );
+        std::unique_ptr<icu::Transliterator> cyrillicToLatin(track("Transliterator::createInstance(Cyrillic-Latin)", [&] {
+            return icu::Transliterator::createInstance("Cyrillic-Latin", UTRANS_FORWARD, status);
+        }));
         
         if (U_FAILURE(status)) {
             std::cout << "Error creating reverse transliterator: " << u_errorName(status) << std::endl;
             return;
         }
         
-        cyrillicToLatin->transliterate(latinText);
+        track("Transliterator::transliterate(Cyrillic-Latin)", [&] { cyrillicToLatin->transliterate(latinText); });
         std::cout << "Transliterated back to Latin: " << toString(latinText) << std::endl;
+#endif
     }
     
     // Example 5: ICU Data Bundle Verification
-    void testICUDataBundle() {
+    // Returns false if any check failed (checks for features the data
+    // profile does not promise are skipped).
+    bool testICUDataBundle() {
         std::cout << "\n=== ICU Data Bundle Verification ===" << std::endl;
-#ifdef WASM_ENVIRONMENT
-        std::cout << "Note: Some tests will be skipped due to WASM limitations" << std::endl;
-#endif
         
         // Helper function to convert UnicodeString to std::string for output
         auto toString = [](const icu::UnicodeString& ustr) -> std::string {
@@ -427,6 +580,23 @@ public:
         bool allTestsPassed = true;
         UErrorCode status = U_ZERO_ERROR;
         
+        if (hasDataProfile()) {
+            std::cout << "Data profile: " << data_profile << std::endl;
+        }
+        
+        // Checks for features the data profile does not promise are skipped
+        auto skippedByProfile = [&](const std::string& feature) {
+            if (profileIncludes(feature)) {
+                return false;
+            }
+            std::cout << "   ⏭️ Skipped: " << feature << " is not part of the " << data_profile << " data profile" << std::endl;
+            return true;
+        };
+        // Services a size-optimized package compiles out (UCONFIG_NO_*) have nothing to test
+        [[maybe_unused]] auto skippedByBuild = [](const std::string& service) {
+            std::cout << "   ⏭️ Skipped: " << service << " is compiled out of this ICU build" << std::endl;
+        };
+        
         // Check for modular data files if ICU data directory is set
         if (!icu_data_dir.empty()) {
             std::cout << "Checking for modular ICU data files in: " << icu_data_dir << std::endl;
@@ -488,90 +658,169 @@ public:
         
         // Test 2: Check if we can access collation data (requires coll.dat)
         std::cout << "2. Testing collation data..." << std::endl;
-        // Note: This test may have limited functionality in WebAssembly environments
-        status = U_ZERO_ERROR;
-        std::unique_ptr<icu::Collator> coll(icu::Collator::createInstance(icu::Locale::getUS(), status));
-        if (U_SUCCESS(status)) {
-            std::cout << "   ✅ Collation data accessible" << std::endl;
+        if (!skippedByProfile("collation")) {
+            // Note: This test may have limited functionality in WebAssembly environments
+            status = U_ZERO_ERROR;
+            std::unique_ptr<icu::Collator> coll(track("Collator::createInstance(en_US)", [&] {
+                return icu::Collator::createInstance(icu::Locale::getUS(), status);
+            }));
+            if (U_SUCCESS(status)) {
+                std::cout << "   ✅ Collation data accessible" << std::endl;
             
-            // Test basic collation functionality
-            icu::UnicodeString str1("apple");
-            icu::UnicodeString str2("banana");
-            icu::Collator::EComparisonResult result = coll->compare(str1, str2);
+                // Test basic collation functionality
+                icu::UnicodeString str1("apple");
+                icu::UnicodeString str2("banana");
+                icu::Collator::EComparisonResult result = coll->compare(str1, str2);
             
-            if (result == icu::Collator::LESS) {
-                std::cout << "   ✅ Collation comparison works correctly" << std::endl;
+                if (result == icu::Collator::LESS) {
+                    std::cout << "   ✅ Collation comparison works correctly" << std::endl;
+                } else {
+                    std::cout << "   ❌ Collation comparison failed" << std::endl;
+                    allTestsPassed = false;
+                }
             } else {
-                std::cout << "   ❌ Collation comparison failed" << std::endl;
+                std::cout << "   ❌ Failed to access collation data: " << u_errorName(status) << std::endl;
                 allTestsPassed = false;
             }
-        } else {
-            std::cout << "   ❌ Failed to access collation data: " << u_errorName(status) << std::endl;
-            allTestsPassed = false;
         }
         
         // Test 3: Check if we can access calendar data (requires ucal.dat)
         std::cout << "3. Testing calendar data..." << std::endl;
-        // Note: This test may have limited functionality in WebAssembly environments
-        status = U_ZERO_ERROR;
-        std::unique_ptr<icu::Calendar> cal(icu::Calendar::createInstance(icu::Locale("ja_JP@calendar=japanese"), status));
-        if (U_SUCCESS(status)) {
-            std::cout << "   ✅ Calendar data accessible" << std::endl;
+#if UCONFIG_NO_FORMATTING
+        skippedByBuild("formatting");
+#else
+        if (!skippedByProfile("calendars")) {
+            // Note: This test may have limited functionality in WebAssembly environments
+            status = U_ZERO_ERROR;
+            std::unique_ptr<icu::Calendar> cal(icu::Calendar::createInstance(icu::Locale("ja_JP@calendar=japanese"), status));
+            if (U_SUCCESS(status)) {
+                std::cout << "   ✅ Calendar data accessible" << std::endl;
             
-            // Test basic calendar functionality
-            int32_t year = cal->get(UCAL_YEAR, status);
-            int32_t month = cal->get(UCAL_MONTH, status) + 1; // 0-based to 1-based
-            int32_t day = cal->get(UCAL_DATE, status);
-            int32_t era = cal->get(UCAL_ERA, status);
+                // Test basic calendar functionality
+                int32_t year = cal->get(UCAL_YEAR, status);
+                int32_t month = cal->get(UCAL_MONTH, status) + 1; // 0-based to 1-based
+                int32_t day = cal->get(UCAL_DATE, status);
+                int32_t era = cal->get(UCAL_ERA, status);
             
-            if (U_SUCCESS(status)) {
-                std::cout << "   ✅ Japanese calendar date: Era " << era << ", Year " << year 
-                          << ", Month " << month << ", Day " << day << std::endl;
+                if (U_SUCCESS(status)) {
+                    std::cout << "   ✅ Japanese calendar date: Era " << era << ", Year " << year 
+                              << ", Month " << month << ", Day " << day << std::endl;
+                } else {
+                    std::cout << "   ❌ Failed to get calendar fields: " << u_errorName(status) << std::endl;
+                    allTestsPassed = false;
+                }
             } else {
-                std::cout << "   ❌ Failed to get calendar fields: " << u_errorName(status) << std::endl;
+                std::cout << "   ❌ Failed to create Japanese calendar: " << u_errorName(status) << std::endl;
                 allTestsPassed = false;
             }
-        } else {
-            std::cout << "   ❌ Failed to create Japanese calendar: " << u_errorName(status) << std::endl;
-            allTestsPassed = false;
         }
+#endif
         
         // Test 4: Check if we can access resource bundle data (requires res files)
         std::cout << "4. Testing resource bundle data..." << std::endl;
-        status = U_ZERO_ERROR;
-        
-        // Try to open the ICU data file directly
-        UDataMemory* data = udata_open(nullptr, "dat", "icudt77l", &status);
-        if (U_SUCCESS(status)) {
-            std::cout << "   ✅ ICU data file accessible" << std::endl;
-            udata_close(data);
-        } else {
-            // Try alternative approach - check if we can get locale display names
-            // which also requires resource data
+        if (!skippedByProfile("resources")) {
             status = U_ZERO_ERROR;
-            icu::Locale locale("en_US");
-            icu::UnicodeString displayName;
-            locale.getDisplayName(displayName);
-            
-            if (displayName.length() > 0) {
-                std::cout << "   ✅ Resource data accessible (via locale display names)" << std::endl;
+        
+            // Try to open the ICU data file directly
+            UDataMemory* data = udata_open(nullptr, "dat", "icudt77l", &status);
+            if (U_SUCCESS(status)) {
+                std::cout << "   ✅ ICU data file accessible" << std::endl;
+                udata_close(data);
             } else {
-                std::cout << "   ❌ Failed to access resource data: " << u_errorName(status) << std::endl;
-                allTestsPassed = false;
+                // Try alternative approach - check if we can get locale display names
+                // which also requires resource data
+                status = U_ZERO_ERROR;
+                icu::Locale locale("en_US");
+                icu::UnicodeString displayName;
+                locale.getDisplayName(displayName);
+            
+                if (displayName.length() > 0) {
+                    std::cout << "   ✅ Resource data accessible (via locale display names)" << std::endl;
+                } else {
+                    std::cout << "   ❌ Failed to access resource data: " << u_errorName(status) << std::endl;
+                    allTestsPassed = false;
+                }
             }
         }
         
         // Test 5: Check if we can access converter data (requires cnv files)
         std::cout << "5. Testing converter data..." << std::endl;
-        // Note: This test may have limited functionality in WebAssembly environments
-        status = U_ZERO_ERROR;
-        UConverter* conv = ucnv_open("Shift-JIS", &status);
-        if (U_SUCCESS(status)) {
-            std::cout << "   ✅ Converter data accessible" << std::endl;
-            ucnv_close(conv);
-        } else {
-            std::cout << "   ❌ Failed to open converter: " << u_errorName(status) << std::endl;
-            allTestsPassed = false;
+#if UCONFIG_NO_LEGACY_CONVERSION
+        skippedByBuild("legacy conversion");
+#else
+        if (!skippedByProfile("converters")) {
+            // Note: This test may have limited functionality in WebAssembly environments
+            status = U_ZERO_ERROR;
+            UConverter* conv = ucnv_open("Shift-JIS", &status);
+            if (U_SUCCESS(status)) {
+                std::cout << "   ✅ Converter data accessible" << std::endl;
+                ucnv_close(conv);
+            } else {
+                std::cout << "   ❌ Failed to open converter: " << u_errorName(status) << std::endl;
+                allTestsPassed = false;
+            }
+        }
+#endif
+        
+        // Test 6: Check if we can access normalization data (requires nfkc.nrm, nfkc_cf.nrm)
+        std::cout << "6. Testing normalization data..." << std::endl;
+        if (!skippedByProfile("normalization")) {
+            status = U_ZERO_ERROR;
+            const icu::Normalizer2* nfkcCasefold = icu::Normalizer2::getNFKCCasefoldInstance(status);
+            if (U_SUCCESS(status)) {
+                // U+FB01 LATIN SMALL LIGATURE FI folds to "fi"
+                icu::UnicodeString folded = nfkcCasefold->normalize(icu::UnicodeString((UChar32)0xFB01), status);
+                if (U_SUCCESS(status) && folded == icu::UnicodeString("fi")) {
+                    std::cout << "   ✅ Normalization data accessible (NFKC_Casefold)" << std::endl;
+                } else {
+                    std::cout << "   ❌ NFKC_Casefold produced an unexpected result" << std::endl;
+                    allTestsPassed = false;
+                }
+            } else {
+                std::cout << "   ❌ Failed to load NFKC_Casefold data: " << u_errorName(status) << std::endl;
+                allTestsPassed = false;
+            }
+        }
+        
+        // Test 7: Check if we can access break iteration data (requires brkitr rules)
+        std::cout << "7. Testing break iteration data..." << std::endl;
+        if (!skippedByProfile("break-iteration")) {
+            const std::vector<std::pair<const char*, icu::BreakIterator* (*)(const icu::Locale&, UErrorCode&)>> kinds = {
+                {"word",      &icu::BreakIterator::createWordInstance},
+                {"sentence",  &icu::BreakIterator::createSentenceInstance},
+                {"line",      &icu::BreakIterator::createLineInstance},
+            };
+            for (const auto& [kind, create] : kinds) {
+                status = U_ZERO_ERROR;
+                std::unique_ptr<icu::BreakIterator> iterator(create(icu::Locale::getEnglish(), status));
+                if (U_SUCCESS(status)) {
+                    std::cout << "   ✅ " << kind << " break iterator available" << std::endl;
+                } else {
+                    std::cout << "   ❌ Failed to create " << kind << " break iterator: " << u_errorName(status) << std::endl;
+                    allTestsPassed = false;
+                }
+            }
+        }
+        
+        // Test 8: Check that the western European locales are present (collation and display names)
+        std::cout << "8. Testing western locale data..." << std::endl;
+        if (!skippedByProfile("western-locales")) {
+            for (const char* language : {"en", "fr", "de", "es", "it", "pt", "nl"}) {
+                icu::Locale locale(language);
+                icu::UnicodeString displayName;
+                locale.getDisplayLanguage(locale, displayName);
+                
+                status = U_ZERO_ERROR;
+                std::unique_ptr<icu::Collator> collator(icu::Collator::createInstance(locale, status));
+                
+                // Without the locale data the display name falls back to the language code
+                if (U_SUCCESS(status) && displayName.length() > 0 && displayName != icu::UnicodeString(language)) {
+                    std::cout << "   ✅ " << language << ": " << toString(displayName) << std::endl;
+                } else {
+                    std::cout << "   ❌ Locale data missing for " << language << ": " << u_errorName(status) << std::endl;
+                    allTestsPassed = false;
+                }
+            }
         }
         
         // Summary
@@ -581,13 +830,639 @@ public:
         } else {
             std::cout << "❌ Some ICU data tests failed. The data bundle may not be properly included or accessible." << std::endl;
         }
+        return allTestsPassed;
+    }
+
+    // Example 6: ICU Package Addons
+    // One check per icuaddons component, each against the plain ICU API it
+    // stands in for. A check is skipped if the data profile does not promise
+    // the data its service needs. Returns false if any check failed.
+    bool testAddons() {
+        std::cout << "\n=== ICU Package Addons ===" << std::endl;
+        
+        bool allTestsPassed = true;
+        int number = 0;
+        auto run = [&](const char* name, bool (ICUPackageTester::*check)()) {
+            std::cout << ++number << ". Testing " << name << "..." << std::endl;
+            allTestsPassed = (this->*check)() && allTestsPassed;
+        };
+        run("packed sort keys (icuaddons/sortkeys.h)",               &ICUPackageTester::testPackedSortKeys);
+        run("collation-aware search (icuaddons/search.h)",          &ICUPackageTester::testCollationSearch);
+        run("skeleton formats (icuaddons/formatting.h)",            &ICUPackageTester::testSkeletonFormats);
+        run("streaming conversion (icuaddons/utf8stream.h)",       &ICUPackageTester::testStreamingConversion);
+        run("bulk transcoding (icuaddons/transcode.h)",             &ICUPackageTester::testBulkTranscoding);
+        run("batched normalization (icuaddons/normalize.h)",        &ICUPackageTester::testBatchedNormalization);
+        run("UTF-8 segments (icuaddons/utf8stream.h)",              &ICUPackageTester::testUTF8Segments);
+        run("parallel segmentation (icuaddons/segmenter.h)",        &ICUPackageTester::testParallelSegmentation);
+        run("pooled break iterators (icuaddons/servicepool.h)",     &ICUPackageTester::testPooledBreakIterator);
+        run("warm-up (icuaddons/warmup.h)",                         &ICUPackageTester::testWarmUp);
+        run("lazy data loading (icuaddons/lazydata.h)",             &ICUPackageTester::testLazyData);
+        
+        std::cout << "\nICU Package Addons Summary:" << std::endl;
+        if (allTestsPassed) {
+            std::cout << "✅ All addon tests passed!" << std::endl;
+        } else {
+            std::cout << "❌ Some addon tests failed." << std::endl;
+        }
+        return allTestsPassed;
+    }
+
+    // Packed sort keys must order like Collator::compare()
+    bool testPackedSortKeys() {
+        if (addonSkippedByProfile("collation")) {
+            return true;
+        }
+        UErrorCode status = U_ZERO_ERROR;
+        std::unique_ptr<icu::Collator> coll(icu::Collator::createInstance(icu::Locale::getUS(), status));
+        const std::vector<std::string> words = {"peach", "Péché", "apple", "pêche", "banana", "Apple", "péché"};
+        std::string text;
+        std::vector<uint32_t> offsets = {0};
+        for (const auto& word : words) {
+            text += word;
+            offsets.push_back(static_cast<uint32_t>(text.size()));
+        }
+        icuaddons::PackedSortKeys keys;
+        std::vector<uint32_t> order;
+        if (U_SUCCESS(status)) {
+            icuaddons::buildSortKeysUTF8(*coll, text.data(), offsets.data(), words.size(), keys, status);
+            icuaddons::sortedOrder(keys, order);
+        }
+        bool ordered = U_SUCCESS(status) && order.size() == words.size();
+        for (size_t i = 1; ordered && i < order.size(); ++i) {
+            ordered = coll->compareUTF8(words[order[i - 1]], words[order[i]], status) != UCOL_GREATER;
+        }
+        if (!ordered) {
+            std::cout << "   ❌ Packed sort keys are out of collation order: " << u_errorName(status) << std::endl;
+            return false;
+        }
+        std::cout << "   ✅ Packed sort keys sort like Collator::compare" << std::endl;
+        return true;
+    }
+
+    // Collated patterns ignore accents and case at primary strength; match
+    // offsets stay exact after ill-formed UTF-8 (each bad sequence is one U+FFFD)
+    bool testCollationSearch() {
+        if (addonSkippedByProfile("collation")) {
+            return true;
+        }
+        UErrorCode status = U_ZERO_ERROR;
+        const std::string sentence = "\xff\xfe Tous les êtres humains naissent libres. \xe2\x82 Être libre.";
+        icuaddons::SearchPatterns patterns;
+        patterns.addCollated(u"etre", icu::Locale::getFrance(), UCOL_PRIMARY, status);
+#if !UCONFIG_NO_REGULAR_EXPRESSIONS
+        patterns.addRegex(u"libres?", 0, status);
+#endif
+        std::vector<std::string> found;
+        icuaddons::Searcher searcher(patterns, status);
+        bool inBounds = true;
+        searcher.scan(sentence.data(), sentence.size(), [&](size_t, size_t begin, size_t end) {
+            inBounds = inBounds && begin <= end && end <= sentence.size();
+            found.push_back(inBounds ? sentence.substr(begin, end - begin) : std::string());
+        }, status);
+        std::vector<std::string> expected = {"être", "Être"};
+#if !UCONFIG_NO_REGULAR_EXPRESSIONS
+        expected.insert(expected.end(), {"libres", "libre"});
+#endif
+        if (U_FAILURE(status) || !inBounds || found != expected) {
+            std::cout << "   ❌ Collation-aware search found " << found.size() << " matches: " << u_errorName(status)
+                      << std::endl;
+            return false;
+        }
+        std::cout << "   ✅ Collation-aware search finds accented matches" << std::endl;
+        return true;
+    }
+
+    // Precompiled skeleton formats write UTF-8 into a caller buffer
+    bool testSkeletonFormats() {
+#if UCONFIG_NO_FORMATTING
+        std::cout << "   ⏭️ Skipped: formatting is compiled out of this ICU build" << std::endl;
+        return true;
+#else
+        if (addonSkippedByProfile("calendars")) {
+            return true;
+        }
+        UErrorCode status = U_ZERO_ERROR;
+        icuaddons::FormatterCache formats;
+        icuaddons::CompiledNumberFormat* dollars = formats.number(icu::Locale::getUS(), u"currency/USD", status);
+        icuaddons::CompiledDateFormat* day = formats.date(icu::Locale::getUS(), u"yMMMd", status, u"UTC");
+        char number[64] = {}, date[64] = {};
+        if (U_SUCCESS(status)) {
+            dollars->format(1234567.89, number, sizeof(number), status);
+            day->format(0.0, date, sizeof(date), status);
+        }
+        if (U_FAILURE(status) || std::string(number) != "$1,234,567.89" || std::string(date) != "Jan 1, 1970") {
+            std::cout << "   ❌ Skeleton formats produced \"" << number << "\", \"" << date << "\": " << u_errorName(status) << std::endl;
+            return false;
+        }
+        std::cout << "   ✅ Skeleton formats: " << number << ", " << date << std::endl;
+        return true;
+#endif
+    }
+
+    // A StreamTranscoder fed in 3-byte pieces must match one ucnv_convert() call
+    bool testStreamingConversion() {
+#if UCONFIG_NO_LEGACY_CONVERSION
+        std::cout << "   ⏭️ Skipped: legacy conversion is compiled out of this ICU build" << std::endl;
+        return true;
+#else
+        if (addonSkippedByProfile("converters")) {
+            return true;
+        }
+        UErrorCode status = U_ZERO_ERROR;
+        const std::string utf8 = "東京タワー, Ωμέγα and plain ASCII";
+        char whole[128];
+        int32_t wholeLength = ucnv_convert("Shift-JIS", "UTF-8", whole, sizeof(whole), utf8.data(), utf8.size(), &status);
+        std::string streamed;
+        icuaddons::StreamTranscoder transcoder("UTF-8", "Shift-JIS", status);
+        for (size_t i = 0; i < utf8.size() && U_SUCCESS(status); i += 3) {
+            size_t piece = std::min<size_t>(3, utf8.size() - i);
+            transcoder.convert(utf8.data() + i, piece, i + piece == utf8.size(),
+                               [&](const char* bytes, size_t length) { streamed.append(bytes, length); }, status);
+        }
+        if (U_FAILURE(status) || streamed != std::string(whole, wholeLength)) {
+            std::cout << "   ❌ Streaming conversion differs from ucnv_convert: " << u_errorName(status) << std::endl;
+            return false;
+        }
+        std::cout << "   ✅ Streaming conversion matches ucnv_convert" << std::endl;
+        return true;
+#endif
+    }
+
+    // A Transcoder copies the ASCII runs and converts the rest, by record and
+    // in 5-byte pieces; 0x1A is one of the controls ICU's Shift-JIS maps to
+    // another code point
+    bool testBulkTranscoding() {
+#if UCONFIG_NO_LEGACY_CONVERSION
+        std::cout << "   ⏭️ Skipped: legacy conversion is compiled out of this ICU build" << std::endl;
+        return true;
+#else
+        if (addonSkippedByProfile("converters")) {
+            return true;
+        }
+        UErrorCode status = U_ZERO_ERROR;
+        const std::string text = "東京タワー, Ωμέγα and plain ASCII";
+        char sjis[128];
+        int32_t sjisLength = ucnv_convert("Shift-JIS", "UTF-8", sjis, sizeof(sjis), text.data(), text.size(), &status);
+        const std::string feed = std::string("{\"id\":17,\"source\":\"feed-sjis\",\"text\":\"") + std::string(sjis, sjisLength) +
+                                 "\x1a\"}";
+        char expected[256];
+        int32_t expectedLength = ucnv_convert("UTF-8", "Shift-JIS", expected, sizeof(expected), feed.data(), feed.size(), &status);
+        icuaddons::ServicePool pool;
+        icuaddons::Transcoder bulk("Shift-JIS", "UTF-8", status, &pool);
+        std::string record, chunked;
+        bulk.transcode(feed.data(), feed.size(), record, status);
+        for (size_t i = 0; i < feed.size() && U_SUCCESS(status); i += 5) {
+            size_t piece = std::min<size_t>(5, feed.size() - i);
+            bulk.transcodeChunk(feed.data() + i, piece, i + piece == feed.size(), chunked, status);
+        }
+        if (U_FAILURE(status) || !bulk.asciiTransparent() || bulk.counters().asciiBytes == 0 ||
+            record != std::string(expected, expectedLength) || chunked != record) {
+            std::cout << "   ❌ Bulk transcoding differs from ucnv_convert: " << u_errorName(status) << std::endl;
+            return false;
+        }
+        std::cout << "   ✅ Bulk transcoding matches ucnv_convert (" << bulk.counters().asciiBytes
+                  << " bytes copied as ASCII)" << std::endl;
+        return true;
+#endif
+    }
+
+    // Batched NFC copies only the records it changes: "café" is composed
+    bool testBatchedNormalization() {
+        if (addonSkippedByProfile("normalization")) {
+            return true;
+        }
+        UErrorCode status = U_ZERO_ERROR;
+        const icu::Normalizer2* nfc = icu::Normalizer2::getNFCInstance(status);
+        const std::string batch = "plain text" "caf\xC3\xA9" "cafe\xCC\x81";
+        const std::vector<uint32_t> offsets = {0, 10, 15, 21};
+        icuaddons::NormalizedRecords normalized;
+        if (U_SUCCESS(status)) {
+            icuaddons::normalizeBatchUTF8(*nfc, batch.data(), offsets.data(), offsets.size() - 1, normalized, status);
+        }
+        if (U_FAILURE(status) || normalized.size() != 3 || normalized.zeroCopy != 2
+            || normalized.record(1) != normalized.record(2) || normalized.record(0).data() != batch.data()) {
+            std::cout << "   ❌ Batched NFC produced an unexpected result: " << u_errorName(status) << std::endl;
+            return false;
+        }
+        std::cout << "   ✅ Batched NFC copied 1 of 3 records" << std::endl;
+        return true;
+    }
+
+    // The word boundaries of kSegmentationSample found by a plain UTF-16 iterator
+    std::vector<int32_t> wordBoundariesUTF16(UErrorCode& status) {
+        std::vector<int32_t> boundaries;
+        std::unique_ptr<icu::BreakIterator> words(icu::BreakIterator::createWordInstance(icu::Locale::getEnglish(), status));
+        if (U_FAILURE(status)) {
+            return boundaries;
+        }
+        const icu::UnicodeString text = icu::UnicodeString::fromUTF8(kSegmentationSample);
+        words->setText(text);
+        for (int32_t limit = words->first(); limit != icu::BreakIterator::DONE; limit = words->next()) {
+            boundaries.push_back(limit);
+        }
+        return boundaries;
+    }
+
+    // Word segments over UTF-8 through UText must match the UTF-16 ones
+    bool testUTF8Segments() {
+        if (addonSkippedByProfile("break-iteration")) {
+            return true;
+        }
+        const std::string utf8 = kSegmentationSample;
+        UErrorCode status = U_ZERO_ERROR;
+        std::unique_ptr<icu::BreakIterator> words(icu::BreakIterator::createWordInstance(icu::Locale::getEnglish(), status));
+        std::vector<std::string> viaUText, viaUnicodeString;
+        if (U_SUCCESS(status)) {
+            icuaddons::UTF8Segments segments(*words, utf8.data(), utf8.size(), status);
+            size_t begin = 0, end = 0;
+            while (segments.next(begin, end)) {
+                viaUText.push_back(utf8.substr(begin, end - begin));
+            }
+        }
+        const std::vector<int32_t> boundaries = wordBoundariesUTF16(status);
+        const icu::UnicodeString text = icu::UnicodeString::fromUTF8(utf8);
+        for (size_t i = 1; i < boundaries.size(); ++i) {
+            std::string segment;
+            text.tempSubString(boundaries[i - 1], boundaries[i] - boundaries[i - 1]).toUTF8String(segment);
+            viaUnicodeString.push_back(segment);
+        }
+        if (U_FAILURE(status) || viaUText.empty() || viaUText != viaUnicodeString) {
+            std::cout << "   ❌ UTF-8 word segments differ from the UTF-16 ones: " << u_errorName(status) << std::endl;
+            return false;
+        }
+        std::cout << "   ✅ UTF-8 word segments match the UTF-16 ones (" << viaUText.size() << " segments)" << std::endl;
+        return true;
+    }
+
+    // Shards cut after newlines and segmented on 3 threads give the same
+    // boundaries as one iterator over the whole text
+    bool testParallelSegmentation() {
+        if (addonSkippedByProfile("break-iteration")) {
+            return true;
+        }
+        const std::string utf8 = kSegmentationSample;
+        std::string lines;
+        for (int line = 0; line < 8; ++line) {
+            lines += utf8 + "\n";
+        }
+        UErrorCode status = U_ZERO_ERROR;
+        std::unique_ptr<icu::BreakIterator> words(icu::BreakIterator::createWordInstance(icu::Locale::getEnglish(), status));
+        std::vector<uint64_t> expectedEnds;
+        if (U_SUCCESS(status)) {
+            icuaddons::UTF8Segments whole(*words, lines.data(), lines.size(), status);
+            size_t begin = 0, end = 0;
+            while (whole.next(begin, end)) {
+                expectedEnds.push_back(end);
+            }
+        }
+        icuaddons::Segmenter segmenter(icuaddons::BreakType::Word, icu::Locale::getEnglish(), status);
+        icuaddons::SegmenterOptions options;
+        options.threads    = 3;
+        options.shardBytes = utf8.size() + 1;
+        icuaddons::Segmentation segmentation;
+        segmenter.segment(lines.data(), lines.size(), options, segmentation, status);
+        bool sameEnds = U_SUCCESS(status) && segmentation.size() == expectedEnds.size();
+        for (size_t i = 0; sameEnds && i < segmentation.size(); ++i) {
+            sameEnds = segmentation.end(i) == expectedEnds[i];
+        }
+        if (!sameEnds || segmentation.shardOffsets.size() != 8) {
+            std::cout << "   ❌ Parallel segmentation differs from one iterator: " << u_errorName(status) << ", "
+                      << segmentation.size() << " segments, expected " << expectedEnds.size() << std::endl;
+            return false;
+        }
+        std::cout << "   ✅ Parallel segmentation of 8 shards matches one iterator (" << segmentation.size()
+                  << " segments)" << std::endl;
+        return true;
+    }
+
+    // A pooled iterator is reused and finds the same boundaries as a new one
+    bool testPooledBreakIterator() {
+        if (addonSkippedByProfile("break-iteration")) {
+            return true;
+        }
+        UErrorCode status = U_ZERO_ERROR;
+        const std::vector<int32_t> expected = wordBoundariesUTF16(status);
+        icuaddons::ServicePool pool;
+        std::vector<int32_t> pooledBoundaries[2];
+        for (auto& boundaries : pooledBoundaries) {
+            auto pooled = pool.breakIterator(icuaddons::BreakType::Word, icu::Locale::getEnglish(), status);
+            if (U_FAILURE(status)) {
+                break;
+            }
+            const icu::UnicodeString text = icu::UnicodeString::fromUTF8(kSegmentationSample);
+            pooled->setText(text);
+            for (int32_t limit = pooled->first(); limit != icu::BreakIterator::DONE; limit = pooled->next()) {
+                boundaries.push_back(limit);
+            }
+        }
+        const icuaddons::ServicePoolCounters counters = pool.counters();
+        if (U_FAILURE(status) || pooledBoundaries[0] != expected || pooledBoundaries[1] != expected ||
+            counters.hits != 1 || counters.creations != 1) {
+            std::cout << "   ❌ Pooled word break iterator: " << u_errorName(status) << ", " << counters.hits
+                      << " hits, " << counters.misses << " misses" << std::endl;
+            return false;
+        }
+        std::cout << "   ✅ Pooled word break iterator reused (" << counters.hits << " hit, "
+                  << counters.misses << " miss)" << std::endl;
+        return true;
+    }
+
+    // Warming up creates the pool's prototypes before the first request; the
+    // measured second openings and the lease after it are hits
+    bool testWarmUp() {
+        if (addonSkippedByProfile("break-iteration")) {
+            return true;
+        }
+        UErrorCode status = U_ZERO_ERROR;
+        icuaddons::ServicePool pool;
+        icuaddons::WarmupManifest manifest;
+        icuaddons::parseWarmupManifest("# break iterators\nword-break en\nsentence-break en\n", manifest, status);
+        icuaddons::WarmupOptions options;
+        options.dataPages = icuaddons::DataPages::Prefault;
+        options.measure   = true;
+        options.pool      = &pool;
+        icuaddons::WarmupReport report;
+        icuaddons::warmUp(manifest, options, report, status);
+        {
+            auto warmed = pool.breakIterator(icuaddons::BreakType::Word, icu::Locale::getEnglish(), status);
+        }
+        UErrorCode parseStatus = U_ZERO_ERROR;
+        size_t errorLine = 0;
+        icuaddons::WarmupManifest invalid;
+        icuaddons::parseWarmupManifest("collator en\nspellchecker en\n", invalid, parseStatus, &errorLine);
+        const icuaddons::ServicePoolCounters counters = pool.counters();
+        if (U_FAILURE(status) || report.services.size() != 2 || counters.creations != 2 ||
+            counters.hits != 3 || parseStatus != U_PARSE_ERROR || errorLine != 2) {
+            std::cout << "   ❌ Warm-up: " << u_errorName(status) << ", " << report.services.size() << " services, "
+                      << counters.creations << " creations, " << counters.hits << " hits" << std::endl;
+            return false;
+        }
+        std::cout << "   ✅ Warm-up created the break iterators (word: " << report.services[0].coldNs / 1000
+                  << " µs cold, " << report.services[0].warmNs / 1000 << " µs warm; "
+                  << report.dataBytes / 1024 << " kB of data prefaulted)" << std::endl;
+        return true;
+    }
+
+    // The split data of the lazy data check: ICU_SPLIT_DATA_DIR, or split/
+    // in the data directory (build.sh --variant=data-split)
+    std::string splitDataDirectory() {
+        const char* envSplitDir = std::getenv("ICU_SPLIT_DATA_DIR");
+        if (envSplitDir != nullptr && strlen(envSplitDir) > 0) {
+            return envSplitDir;
+        }
+        const std::string dataDir = icu_data_dir.empty() ? std::string(u_getDataDirectory()) : icu_data_dir;
+        return dataDir.empty() ? std::string() : buildPath({dataDir, "split"});
+    }
+
+    // LazyData has to be installed before ICU opens any data, so the check
+    // runs in a fresh process: this executable with --lazy-data-check
+    bool testLazyData() {
+        const std::string splitDir = splitDataDirectory();
+        if (splitDir.empty()) {
+            std::cout << "   ⏭️ Skipped: no data directory to find split data in (ICU_SPLIT_DATA_DIR)" << std::endl;
+            return true;
+        }
+        if (!checkFile(buildPath({splitDir, "index.txt"})).first) {
+            std::cout << "   ⏭️ Skipped: no split data in " << splitDir << " (build.sh --variant=data-split)" << std::endl;
+            return true;
+        }
+#if defined(__EMSCRIPTEN__)
+        std::cout << "   ⏭️ Skipped: child processes are not supported on this platform" << std::endl;
+        return true;
+#else
+        std::cout.flush();
+        const std::string command = "\"" + executable_path + "\" --lazy-data-check \"" + splitDir + "\"";
+        const int exitCode = std::system(command.c_str());
+        if (exitCode != 0) {
+            std::cout << "   ❌ The lazy data check failed (" << command << " returned " << exitCode << ")" << std::endl;
+            return false;
+        }
+        return true;
+#endif
+    }
+
+    // Child process of testLazyData(): load what each service needs from
+    // `splitDir` into a fresh directory, then open the services. With the
+    // stub data of the archive packages ICU only has the loaded items; where
+    // the data is linked in, ICU reads files first so that it uses them too.
+    static int runLazyDataCheck(const std::string& splitDir) {
+        const std::filesystem::path cache =
+            std::filesystem::temp_directory_path() / ("icu-lazy-data-" + std::to_string(std::random_device()()));
+        bool allTestsPassed = true;
+        auto report = [&](bool passed, const std::string& check, UErrorCode status) {
+            if (passed) {
+                std::cout << "   ✅ " << check << std::endl;
+            } else {
+                std::cout << "   ❌ " << check << ": " << u_errorName(status) << std::endl;
+                allTestsPassed = false;
+            }
+        };
+        {
+            icuaddons::LazyData data(icuaddons::directoryLoader(splitDir), cache.string());
+            UErrorCode status = U_ZERO_ERROR;
+            data.install(status);
+            udata_setFileAccess(UDATA_FILES_FIRST, &status);
+            if (U_FAILURE(status)) {
+                report(false, "LazyData::install", status);
+                return 1;
+            }
+
+            // zh_TW reaches its collation through likely subtags and aliases (zh_Hant_TW, zh_Hant)
+            status = U_ZERO_ERROR;
+            data.require(icuaddons::DataFeature::Collation, "zh_TW", status);
+            std::unique_ptr<icu::Collator> collator(icu::Collator::createInstance(icu::Locale("zh_TW"), status));
+            std::string valid = "none";
+            if (U_SUCCESS(status)) {
+                valid = collator->getLocale(ULOC_VALID_LOCALE, status).getName();
+            }
+            report(U_SUCCESS(status) && valid.compare(0, 2, "zh") == 0,
+                   "Collator for zh_TW from the loaded items (valid locale " + valid + ")", status);
+
+            // Thai words are only found with the dictionary (brkitr/thaidict.dict)
+            auto countWords = [](const char* locale, const char* text, UErrorCode& status) {
+                std::unique_ptr<icu::BreakIterator> words(icu::BreakIterator::createWordInstance(icu::Locale(locale), status));
+                int32_t count = 0;
+                if (U_SUCCESS(status)) {
+                    const icu::UnicodeString unicode = icu::UnicodeString::fromUTF8(text);
+                    words->setText(unicode);
+                    for (words->first(); words->next() != icu::BreakIterator::DONE;) {
+                        ++count;
+                    }
+                }
+                return count;
+            };
+            status = U_ZERO_ERROR;
+            data.require(icuaddons::DataFeature::BreakIteration, "th", status);
+            const int32_t thai = countWords("th", "สวัสดีครับขอบคุณมาก", status);
+            report(U_SUCCESS(status) && thai > 1, "Thai word break iterator with its dictionary (" + std::to_string(thai) + " words)", status);
+
+            // The CJK dictionary engine also needs the NFKC data (nfkc.nrm)
+            status = U_ZERO_ERROR;
+            data.require(icuaddons::DataFeature::BreakIteration, "ja", status);
+            const int32_t japanese = countWords("ja", "東京タワーに行きました", status);
+            report(U_SUCCESS(status) && japanese > 1, "Japanese word break iterator with the CJK dictionary (" + std::to_string(japanese) + " words)", status);
+
+            status = U_ZERO_ERROR;
+            data.requireConverter("Shift-JIS", status);
+            UConverter* converter = ucnv_open("Shift-JIS", &status);
+            char sjis[16] = {};
+            const int32_t sjisLength = U_SUCCESS(status) ? ucnv_fromUChars(converter, sjis, sizeof(sjis), u"東京", 2, &status) : 0;
+            ucnv_close(converter);
+            report(U_SUCCESS(status) && std::string(sjis, sjisLength) == "\x93\x8c\x8b\x9e",
+                   "Shift-JIS converter from the loaded tables", status);
+
+            std::cout << "   Loaded " << data.itemsLoaded() << " of " << data.itemsAvailable() << " items ("
+                      << data.bytesLoaded() / 1024 << " of " << data.bytesAvailable() / 1024 << " kB)" << std::endl;
+        }
+        u_cleanup();  // Unmap the items before removing them
+        std::error_code error;
+        std::filesystem::remove_all(cache, error);
+        return allTestsPassed ? 0 : 1;
+    }
+
+    // Use shared ICU objects and the ICU caches from several threads at once and
+    // compare every result with the single-threaded one
+    bool runThreadStressTest(size_t threads, size_t iterations) {
+        std::cout << "\n=== Thread-Safety Stress (" << threads << " threads, " << iterations << " rounds) ===" << std::endl;
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+        std::cout << "   ⚠️ Skipped: this build has no thread support" << std::endl;
+        return true;
+#else
+        const std::vector<icu::UnicodeString> words = {
+            u"apple", u"Äpfel", u"zebra", u"été", u"Ärger", u"résumé", u"resume", u"Straße",
+            u"strasse", u"Ωμέγα", u"москва", u"東京", u"서울", u"naïve", u"naive", u"Zürich",
+        };
+        const icu::UnicodeString text(u"The quick brown fox can't jump 32.3 feet, right? Das ist schön. 東京は大きい。");
+        const std::vector<icu::Locale> locales = {
+            icu::Locale("en"), icu::Locale("de"), icu::Locale("fr"), icu::Locale("ja"), icu::Locale("ru"),
+        };
+        
+        // Shared objects and the single-threaded reference results
+        UErrorCode status = U_ZERO_ERROR;
+        std::unique_ptr<icu::Collator> collator(icu::Collator::createInstance(icu::Locale::getGermany(), status));
+        std::unique_ptr<icu::BreakIterator> wordIterator(icu::BreakIterator::createWordInstance(icu::Locale::getEnglish(), status));
+#if !UCONFIG_NO_FORMATTING
+        const icu::number::LocalizedNumberFormatter formatter =
+            icu::number::NumberFormatter::withLocale(icu::Locale::getFrance()).precision(icu::number::Precision::fixedFraction(2));
+#endif
+        if (U_FAILURE(status)) {
+            std::cout << "   ⚠️ Skipped: shared objects unavailable (" << u_errorName(status) << ")" << std::endl;
+            return true;
+        }
+        
+        auto compareAll = [&](icu::Collator& coll) {
+            std::vector<int> orders;
+            for (size_t i = 0; i < words.size(); ++i) {
+                UErrorCode error = U_ZERO_ERROR;
+                orders.push_back(coll.compare(words[i], words[(i + 1) % words.size()], error));
+            }
+            return orders;
+        };
+        auto boundaries = [&](icu::BreakIterator& iterator) {
+            std::vector<int32_t> positions;
+            iterator.setText(text);
+            for (int32_t p = iterator.first(); p != icu::BreakIterator::DONE; p = iterator.next()) {
+                positions.push_back(p);
+            }
+            return positions;
+        };
+        auto formatAll = [&] {
+            icu::UnicodeString joined;
+#if !UCONFIG_NO_FORMATTING
+            for (int i = 0; i < 16; ++i) {
+                UErrorCode error = U_ZERO_ERROR;
+                joined += formatter.formatDouble(i * 12345.678, error).toString(error);
+                joined += u'|';
+            }
+#endif
+            return joined;
+        };
+        auto encode = [&](const icu::UnicodeString& source) {
+            UErrorCode error = U_ZERO_ERROR;
+            UConverter* converter = ucnv_open(UCONFIG_NO_LEGACY_CONVERSION ? "UTF-8" : "Shift-JIS", &error);
+            char buffer[256];
+            int32_t length = ucnv_fromUChars(converter, buffer, sizeof(buffer), source.getBuffer(), source.length(), &error);
+            ucnv_close(converter);
+            return U_SUCCESS(error) ? std::string(buffer, length) : std::string(u_errorName(error));
+        };
+        
+        const std::vector<int>     expectedOrders     = compareAll(*collator);
+        const std::vector<int32_t> expectedBoundaries = boundaries(*std::unique_ptr<icu::BreakIterator>(wordIterator->clone()));
+        const icu::UnicodeString   expectedFormatted  = formatAll();
+        const std::string          expectedEncoded    = encode(text);
+        
+        std::atomic<size_t> mismatches{0};
+        std::atomic<bool>   go{false};
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                while (!go.load()) {
+                    std::this_thread::yield();
+                }
+                for (size_t round = 0; round < iterations; ++round) {
+                    size_t failures = 0;
+                    failures += compareAll(*collator) != expectedOrders;
+                    std::unique_ptr<icu::BreakIterator> iterator(wordIterator->clone());
+                    failures += boundaries(*iterator) != expectedBoundaries;
+                    failures += formatAll() != expectedFormatted;
+                    failures += encode(text) != expectedEncoded;
+                    
+                    // Churn the service caches with locales the other threads also ask for
+                    UErrorCode error = U_ZERO_ERROR;
+                    const icu::Locale& locale = locales[(t + round) % locales.size()];
+                    std::unique_ptr<icu::Collator> created(icu::Collator::createInstance(locale, error));
+#if !UCONFIG_NO_FORMATTING
+                    std::unique_ptr<icu::NumberFormat> number(icu::NumberFormat::createInstance(locale, error));
+#endif
+                    failures += U_FAILURE(error);
+                    if (failures > 0) {
+                        mismatches.fetch_add(failures);
+                    }
+                }
+            });
+        }
+        go.store(true);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        
+        if (mismatches.load() > 0) {
+            std::cout << "   ❌ " << mismatches.load() << " results differ from the single-threaded reference" << std::endl;
+            return false;
+        }
+        std::cout << "   ✅ " << threads * iterations << " rounds matched the single-threaded reference" << std::endl;
+        return true;
+#endif
     }
 
 };
 
 int main(int argc, char* argv[]) {
+    // Child process of the lazy data check: ICU has not loaded any data yet
+    if (argc > 2 && std::string(argv[1]) == "--lazy-data-check") {
+        return ICUPackageTester::runLazyDataCheck(argv[2]);
+    }
+    
     std::cout << "Testing ICU4C package..." << std::endl;
     
+    // Allocation hooks have to be in place before the first ICU call
+    icuaddons::AllocatorOptions allocatorOptions;
+    allocatorOptions.allocator        = icuaddons::Allocator::System;
+    allocatorOptions.countAllocations = ICUPackageTester::allocationCountingRequested();
+    const char* envAllocator = std::getenv("ICU_ALLOCATOR");
+    if (envAllocator != nullptr && strlen(envAllocator) > 0 && !icuaddons::parseAllocator(envAllocator, allocatorOptions.allocator)) {
+        std::cerr << "❌ Unknown ICU_ALLOCATOR: " << envAllocator << " (expected system or pool)" << std::endl;
+        return 1;
+    }
+    UErrorCode allocatorStatus = U_ZERO_ERROR;
+    icuaddons::installAllocator(allocatorOptions, allocatorStatus);
+    if (U_FAILURE(allocatorStatus)) {
+        std::cerr << "❌ Failed to install the ICU allocator: " << u_errorName(allocatorStatus) << std::endl;
+        return 1;
+    }
+    std::cout << "ICU allocator: " << icuaddons::allocatorName(allocatorOptions.allocator)
+              << (allocatorOptions.countAllocations ? " (counting allocations)" : "") << std::endl;
+    
     // Get ICU root path from environment variable or command line argument
     std::string icuRoot = "/app/icu";  // Default path for Linux Docker container
     std::string icuDataDir = "";  // Default is empty, will be set from environment or argument
@@ -613,8 +1488,19 @@ int main(int argc, char* argv[]) {
     }
     
     ICUPackageTester tester(icuRoot, icuDataDir);
+    tester.setExecutablePath(argv[0]);
     bool packageOk = tester.testPackage();
     
+    // ICU_TRACE=1 (verbose: also data file and resource bundle opens)
+    if (packageOk && ICUPackageTester::tracingRequested()) {
+        icuaddons::TraceOptions traceOptions;
+        if (std::string(std::getenv("ICU_TRACE")) == "verbose") {
+            traceOptions.level = UTRACE_VERBOSE;
+        }
+        UErrorCode traceStatus = U_ZERO_ERROR;
+        icuaddons::installTracing(traceOptions, traceStatus);
+    }
+    
     if (!packageOk) {
         std::cout << "\nSkipping ICU examples due to missing components." << std::endl;
         return 1;
@@ -633,7 +1519,31 @@ int main(int argc, char* argv[]) {
         tester.runLocaleExample();
         tester.runBreakIteratorExample();
         tester.runTransliterationExample();
-        tester.testICUDataBundle();
+        bool dataOk = tester.testICUDataBundle();
+        bool addonsOk = tester.testAddons();
+        tester.printAllocationReport();
+        ICUPackageTester::printTraceReport();
+        
+        const char* envStressThreads = std::getenv("ICU_STRESS_THREADS");
+        if (envStressThreads != nullptr && std::atoi(envStressThreads) > 0) {
+            const char* envStressIterations = std::getenv("ICU_STRESS_ITERATIONS");
+            int iterations = envStressIterations != nullptr ? std::atoi(envStressIterations) : 0;
+            if (!tester.runThreadStressTest(std::atoi(envStressThreads), iterations > 0 ? iterations : 200)) {
+                std::cerr << "\n❌ Shared ICU objects gave different results on several threads" << std::endl;
+                return 1;
+            }
+        }
+        
+        // Any failed check fails the run; checks for features a data profile
+        // does not promise were skipped, not failed
+        if (!dataOk) {
+            std::cerr << "\n❌ ICU data bundle verification failed" << std::endl;
+            return 1;
+        }
+        if (!addonsOk) {
+            std::cerr << "\n❌ ICU package addon tests failed" << std::endl;
+            return 1;
+        }
         
         std::cout << "\n✅ All ICU examples completed successfully!" << std::endl;
     } catch (const std::exception& e) {